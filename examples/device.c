@@ -39,7 +39,7 @@ int main(void) {
      * @{
      */
 
-    if (!vkc_allocator_create()) {
+    if (!vkc_allocator_create(NULL)) {
         return EXIT_FAILURE;
     }
 
@@ -84,7 +84,7 @@ int main(void) {
      * @{
      */
 
-    VkcInstance* instance = vkc_instance_create(layer_match, extension_match);
+    VkcInstance* instance = vkc_instance_create(NULL, layer_match, extension_match);
     if (!instance) {
         goto cleanup_instance_layer;
     }
@@ -101,11 +101,55 @@ int main(void) {
         goto cleanup_device_list;
     }
 
+    /**
+     * @name Logical Device
+     * @brief Created on its own allocation context.
+     *
+     * The device's driver allocations get a tracking table, caches and locks
+     * of their own instead of sharing the global context with the instance.
+     * With several devices, each one gets its own context.
+     * @{
+     */
+
+    VkcAllocatorContext* device_context = vkc_allocator_context_create(NULL);
+    if (!device_context) {
+        goto cleanup_physical_device;
+    }
+
+    VkcDeviceQueueRequest* queue_request = vkc_device_queue_request_create(
+        physical_device->object, VK_QUEUE_COMPUTE_BIT
+    );
+    if (!queue_request) {
+        goto cleanup_device_context;
+    }
+
+    VkcDevice* device = vkc_device_create(
+        device_context, physical_device, queue_request, NULL, NULL, NULL
+    );
+    if (!device) {
+        goto cleanup_queue_request;
+    }
+
+    VkcAllocatorStats device_stats;
+    if (vkc_allocator_context_stats(device_context, &device_stats)) {
+        LOG_INFO(
+            "[VkcDevice] Context holds %llu bytes after %llu allocations.",
+            (unsigned long long) device_stats.total.live_bytes,
+            (unsigned long long) device_stats.total.allocation_count
+        );
+    }
+
+    /** @} */
+
     /**
      * @name Clean up on Success
      * @{
      */
 
+    // Logical Device
+    vkc_device_destroy(device);
+    vkc_device_queue_request_free(queue_request);
+    vkc_allocator_context_free(device_context);
     // Device List
     vkc_device_physical_free(physical_device);
     vkc_device_list_free(device_list);
@@ -138,6 +182,12 @@ int main(void) {
      * @{
      */
 
+cleanup_queue_request:
+    vkc_device_queue_request_free(queue_request);
+cleanup_device_context:
+    vkc_allocator_context_free(device_context);
+cleanup_physical_device:
+    vkc_device_physical_free(physical_device);
 cleanup_device_list:
     vkc_device_list_free(device_list);
 cleanup_instance: 
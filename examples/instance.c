@@ -29,7 +29,7 @@ int main(void) {
      * @{
      */
 
-    if (!vkc_allocator_create()) {
+    if (!vkc_allocator_create(NULL)) {
         return EXIT_FAILURE;
     }
 
@@ -77,7 +77,7 @@ int main(void) {
      * @{
      */
 
-    VkcInstance* instance = vkc_instance_create(layer_match, extension_match);
+    VkcInstance* instance = vkc_instance_create(NULL, layer_match, extension_match);
     if (!instance) {
         goto cleanup_properties;
     }
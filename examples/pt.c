@@ -1,6 +1,230 @@
-// examples/cpu.c
+/**
+ * @file examples/pt.c
+ * @brief POSIX Threads stress benchmark for the Vulkan host allocator.
+ *
+ * Drives the VkC allocation callbacks from an increasing number of threads and
+ * reports allocations per second next to the raw PageAllocator, which every
+ * thread shares behind a single lock.
+ *
+ * Two patterns are measured:
+ *   - local:  each thread frees the blocks it allocated.
+ *   - remote: each thread frees the blocks allocated by its neighbour, which
+ *             exercises the lock-free return path of the thread caches.
+ */
+
+#include "core/posix.h"
+#include "core/logger.h"
+#include "allocator/page.h"
+#include "vk/allocator.h"
+
+#include <pthread.h>
+#include <stdbool.h>
+#include <stdint.h>
 #include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include <unistd.h>
+
+#define PT_BATCH 256
+#define PT_ROUNDS 2000
+#define PT_MAX_THREADS 64
+
+typedef enum PtBackend {
+    PT_BACKEND_PAGE,
+    PT_BACKEND_VKC,
+} PtBackend;
+
+typedef struct PtShared {
+    PtBackend backend;
+    bool remote;
+    uint32_t thread_count;
+    pthread_barrier_t barrier;
+    void* slots[PT_MAX_THREADS][PT_BATCH];
+} PtShared;
+
+typedef struct PtWorker {
+    PtShared* shared;
+    pthread_t thread;
+    uint32_t index;
+} PtWorker;
+
+static const VkSystemAllocationScope pt_scopes[] = {
+    VK_SYSTEM_ALLOCATION_SCOPE_COMMAND,
+    VK_SYSTEM_ALLOCATION_SCOPE_OBJECT,
+    VK_SYSTEM_ALLOCATION_SCOPE_DEVICE,
+    VK_SYSTEM_ALLOCATION_SCOPE_OBJECT,
+};
+
+static inline uint32_t pt_random(uint32_t* state) {
+    uint32_t x = *state;
+    x ^= x << 13;
+    x ^= x >> 17;
+    x ^= x << 5;
+    return *state = x;
+}
+
+static inline void* pt_malloc(PtBackend backend, size_t size, VkSystemAllocationScope scope) {
+    if (PT_BACKEND_PAGE == backend) {
+        return page_malloc(vkc_allocator_get(), size, 16);
+    }
+
+    const VkAllocationCallbacks* callbacks = vkc_allocator_callbacks();
+    return callbacks->pfnAllocation(callbacks->pUserData, size, 16, scope);
+}
+
+static inline void pt_free(PtBackend backend, void* pointer) {
+    if (PT_BACKEND_PAGE == backend) {
+        page_free(vkc_allocator_get(), pointer);
+        return;
+    }
+
+    const VkAllocationCallbacks* callbacks = vkc_allocator_callbacks();
+    callbacks->pfnFree(callbacks->pUserData, pointer);
+}
+
+static void* pt_worker(void* argument) {
+    PtWorker* worker = (PtWorker*) argument;
+    PtShared* shared = worker->shared;
+    uint32_t state = 0x9e3779b9u ^ (worker->index * 0x85ebca6bu);
+    uint32_t victim = shared->remote ? (worker->index + 1) % shared->thread_count : worker->index;
+
+    for (uint32_t round = 0; round < PT_ROUNDS; round++) {
+        void** slots = shared->slots[worker->index];
+        for (uint32_t i = 0; i < PT_BATCH; i++) {
+            size_t size = 16 + (pt_random(&state) % 1024);
+            VkSystemAllocationScope scope = pt_scopes[i % (sizeof(pt_scopes) / sizeof(*pt_scopes))];
+            slots[i] = pt_malloc(shared->backend, size, scope);
+        }
+
+        if (shared->remote) {
+            pthread_barrier_wait(&shared->barrier);
+        }
+
+        slots = shared->slots[victim];
+        for (uint32_t i = 0; i < PT_BATCH; i++) {
+            pt_free(shared->backend, slots[i]);
+        }
+
+        if (shared->remote) {
+            pthread_barrier_wait(&shared->barrier);
+        }
+    }
+
+    return NULL;
+}
+
+static double pt_now(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double) ts.tv_sec + (double) ts.tv_nsec * 1e-9;
+}
+
+static double pt_run(PtShared* shared, PtBackend backend, bool remote, uint32_t thread_count) {
+    PtWorker workers[PT_MAX_THREADS];
+
+    shared->backend = backend;
+    shared->remote = remote;
+    shared->thread_count = thread_count;
+    pthread_barrier_init(&shared->barrier, NULL, thread_count);
+
+    double start = pt_now();
+    for (uint32_t i = 0; i < thread_count; i++) {
+        workers[i] = (PtWorker) {.shared = shared, .index = i};
+        pthread_create(&workers[i].thread, NULL, pt_worker, &workers[i]);
+    }
+    for (uint32_t i = 0; i < thread_count; i++) {
+        pthread_join(workers[i].thread, NULL);
+    }
+    double elapsed = pt_now() - start;
+
+    pthread_barrier_destroy(&shared->barrier);
+
+    double allocations = (double) thread_count * PT_ROUNDS * PT_BATCH;
+    return allocations / elapsed;
+}
 
 int main(void) {
-    return 0;
+    /**
+     * @name Debug Environment
+     * @brief Enables verbose logging when VKC_DEBUG=1 is set.
+     * @{
+     */
+
+#if defined(VKC_DEBUG) && (1 == VKC_DEBUG)
+    LOG_DEBUG("[VkCompute] Debug mode.");
+#else
+    LOG_INFO("[VkCompute] Release mode.");
+#endif
+
+    /** @} */
+
+    /**
+     * @name Initialize Global Allocators
+     * @{
+     */
+
+    if (!vkc_allocator_create(NULL)) {
+        return EXIT_FAILURE;
+    }
+
+    PtShared* shared = calloc(1, sizeof(*shared));
+    if (!shared) {
+        LOG_ERROR("[PThreads] Failed to allocate benchmark state.");
+        vkc_allocator_destroy();
+        return EXIT_FAILURE;
+    }
+
+    /** @} */
+
+    /**
+     * @name Scaling Benchmark
+     * @{
+     */
+
+    long cores = sysconf(_SC_NPROCESSORS_ONLN);
+    uint32_t max_threads = cores > 0 ? (uint32_t) cores : 1;
+    if (max_threads > PT_MAX_THREADS) {
+        max_threads = PT_MAX_THREADS;
+    }
+
+    static const char* const backends[] = {"page", "vkc"};
+    static const char* const patterns[] = {"local", "remote"};
+
+    printf("%-8s %-8s %8s %16s %8s\n", "backend", "pattern", "threads", "allocs/sec", "scale");
+    for (uint32_t b = 0; b < 2; b++) {
+        for (uint32_t p = 0; p < 2; p++) {
+            double baseline = 0.0;
+            for (uint32_t threads = 1; threads <= max_threads; threads <<= 1) {
+                double rate = pt_run(shared, (PtBackend) b, 1 == p, threads);
+                if (1 == threads) {
+                    baseline = rate;
+                }
+                printf(
+                    "%-8s %-8s %8u %16.0f %7.2fx\n",
+                    backends[b],
+                    patterns[p],
+                    threads,
+                    rate,
+                    rate / baseline
+                );
+            }
+        }
+    }
+
+    /** @} */
+
+    /**
+     * @name Clean up
+     * @{
+     */
+
+    free(shared);
+
+    if (!vkc_allocator_destroy()) {
+        return EXIT_FAILURE;
+    }
+
+    return EXIT_SUCCESS;
+
+    /** @} */
 }
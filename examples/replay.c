@@ -0,0 +1,507 @@
+/**
+ * @file examples/replay.c
+ * @brief Replay a recorded allocation trace against an allocator backend.
+ *
+ * Capture a trace by running any VkC program with VKC_ALLOCATOR_TRACE set:
+ *
+ *   VKC_ALLOCATOR_TRACE=vk.trace ./build/examples/vk
+ *
+ * Then compare allocator strategies offline, without a GPU:
+ *
+ *   ./build/examples/replay vk.trace vkc
+ *   ./build/examples/replay vk.trace page
+ *   ./build/examples/replay vk.trace libc
+ *
+ * Records are replayed in capture order on a single thread, whatever thread
+ * recorded them. The thread ids in the trace are only counted and reported,
+ * so the vkc backend's per-thread caches and cross-thread frees are not
+ * exercised as they were during capture. Each backend should run in its own
+ * process so that the reported peak RSS is not skewed by a previous run.
+ */
+
+#include "core/posix.h"
+#include "core/memory.h"
+#include "core/logger.h"
+#include "allocator/page.h"
+#include "vk/allocator.h"
+#include "vk/trace.h"
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/resource.h>
+#include <time.h>
+
+#define REPLAY_NONE UINT32_MAX
+
+typedef enum ReplayBackend {
+    REPLAY_BACKEND_VKC,
+    REPLAY_BACKEND_PAGE,
+    REPLAY_BACKEND_LIBC,
+} ReplayBackend;
+
+typedef struct ReplayOp {
+    uint64_t size;
+    uint32_t alignment;
+    uint32_t source; /**< Slot released by the operation, or REPLAY_NONE. */
+    uint32_t target; /**< Slot filled by the operation, or REPLAY_NONE. */
+    uint8_t op;
+    uint8_t scope;
+} ReplayOp;
+
+typedef struct ReplayMap {
+    uint64_t* keys;
+    uint32_t* values;
+    size_t capacity;
+} ReplayMap;
+
+typedef struct ReplayTrace {
+    ReplayOp* ops;
+    size_t count;
+    uint32_t slot_count;
+    uint32_t thread_count; /**< Distinct threads in the capture; replay uses one. */
+} ReplayTrace;
+
+/**
+ * @name Address Map
+ * @brief Open addressing map from traced addresses to replay slots.
+ * @{
+ */
+
+static inline size_t replay_map_hash(const ReplayMap* map, uint64_t key) {
+    key ^= key >> 33;
+    key *= 0xff51afd7ed558ccdull;
+    key ^= key >> 33;
+    return (size_t) key & (map->capacity - 1);
+}
+
+static bool replay_map_create(ReplayMap* map, size_t count) {
+    map->capacity = 16;
+    while (map->capacity < count * 2) {
+        map->capacity <<= 1;
+    }
+    map->keys = calloc(map->capacity, sizeof(*map->keys));
+    map->values = calloc(map->capacity, sizeof(*map->values));
+    return map->keys && map->values;
+}
+
+static void replay_map_free(ReplayMap* map) {
+    free(map->keys);
+    free(map->values);
+}
+
+static void replay_map_insert(ReplayMap* map, uint64_t key, uint32_t value) {
+    size_t i = replay_map_hash(map, key);
+    while (map->keys[i] && map->keys[i] != key) {
+        i = (i + 1) & (map->capacity - 1);
+    }
+    map->keys[i] = key;
+    map->values[i] = value;
+}
+
+static uint32_t replay_map_remove(ReplayMap* map, uint64_t key) {
+    size_t i = replay_map_hash(map, key);
+    while (map->keys[i] && map->keys[i] != key) {
+        i = (i + 1) & (map->capacity - 1);
+    }
+    if (!map->keys[i]) {
+        return REPLAY_NONE;
+    }
+
+    uint32_t value = map->values[i];
+    map->keys[i] = 0;
+
+    // Re-seat the rest of the probe run so lookups never stop at the hole.
+    size_t j = (i + 1) & (map->capacity - 1);
+    while (map->keys[j]) {
+        uint64_t key_j = map->keys[j];
+        uint32_t value_j = map->values[j];
+        map->keys[j] = 0;
+        replay_map_insert(map, key_j, value_j);
+        j = (j + 1) & (map->capacity - 1);
+    }
+
+    return value;
+}
+
+/** @} */
+
+/**
+ * @name Trace Loading
+ * @{
+ */
+
+static bool replay_load(const char* path, ReplayTrace* trace) {
+    FILE* file = fopen(path, "rb");
+    if (!file) {
+        LOG_ERROR("[Replay] Failed to open '%s'.", path);
+        return false;
+    }
+
+    VkcTraceHeader header;
+    if (1 != fread(&header, sizeof(header), 1, file)
+        || 0 != memcmp(header.magic, VKC_TRACE_MAGIC, sizeof(header.magic))
+        || VKC_TRACE_VERSION != header.version || sizeof(VkcTraceRecord) != header.record_size) {
+        LOG_ERROR("[Replay] '%s' is not a version %d VkC trace.", path, VKC_TRACE_VERSION);
+        fclose(file);
+        return false;
+    }
+
+    // Size the tables up front so the raw records can be streamed in chunks
+    // and never inflate the peak RSS of the replay.
+    fseek(file, 0, SEEK_END);
+    long length = ftell(file);
+    fseek(file, (long) sizeof(header), SEEK_SET);
+    size_t count = length > (long) sizeof(header)
+                       ? ((size_t) length - sizeof(header)) / sizeof(VkcTraceRecord)
+                       : 0;
+
+    ReplayMap map = {0};
+    trace->ops = malloc((count ? count : 1) * sizeof(*trace->ops));
+    if (!trace->ops || !replay_map_create(&map, count)) {
+        LOG_ERROR("[Replay] Failed to allocate %zu trace records.", count);
+        free(trace->ops);
+        replay_map_free(&map);
+        fclose(file);
+        return false;
+    }
+
+    // Translate addresses into dense slot ids. Records touching addresses
+    // allocated before the capture started are dropped.
+    VkcTraceRecord records[1024];
+    size_t skipped = 0;
+    size_t n = 0;
+    trace->count = 0;
+    trace->slot_count = 0;
+    trace->thread_count = 0;
+    while ((n = fread(records, sizeof(*records), sizeof(records) / sizeof(*records), file)) > 0) {
+        for (size_t i = 0; i < n && trace->count < count; i++) {
+            VkcTraceRecord* record = &records[i];
+            // Ids are sequential from 1, so the highest is the count.
+            if (record->thread > trace->thread_count) {
+                trace->thread_count = record->thread;
+            }
+
+            ReplayOp op = {
+                .op = record->op,
+                .scope = record->scope,
+                .size = record->size,
+                .alignment = record->alignment,
+                .source = REPLAY_NONE,
+                .target = REPLAY_NONE,
+            };
+
+            uint64_t released = VKC_TRACE_FREE == record->op ? record->address : record->original;
+            if (released) {
+                op.source = replay_map_remove(&map, released);
+                if (REPLAY_NONE == op.source) {
+                    skipped++;
+                    continue;
+                }
+            }
+
+            if (VKC_TRACE_FREE != record->op && record->address) {
+                op.target = trace->slot_count++;
+                replay_map_insert(&map, record->address, op.target);
+            }
+
+            trace->ops[trace->count++] = op;
+        }
+    }
+    fclose(file);
+
+    if (skipped) {
+        LOG_WARN("[Replay] Skipped %zu records of blocks allocated before the capture.", skipped);
+    }
+
+    replay_map_free(&map);
+    return true;
+}
+
+/** @} */
+
+/**
+ * @name Backends
+ * @{
+ */
+
+static void* replay_malloc(ReplayBackend backend, const ReplayOp* op) {
+    switch (backend) {
+        case REPLAY_BACKEND_VKC: {
+            const VkAllocationCallbacks* callbacks = vkc_allocator_callbacks();
+            return callbacks->pfnAllocation(
+                callbacks->pUserData, op->size, op->alignment, (VkSystemAllocationScope) op->scope
+            );
+        }
+        case REPLAY_BACKEND_PAGE:
+            return page_malloc(vkc_allocator_get(), op->size, op->alignment);
+        case REPLAY_BACKEND_LIBC: {
+            void* pointer = NULL;
+            size_t alignment = op->alignment < sizeof(void*) ? sizeof(void*) : op->alignment;
+            return 0 == posix_memalign(&pointer, alignment, op->size) ? pointer : NULL;
+        }
+    }
+    return NULL;
+}
+
+static void* replay_realloc(ReplayBackend backend, const ReplayOp* op, void* original, size_t old) {
+    switch (backend) {
+        case REPLAY_BACKEND_VKC: {
+            const VkAllocationCallbacks* callbacks = vkc_allocator_callbacks();
+            return callbacks->pfnReallocation(
+                callbacks->pUserData,
+                original,
+                op->size,
+                op->alignment,
+                (VkSystemAllocationScope) op->scope
+            );
+        }
+        case REPLAY_BACKEND_PAGE:
+            return page_realloc(vkc_allocator_get(), original, op->size, op->alignment);
+        case REPLAY_BACKEND_LIBC: {
+            // libc realloc only guarantees fundamental alignment.
+            if (op->alignment <= alignof(max_align_t)) {
+                return realloc(original, op->size);
+            }
+            void* pointer = replay_malloc(backend, op);
+            if (pointer) {
+                memcpy(pointer, original, old < op->size ? old : op->size);
+                free(original);
+            }
+            return pointer;
+        }
+    }
+    return NULL;
+}
+
+static void replay_free(ReplayBackend backend, void* pointer) {
+    switch (backend) {
+        case REPLAY_BACKEND_VKC: {
+            const VkAllocationCallbacks* callbacks = vkc_allocator_callbacks();
+            callbacks->pfnFree(callbacks->pUserData, pointer);
+            break;
+        }
+        case REPLAY_BACKEND_PAGE:
+            page_free(vkc_allocator_get(), pointer);
+            break;
+        case REPLAY_BACKEND_LIBC:
+            free(pointer);
+            break;
+    }
+}
+
+/** @} */
+
+/**
+ * @name Measurement
+ * @{
+ */
+
+static inline uint64_t replay_now(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t) ts.tv_sec * 1000000000ull + (uint64_t) ts.tv_nsec;
+}
+
+static int replay_compare(const void* a, const void* b) {
+    uint64_t x = *(const uint64_t*) a;
+    uint64_t y = *(const uint64_t*) b;
+    return (x > y) - (x < y);
+}
+
+static uint64_t replay_percentile(const uint64_t* sorted, size_t count, double percentile) {
+    if (0 == count) {
+        return 0;
+    }
+    size_t index = (size_t) (percentile / 100.0 * (double) (count - 1) + 0.5);
+    return sorted[index];
+}
+
+static long replay_peak_rss(void) {
+    struct rusage usage;
+    getrusage(RUSAGE_SELF, &usage);
+    return usage.ru_maxrss; // KiB on Linux
+}
+
+/** @} */
+
+int main(int argc, char* argv[]) {
+    /**
+     * @name Debug Environment
+     * @brief Enables verbose logging when VKC_DEBUG=1 is set.
+     * @{
+     */
+
+#if defined(VKC_DEBUG) && (1 == VKC_DEBUG)
+    LOG_DEBUG("[VkCompute] Debug mode.");
+#else
+    LOG_INFO("[VkCompute] Release mode.");
+#endif
+
+    /** @} */
+
+    /**
+     * @name Arguments
+     * @{
+     */
+
+    if (argc < 2) {
+        fprintf(stderr, "usage: %s <trace> [vkc|page|libc]\n", argv[0]);
+        return EXIT_FAILURE;
+    }
+
+    static const char* const backends[] = {"vkc", "page", "libc"};
+    ReplayBackend backend = REPLAY_BACKEND_VKC;
+    if (argc > 2) {
+        bool found = false;
+        for (uint32_t i = 0; i < sizeof(backends) / sizeof(*backends); i++) {
+            if (0 == strcmp(argv[2], backends[i])) {
+                backend = (ReplayBackend) i;
+                found = true;
+            }
+        }
+        if (!found) {
+            LOG_ERROR("[Replay] Unknown backend '%s'.", argv[2]);
+            return EXIT_FAILURE;
+        }
+    }
+
+    /** @} */
+
+    /**
+     * @name Initialize Global Allocators
+     * @{
+     */
+
+    // The replay must not record itself.
+    unsetenv("VKC_ALLOCATOR_TRACE");
+
+    if (!vkc_allocator_create(NULL)) {
+        return EXIT_FAILURE;
+    }
+
+    ReplayTrace trace = {0};
+    if (!replay_load(argv[1], &trace)) {
+        vkc_allocator_destroy();
+        return EXIT_FAILURE;
+    }
+
+    void** slots = calloc(trace.slot_count ? trace.slot_count : 1, sizeof(*slots));
+    size_t* sizes = calloc(trace.slot_count ? trace.slot_count : 1, sizeof(*sizes));
+    uint64_t* latencies = malloc((trace.count ? trace.count : 1) * sizeof(*latencies));
+    if (!slots || !sizes || !latencies) {
+        LOG_ERROR("[Replay] Failed to allocate replay state.");
+        free(slots);
+        free(sizes);
+        free(latencies);
+        free(trace.ops);
+        vkc_allocator_destroy();
+        return EXIT_FAILURE;
+    }
+
+    /** @} */
+
+    /**
+     * @name Replay
+     * @{
+     */
+
+    long baseline_rss = replay_peak_rss();
+    size_t failures = 0;
+
+    uint64_t start = replay_now();
+    for (size_t i = 0; i < trace.count; i++) {
+        const ReplayOp* op = &trace.ops[i];
+        void* source = REPLAY_NONE == op->source ? NULL : slots[op->source];
+
+        uint64_t t0 = replay_now();
+        void* target = NULL;
+        switch ((VkcTraceOp) op->op) {
+            case VKC_TRACE_MALLOC:
+                target = replay_malloc(backend, op);
+                break;
+            case VKC_TRACE_REALLOC:
+                if (source && 0 == op->size) {
+                    // Vulkan treats this as a free; not every backend does.
+                    replay_free(backend, source);
+                } else if (source) {
+                    target = replay_realloc(backend, op, source, sizes[op->source]);
+                } else {
+                    target = replay_malloc(backend, op);
+                }
+                break;
+            case VKC_TRACE_FREE:
+                replay_free(backend, source);
+                break;
+        }
+        latencies[i] = replay_now() - t0;
+
+        // A failed realloc leaves the original block live. It stands in for
+        // the new address so the recorded free still releases it.
+        bool kept = VKC_TRACE_REALLOC == op->op && source && 0 != op->size && !target;
+
+        if (REPLAY_NONE != op->target) {
+            slots[op->target] = kept ? source : target;
+            sizes[op->target] = kept ? sizes[op->source] : op->size;
+            failures += NULL == target;
+        }
+        if (REPLAY_NONE != op->source && (!kept || REPLAY_NONE != op->target)) {
+            slots[op->source] = NULL;
+        }
+    }
+    uint64_t elapsed = replay_now() - start;
+
+    long peak_rss = replay_peak_rss();
+
+    // Blocks the traced program never freed are released outside the timed loop.
+    for (uint32_t i = 0; i < trace.slot_count; i++) {
+        if (slots[i]) {
+            replay_free(backend, slots[i]);
+        }
+    }
+
+    /** @} */
+
+    /**
+     * @name Report
+     * @{
+     */
+
+    qsort(latencies, trace.count, sizeof(*latencies), replay_compare);
+
+    double seconds = (double) elapsed * 1e-9;
+    printf("backend:    %s\n", backends[backend]);
+    printf("operations: %zu (%zu failed)\n", trace.count, failures);
+    printf("threads:    %u recorded, replayed on 1 in capture order\n", trace.thread_count);
+    printf("throughput: %.0f ops/sec\n", seconds > 0.0 ? (double) trace.count / seconds : 0.0);
+    printf(
+        "latency:    p50=%luns p90=%luns p99=%luns p99.9=%luns max=%luns\n",
+        (unsigned long) replay_percentile(latencies, trace.count, 50.0),
+        (unsigned long) replay_percentile(latencies, trace.count, 90.0),
+        (unsigned long) replay_percentile(latencies, trace.count, 99.0),
+        (unsigned long) replay_percentile(latencies, trace.count, 99.9),
+        (unsigned long) (trace.count ? latencies[trace.count - 1] : 0)
+    );
+    printf("peak rss:   %ld KiB (%ld KiB before replay)\n", peak_rss, baseline_rss);
+
+    /** @} */
+
+    /**
+     * @name Clean up
+     * @{
+     */
+
+    free(latencies);
+    free(sizes);
+    free(slots);
+    free(trace.ops);
+
+    if (!vkc_allocator_destroy()) {
+        return EXIT_FAILURE;
+    }
+
+    return EXIT_SUCCESS;
+
+    /** @} */
+}
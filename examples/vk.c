@@ -16,6 +16,20 @@
 #include "core/memory.h"
 #include "core/logger.h"
 #include "allocator/page.h"
+#include "vk/allocator.h"
+#include "vk/lease.h"
+#include "vk/memory.h"
+#include "vk/buffer.h"
+#include "vk/sync.h"
+#include "vk/staging.h"
+#include "vk/readback.h"
+#include "vk/stream.h"
+#include "vk/queue.h"
+#include "vk/scheduler.h"
+#include "vk/transfer.h"
+#include "vk/workers.h"
+#include "vk/job.h"
+#include "vk/batcher.h"
 #include "utf8/raw.h"
 #include "numeric/lehmer.h"
 
@@ -24,64 +38,137 @@
 #include <stdalign.h>
 #include <stdlib.h>
 #include <stdio.h>
+#include <time.h>
 
 /**
- * @name Allocator Callbacks
- * @note These must be defined because the allocator expects function pointers.
+ * @name Lease Destructors
  * @{
  */
 
-void* VKAPI_CALL
-vkc_malloc(void* pUserData, size_t size, size_t alignment, VkSystemAllocationScope scope) {
-    (void) scope;
+static void vk_memory_pool_destroy(void* pool) {
+    vkc_memory_pool_free((VkcMemoryPool*) pool);
+}
 
-    PageAllocator* allocator = (PageAllocator*) pUserData;
-    if (NULL == allocator) {
-        LOG_ERROR("[VK_ALLOC] Missing allocation context (PageAllocator)");
-        return NULL;
-    }
+static void vk_buffer_destroy(void* buffer) {
+    vkc_buffer_free((VkcBuffer*) buffer);
+}
 
-    void* address = page_malloc(allocator, size, alignment);
-    if (NULL == address) {
-        LOG_ERROR("[VK_ALLOC] Allocation failed (size=%zu, align=%zu)", size, alignment);
-        return NULL;
-    }
+static void vk_host_destroy(void* pointer) {
+    vkc_allocator_host_free(pointer);
+}
 
-    return address;
+static void vk_readback_destroy(void* readback) {
+    vkc_readback_free((VkcReadback*) readback);
 }
 
-void* VKAPI_CALL vkc_realloc(
-    void* pUserData, void* pOriginal, size_t size, size_t alignment, VkSystemAllocationScope scope
-) {
-    (void) scope;
+static void vk_stream_destroy(void* stream) {
+    vkc_stream_free((VkcStream*) stream);
+}
 
-    PageAllocator* allocator = (PageAllocator*) pUserData;
-    if (NULL == allocator) {
-        LOG_ERROR("[VK_REALLOC] Missing allocation context (PageAllocator)");
-        return NULL;
-    }
+static void vk_queue_request_destroy(void* request) {
+    vkc_device_queue_request_free((VkcDeviceQueueRequest*) request);
+}
 
-    void* address = page_realloc(allocator, pOriginal, size, alignment);
-    if (!address) {
-        LOG_ERROR(
-            "[VK_REALLOC] Allocation failed (pOriginal=%p, size=%zu, align=%zu)",
-            pOriginal,
-            size,
-            alignment
-        );
-        return NULL;
-    }
+static void vk_scheduler_destroy(void* scheduler) {
+    vkc_scheduler_free((VkcScheduler*) scheduler);
+}
+
+static void vk_queue_destroy(void* queue) {
+    vkc_queue_free((VkcQueue*) queue);
+}
+
+static void vk_transfer_destroy(void* transfer) {
+    vkc_transfer_free((VkcTransfer*) transfer);
+}
+
+static void vk_workers_destroy(void* workers) {
+    vkc_workers_free((VkcWorkers*) workers);
+}
+
+static void vk_recorded_job_destroy(void* job) {
+    vkc_recorded_job_free((VkcRecordedJob*) job);
+}
 
-    return address;
+static void vk_batcher_destroy(void* batcher) {
+    vkc_batcher_free((VkcBatcher*) batcher);
 }
 
-void VKAPI_CALL vkc_free(void* pUserData, void* pMemory) {
-    PageAllocator* allocator = (PageAllocator*) pUserData;
-    if (NULL == allocator || NULL == pMemory) {
-        return;
+/** @} */
+
+/**
+ * @name Queue Callbacks
+ * @{
+ */
+
+static bool vk_queue_prepare(VkcSyncPoint point, void* readback) {
+    vkc_readback_commit((VkcReadback*) readback, point);
+    return true;
+}
+
+/** @} */
+
+/**
+ * @name Recording Callbacks
+ * @{
+ */
+
+// Runs on worker threads; the dispatch description is only read.
+static bool vk_workers_record(VkCommandBuffer command, uint32_t index, void* user) {
+    (void) index;
+
+    const VkcBatchDispatch* dispatch = (const VkcBatchDispatch*) user;
+    vkCmdBindPipeline(command, VK_PIPELINE_BIND_POINT_COMPUTE, dispatch->pipeline);
+    vkCmdBindDescriptorSets(
+        command,
+        VK_PIPELINE_BIND_POINT_COMPUTE,
+        dispatch->layout,
+        0,
+        dispatch->set_count,
+        dispatch->sets,
+        0,
+        NULL
+    );
+    vkCmdDispatch(command, dispatch->x, dispatch->y, dispatch->z);
+    return true;
+}
+
+/** @} */
+
+/**
+ * @name Timing
+ * @{
+ */
+
+static double vk_now(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double) ts.tv_sec + (double) ts.tv_nsec * 1e-9;
+}
+
+/** @} */
+
+/**
+ * @name Stream Callbacks
+ * @{
+ */
+
+static bool vk_stream_read(void* dst, VkDeviceSize offset, VkDeviceSize size, void* user) {
+    (void) offset;
+    (void) user;
+
+    float* data = (float*) dst;
+    for (VkDeviceSize i = 0; i < size / sizeof(float); i++) {
+        data[i] = lehmer_generate_float();
     }
 
-    page_free(allocator, pMemory);
+    return true;
+}
+
+static void vk_stream_combine(const void* partial, VkDeviceSize size, uint64_t chunk, void* user) {
+    (void) size;
+    (void) chunk;
+
+    *(double*) user += *(const float*) partial;
 }
 
 /** @} */
@@ -106,13 +193,27 @@ int main(void) {
      * @{
      */
 
-    PageAllocator* pager = page_allocator_create(1024);
-    VkAllocationCallbacks vkAllocationCallback = (VkAllocationCallbacks) {
-        .pUserData = pager,
-        .pfnAllocation = vkc_malloc,
-        .pfnReallocation = vkc_realloc,
-        .pfnFree = vkc_free,
-    };
+    if (!vkc_allocator_create(NULL)) {
+        return EXIT_FAILURE;
+    }
+
+    PageAllocator* pager = vkc_allocator_get();
+    const VkAllocationCallbacks* vkAllocationCallback = vkc_allocator_callbacks();
+
+    /** @} */
+
+    /**
+     * @name Object Lease
+     * @note Owns every Vulkan object below and destroys them newest first.
+     * @{
+     */
+
+    int status = EXIT_FAILURE;
+    VkcLease* lease = vkc_lease_create(pager, vkAllocationCallback);
+    if (NULL == lease) {
+        vkc_allocator_destroy();
+        return EXIT_FAILURE;
+    }
 
     /** @} */
 
@@ -134,7 +235,7 @@ int main(void) {
     result = vkEnumerateInstanceLayerProperties(&vkInstanceLayerPropertyCount, NULL);
     if (VK_SUCCESS != result) {
         LOG_ERROR("[InstanceLayerProperties] Failed to enumerate instance layer property count.");
-        goto cleanup_pager;
+        goto cleanup;
     }
 
     VkLayerProperties* vkInstanceLayerProperties = page_malloc(
@@ -147,7 +248,7 @@ int main(void) {
             "[InstanceLayerProperties] Failed to allocate %u instance layer property objects.", 
             vkInstanceLayerPropertyCount
         );
-        goto cleanup_pager;
+        goto cleanup;
     }
     memset(vkInstanceLayerProperties, 0, vkInstanceLayerPropertyCount * sizeof(VkLayerProperties));
 
@@ -156,7 +257,7 @@ int main(void) {
     );
     if (VK_SUCCESS != result) {
         LOG_ERROR("[InstanceLayerProperties] Failed to enumerate instance layer properties.");
-        goto cleanup_pager;
+        goto cleanup;
     }
 
 #if defined(VKC_DEBUG) && (1 == VKC_DEBUG)
@@ -190,7 +291,7 @@ int main(void) {
     result = vkEnumerateInstanceExtensionProperties(NULL, &vkInstanceExtensionPropertyCount, NULL);
     if (VK_SUCCESS != result) {
         LOG_ERROR("[InstanceExtensionProperties] Failed to enumerate instance extension property count.");
-        goto cleanup_pager;
+        goto cleanup;
     }
 
     VkExtensionProperties* vkInstanceExtensionProperties = page_malloc(
@@ -200,14 +301,14 @@ int main(void) {
     );
     if (NULL == vkInstanceExtensionProperties) {
         LOG_ERROR("[InstanceExtensionProperties] Failed to allocate %u instance extension property objects.", vkInstanceExtensionPropertyCount);
-        goto cleanup_pager;
+        goto cleanup;
     }
     memset(vkInstanceExtensionProperties, 0, vkInstanceExtensionPropertyCount * sizeof(VkExtensionProperties));
 
     result = vkEnumerateInstanceExtensionProperties(NULL, &vkInstanceExtensionPropertyCount, vkInstanceExtensionProperties);
     if (VK_SUCCESS != result) {
         LOG_ERROR("[InstanceExtensionProperties] Failed to enumerate instance extension properties.");
-        goto cleanup_pager;
+        goto cleanup;
     }
 
 #if defined(VKC_DEBUG) && (1 == VKC_DEBUG)
@@ -259,7 +360,7 @@ int main(void) {
     uint32_t vkInstanceAPIVersion;
     if (VK_SUCCESS != vkEnumerateInstanceVersion(&vkInstanceAPIVersion)) {
         LOG_ERROR("Failed to enumerate instance API version.");
-        return 0;
+        goto cleanup;
     }
     
     VkApplicationInfo vkInstanceAppInfo = {
@@ -310,10 +411,14 @@ int main(void) {
     }
 
     VkInstance vkInstance = VK_NULL_HANDLE;
-    result = vkCreateInstance(&vkInstanceCreateInfo, &vkAllocationCallback, &vkInstance);
+    result = vkCreateInstance(&vkInstanceCreateInfo, vkAllocationCallback, &vkInstance);
     if (VK_SUCCESS != result) {
         LOG_ERROR("[VkInstance] Failed to create instance object: %d", result);
-        goto cleanup_pager;
+        goto cleanup;
+    }
+
+    if (!vkc_lease_add(lease, VK_OBJECT_TYPE_INSTANCE, VKC_LEASE_HANDLE(vkInstance), NULL)) {
+        goto cleanup;
     }
 
     // Free dead weight
@@ -337,7 +442,7 @@ int main(void) {
             result,
             vkPhysicalDeviceCount
         );
-        goto cleanup_instance;
+        goto cleanup;
     }
 
     VkPhysicalDevice* vkPhysicalDeviceList = page_malloc(
@@ -347,13 +452,13 @@ int main(void) {
     );
     if (NULL == vkPhysicalDeviceList) {
         LOG_ERROR("[VkPhysicalDevice] Failed to allocate device list.");
-        goto cleanup_instance;
+        goto cleanup;
     }
 
     result = vkEnumeratePhysicalDevices(vkInstance, &vkPhysicalDeviceCount, vkPhysicalDeviceList);
     if (VK_SUCCESS != result) {
         LOG_ERROR("[VkPhysicalDevice] Failed to enumerate devices (VkResult: %d)", result);
-        goto cleanup_instance;
+        goto cleanup;
     }
 
 #if defined(VKC_DEBUG) && (1 == VKC_DEBUG)
@@ -392,7 +497,7 @@ int main(void) {
 
         if (NULL == queue_families) {
             LOG_ERROR("[VkPhysicalDevice] Failed to allocate queue families.");
-            goto cleanup_instance;
+            goto cleanup;
         }
 
         vkGetPhysicalDeviceQueueFamilyProperties(device, &queue_family_count, queue_families);
@@ -450,7 +555,7 @@ int main(void) {
 
             if (NULL == queue_families) {
                 LOG_ERROR("[VkPhysicalDevice] Failed to allocate queue families.");
-                goto cleanup_instance;
+                goto cleanup;
             }
 
             vkGetPhysicalDeviceQueueFamilyProperties(device, &queue_family_count, queue_families);
@@ -485,7 +590,7 @@ int main(void) {
 
     if (VK_NULL_HANDLE == vkPhysicalDevice) {
         LOG_ERROR("[VkPhysicalDevice] No suitable compute device found.");
-        goto cleanup_instance;
+        goto cleanup;
     }
 
     /** @} */
@@ -499,7 +604,7 @@ int main(void) {
     result = vkEnumerateDeviceLayerProperties(vkPhysicalDevice, &vkDeviceLayerPropertyCount, NULL);
     if (VK_SUCCESS != result) {
         LOG_ERROR("[DeviceLayerProperties] Failed to enumerate device layer property count.");
-        goto cleanup_instance;
+        goto cleanup;
     }
 
     bool vkDeviceLayerPropertyFound = false;
@@ -515,13 +620,13 @@ int main(void) {
 
         if (NULL == vkDeviceLayerProperties) {
             LOG_ERROR("[DeviceLayerProperties] Failed to allocate device layer properties.");
-            goto cleanup_instance;
+            goto cleanup;
         }
 
         result = vkEnumerateDeviceLayerProperties(vkPhysicalDevice, &vkDeviceLayerPropertyCount, vkDeviceLayerProperties);
         if (VK_SUCCESS != result) {
             LOG_ERROR("[DeviceLayerProperties] Failed to enumerate device layer properties.");
-            goto cleanup_instance;
+            goto cleanup;
         }
 
 #if defined(VKC_DEBUG) && (1 == VKC_DEBUG)
@@ -557,7 +662,7 @@ int main(void) {
     result = vkEnumerateDeviceExtensionProperties(vkPhysicalDevice, NULL, &vkDeviceExtensionCount, NULL);
     if (VK_SUCCESS != result) {
         LOG_ERROR("[VkPhysicalDevice] Failed to enumerate device extension property count.");
-        goto cleanup_instance;
+        goto cleanup;
     }
 
     VkExtensionProperties* vkDeviceExtensionProperties = page_malloc(
@@ -568,13 +673,13 @@ int main(void) {
 
     if (NULL == vkDeviceExtensionProperties) {
         LOG_ERROR("[VkPhysicalDevice] Failed to allocate device extension properties.");
-        goto cleanup_instance;
+        goto cleanup;
     }
 
     result = vkEnumerateDeviceExtensionProperties(vkPhysicalDevice, NULL, &vkDeviceExtensionCount, vkDeviceExtensionProperties);
     if (VK_SUCCESS != result) {
         LOG_ERROR("[VkPhysicalDevice] Failed to enumerate device extension properties.");
-        goto cleanup_instance;
+        goto cleanup;
     }
 
 #if defined(VKC_DEBUG) && (1 == VKC_DEBUG)
@@ -585,7 +690,8 @@ int main(void) {
     }
 #endif
 
-    uint32_t vkDeviceExtensionNameCount = 13;
+    // Optional extensions go last; missing ones are dropped from the list.
+    uint32_t vkDeviceExtensionNameCount = 15;
     char const* vkDeviceExtensionNames[] = {
         "VK_EXT_descriptor_buffer",
         "VK_EXT_shader_atomic_float",
@@ -601,8 +707,14 @@ int main(void) {
         "VK_KHR_external_fence",
         "VK_KHR_external_memory",
         "VK_KHR_external_semaphore",
+
+        VK_EXT_MEMORY_BUDGET_EXTENSION_NAME, // Optional
+        VK_EXT_EXTERNAL_MEMORY_HOST_EXTENSION_NAME, // Optional
     };
 
+    bool vkMemoryBudgetFound = false;
+    bool vkExternalMemoryHostFound = false;
+    uint32_t vkDeviceExtensionEnabledCount = 0;
     bool vkDeviceExtensionPropertyFound = true;
     for (uint32_t i = 0; i < vkDeviceExtensionNameCount; i++) {
         bool found = false;
@@ -616,10 +728,31 @@ int main(void) {
             }
         }
 
-        if (!found) {
-            LOG_WARN("[DeviceCreateInfo] Extension not available: %s", vkDeviceExtensionNames[i]);
-            vkInstanceExtensionPropertyFound = false;
+        bool optional = true;
+        if (0 == utf8_raw_compare(vkDeviceExtensionNames[i], VK_EXT_MEMORY_BUDGET_EXTENSION_NAME)) {
+            vkMemoryBudgetFound = found;
+        } else if (0 == utf8_raw_compare(vkDeviceExtensionNames[i], VK_EXT_EXTERNAL_MEMORY_HOST_EXTENSION_NAME)) {
+            vkExternalMemoryHostFound = found;
+        } else {
+            optional = false;
+            if (!found) {
+                LOG_WARN("[DeviceCreateInfo] Extension not available: %s", vkDeviceExtensionNames[i]);
+                vkInstanceExtensionPropertyFound = false;
+            }
         }
+
+        if (found || !optional) {
+            vkDeviceExtensionNames[vkDeviceExtensionEnabledCount++] = vkDeviceExtensionNames[i];
+        }
+    }
+    vkDeviceExtensionNameCount = vkDeviceExtensionEnabledCount;
+
+    if (!vkMemoryBudgetFound) {
+        LOG_WARN("[DeviceCreateInfo] %s unavailable; estimating heap budgets.", VK_EXT_MEMORY_BUDGET_EXTENSION_NAME);
+    }
+
+    if (!vkExternalMemoryHostFound) {
+        LOG_WARN("[DeviceCreateInfo] %s unavailable; input will be copied.", VK_EXT_EXTERNAL_MEMORY_HOST_EXTENSION_NAME);
     }
 
     /** @} */
@@ -678,7 +811,7 @@ int main(void) {
         LOG_DEBUG("[VkPhysicalDeviceFeatures2] descriptorBufferImageLayoutIgnored=%s", deviceDescriptorBuffer.descriptorBufferImageLayoutIgnored ? "true" : "false");
     } else {
         LOG_ERROR("[VkPhysialDeviceFeatures2] Descriptor buffer is unsupported for the selected GPU.");
-        goto cleanup_instance;
+        goto cleanup;
     }
 
     if (deviceShaderAtomicFloat.shaderBufferFloat32Atomics) {
@@ -686,7 +819,7 @@ int main(void) {
         LOG_DEBUG("[VkPhysicalDeviceFeatures2] shaderBufferFloat32AtomicAdd=%s", deviceShaderAtomicFloat.shaderBufferFloat32AtomicAdd ? "true" : "false");
     } else {
         LOG_ERROR("[VkPhysialDeviceFeatures2] Atomicity is unsupported for the selected GPU.");
-        goto cleanup_instance;
+        goto cleanup;
     }
 
     if (deviceVulkan12.shaderFloat16) {
@@ -704,20 +837,26 @@ int main(void) {
      * @{
      */
 
-    // The compute queue family we want access to.
-    static const float vkDeviceQueuePriorities[1] = {1.0f};
-    VkDeviceQueueCreateInfo vkDeviceQueueCreateInfo = {
-        .sType = VK_STRUCTURE_TYPE_DEVICE_QUEUE_CREATE_INFO,
-        .queueFamilyIndex = vkQueueFamilyIndex,
-        .queueCount = 1,
-        .pQueuePriorities = vkDeviceQueuePriorities,
-    };
+    // Every queue of every compute family, compute-only families first.
+    VkcDeviceQueueRequest* queueRequest = vkc_device_queue_request_create(
+        vkPhysicalDevice, VK_QUEUE_COMPUTE_BIT
+    );
+    if (NULL == queueRequest) {
+        goto cleanup;
+    }
+
+    if (!vkc_lease_add_custom(lease, vk_queue_request_destroy, queueRequest)) {
+        goto cleanup;
+    }
+
+    // Plus one queue of a transfer-only family for copies, where there is one.
+    vkc_device_queue_request_add_transfer(queueRequest, vkPhysicalDevice);
 
     VkDeviceCreateInfo vkDeviceCreateInfo = {
         .sType = VK_STRUCTURE_TYPE_DEVICE_CREATE_INFO,
         .pNext = &deviceFeatures2,
-        .queueCreateInfoCount = 1,
-        .pQueueCreateInfos = &vkDeviceQueueCreateInfo,
+        .queueCreateInfoCount = queueRequest->count,
+        .pQueueCreateInfos = queueRequest->infos,
         .pEnabledFeatures = NULL, // overridden by pNext chain
     };
 
@@ -732,18 +871,31 @@ int main(void) {
     }
 
     VkDevice vkDevice = VK_NULL_HANDLE;
-    result = vkCreateDevice(vkPhysicalDevice, &vkDeviceCreateInfo, &vkAllocationCallback, &vkDevice);
+    result = vkCreateDevice(vkPhysicalDevice, &vkDeviceCreateInfo, vkAllocationCallback, &vkDevice);
     if (VK_SUCCESS != result) {
         LOG_ERROR("[VkDevice] Failed to create logical device: %d", result);
-        goto cleanup_instance;
+        goto cleanup;
+    }
+
+    if (!vkc_lease_add(lease, VK_OBJECT_TYPE_DEVICE, VKC_LEASE_HANDLE(vkDevice), NULL)) {
+        goto cleanup;
     }
 
     LOG_INFO("[VkDevice] Created logical device @ %p.", vkDevice);
 
-    VkQueue vkQueue = VK_NULL_HANDLE;
-    vkGetDeviceQueue(vkDevice, vkQueueFamilyIndex, 0, &vkQueue);
+    // The transfer family is an extra entry in infos but not in queue_count.
+    bool hasTransferFamily = UINT32_MAX != queueRequest->transfer_family;
+    LOG_INFO(
+        "[VkQueue] Requested %u compute queues in %u families.",
+        queueRequest->queue_count,
+        queueRequest->count - (hasTransferFamily ? 1 : 0)
+    );
 
-    LOG_INFO("[VkQueue] Create logical queue @ %p.", vkQueue);
+    if (hasTransferFamily) {
+        LOG_INFO(
+            "[VkQueue] Requested 1 transfer queue in family %u.", queueRequest->transfer_family
+        );
+    }
 
     /** @} */
 
@@ -756,7 +908,7 @@ int main(void) {
     FILE* shaderFile = fopen(shaderFilePath, "rb");
     if (NULL == shaderFile) {
         LOG_ERROR("[VkShaderModule] Failed to open SPIR-V file: %s", shaderFilePath);
-        goto cleanup_device;
+        goto cleanup;
     }
 
     fseek(shaderFile, 0, SEEK_END);
@@ -765,7 +917,7 @@ int main(void) {
     if (-1 == shaderFilelength) {
         LOG_ERROR("[VkShaderModule] Failed to inference SPIR-V file size: %s", shaderFilePath);
         fclose(shaderFile);
-        goto cleanup_device;
+        goto cleanup;
     }
 
     uint32_t shaderCodeSize = (uint32_t) shaderFilelength;
@@ -778,7 +930,7 @@ int main(void) {
     if (NULL == shaderCode) {
         LOG_ERROR("[VkShaderModule] Failed to allocate %u bytes for SPIR-V shader", shaderCodeSize);
         fclose(shaderFile);
-        goto cleanup_device;
+        goto cleanup;
     }
 
     // Assuming fread null terminates buffer for us
@@ -801,10 +953,14 @@ int main(void) {
     };
 
     VkShaderModule vkShaderModule = VK_NULL_HANDLE;
-    result = vkCreateShaderModule(vkDevice, &vkShaderInfo, &vkAllocationCallback, &vkShaderModule);
+    result = vkCreateShaderModule(vkDevice, &vkShaderInfo, vkAllocationCallback, &vkShaderModule);
     if (VK_SUCCESS != result) {
         LOG_ERROR("[VkShaderModule] Failed to create shader module from %s (VkResult=%d)", shaderFilePath, result);
-        goto cleanup_device;
+        goto cleanup;
+    }
+
+    if (!vkc_lease_add(lease, VK_OBJECT_TYPE_SHADER_MODULE, VKC_LEASE_HANDLE(vkShaderModule), vkDevice)) {
+        goto cleanup;
     }
 
     LOG_INFO("[VkShaderModule] Created shader module @ %p.", vkShaderModule);
@@ -840,10 +996,14 @@ int main(void) {
     };
 
     VkDescriptorSetLayout vkDescriptorSetLayout = VK_NULL_HANDLE;
-    result = vkCreateDescriptorSetLayout(vkDevice, &descriptorSetLayoutCreateInfo, &vkAllocationCallback, &vkDescriptorSetLayout);
+    result = vkCreateDescriptorSetLayout(vkDevice, &descriptorSetLayoutCreateInfo, vkAllocationCallback, &vkDescriptorSetLayout);
     if (VK_SUCCESS != result) {
         LOG_ERROR("[VkDescriptorSetLayout] Failed to create the descriptor set layout (VkResult=%d)", result);
-        goto cleanup_shader_module;
+        goto cleanup;
+    }
+
+    if (!vkc_lease_add(lease, VK_OBJECT_TYPE_DESCRIPTOR_SET_LAYOUT, VKC_LEASE_HANDLE(vkDescriptorSetLayout), vkDevice)) {
+        goto cleanup;
     }
 
     LOG_INFO("[VkDescriptorSetLayout] Created descriptor set layout @ %p.", vkDescriptorSetLayout);
@@ -864,13 +1024,17 @@ int main(void) {
     result = vkCreatePipelineLayout(
         vkDevice,
         &pipelineLayoutCreateInfo,
-        &vkAllocationCallback,
+        vkAllocationCallback,
         &vkPipelineLayout
     );
 
     if (VK_SUCCESS != result) {
         LOG_ERROR("[VkPipelineLayout] Failed to create pipeline layout (VkResult=%d).", result);
-        goto cleanup_descriptor_set_layout;
+        goto cleanup;
+    }
+
+    if (!vkc_lease_add(lease, VK_OBJECT_TYPE_PIPELINE_LAYOUT, VKC_LEASE_HANDLE(vkPipelineLayout), vkDevice)) {
+        goto cleanup;
     }
 
     LOG_INFO("[VkPipelineLayout] Created pipeline layout @ %p.", vkPipelineLayout);
@@ -907,13 +1071,17 @@ int main(void) {
         NULL,
         1,
         &computePipelineCreateInfo,
-        &vkAllocationCallback,
+        vkAllocationCallback,
         &vkPipeline
     );
 
     if (VK_SUCCESS != result) {
         LOG_ERROR("[VkPipeline] Failed to create compute pipeline (VkResult=%d).", result);
-        goto cleanup_pipeline_layout;
+        goto cleanup;
+    }
+
+    if (!vkc_lease_add(lease, VK_OBJECT_TYPE_PIPELINE, VKC_LEASE_HANDLE(vkPipeline), vkDevice)) {
+        goto cleanup;
     }
 
     LOG_INFO("[VkPipeline] Created compute pipeline @ %p.", vkPipeline);
@@ -921,167 +1089,139 @@ int main(void) {
     /** @} */
 
     /**
-     * @name Input Storage Buffer
+     * @name Device Memory Pool
+     * @note Buffers are sub-allocated from shared device memory blocks.
      * @{
      */
 
-    VkBufferCreateInfo inputBufferCreateInfo = {
-        .sType = VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO,
-        .size = 64 * sizeof(float),
-        .usage = VK_BUFFER_USAGE_STORAGE_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_SRC_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT,
-        .sharingMode = VK_SHARING_MODE_EXCLUSIVE,
-    };
+    VkcMemoryPool* memoryPool = vkc_memory_pool_create(
+        pager,
+        vkPhysicalDevice,
+        vkDevice,
+        vkAllocationCallback,
+        (vkMemoryBudgetFound ? VKC_MEMORY_POOL_BUDGET_BIT : 0)
+            | (vkExternalMemoryHostFound ? VKC_MEMORY_POOL_HOST_IMPORT_BIT : 0)
+    );
+    if (NULL == memoryPool) {
+        LOG_ERROR("[VkcMemoryPool] Failed to create device memory pool.");
+        goto cleanup;
+    }
 
-    VkBuffer inputBuffer = VK_NULL_HANDLE;
-    result = vkCreateBuffer(vkDevice, &inputBufferCreateInfo, &vkAllocationCallback, &inputBuffer);
-    if (VK_SUCCESS != result) {
-        LOG_ERROR("[VkBuffer] Failed to create input storage buffer (VkResult=%d).", result);
-        goto cleanup_pipeline;
+    if (!vkc_lease_add_custom(lease, vk_memory_pool_destroy, memoryPool)) {
+        goto cleanup;
     }
 
-    LOG_INFO("[VkBuffer] Created input storage buffer @ %p.", inputBuffer);
+    VkcMemoryBudget memoryBudgets[VK_MAX_MEMORY_HEAPS];
+    uint32_t memoryHeapCount = vkc_memory_budget_query(memoryPool, memoryBudgets);
+    for (uint32_t i = 0; i < memoryHeapCount; i++) {
+        LOG_INFO(
+            "[VkcMemoryPool] Heap %u: budget=%llu MiB, usage=%llu MiB, size=%llu MiB",
+            i,
+            (unsigned long long) (memoryBudgets[i].budget >> 20),
+            (unsigned long long) (memoryBudgets[i].usage >> 20),
+            (unsigned long long) (memoryBudgets[i].size >> 20)
+        );
+    }
 
     /** @} */
 
     /**
-     * @name Input Storage Buffer: Allocate Memory
+     * @name Input Storage Buffer: Generate data
+     * @note Generated in host memory the device reads in place when it can import it.
      * @{
      */
 
-    VkMemoryRequirements inputMemoryRequirements = {0};
-    vkGetBufferMemoryRequirements(vkDevice, inputBuffer, &inputMemoryRequirements);
-
-    VkPhysicalDeviceMemoryProperties physicalDeviceMemoryProperties = {0};
-    vkGetPhysicalDeviceMemoryProperties(vkPhysicalDevice, &physicalDeviceMemoryProperties);
-
-    uint32_t memoryType = UINT32_MAX;
-    for (uint32_t i = 0; i < physicalDeviceMemoryProperties.memoryTypeCount; ++i) {
-        if ((inputMemoryRequirements.memoryTypeBits & (1 << i)) &&
-            (physicalDeviceMemoryProperties.memoryTypes[i].propertyFlags &
-            (VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT)) ==
-                (VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT)) {
-            memoryType = i;
-            break;
-        }
-    }
+    // Imports cover whole units of minImportedHostPointerAlignment.
+    size_t inputAlignment = memoryPool->import_alignment ? memoryPool->import_alignment : alignof(float);
+    size_t inputSize = (64 * sizeof(float) + inputAlignment - 1) / inputAlignment * inputAlignment;
 
-    if (UINT32_MAX == memoryType) {
-        LOG_ERROR("[VkMemory] Failed to find a suitable memory type for input buffer.");
-        goto cleanup_input_buffer;
+    float* inputData = vkc_allocator_host_malloc(inputSize, inputAlignment);
+    if (NULL == inputData) {
+        LOG_ERROR("[VkCompute] Failed to allocate %zu bytes of input.", inputSize);
+        goto cleanup;
     }
 
-    VkMemoryAllocateInfo inputAllocInfo = {
-        .sType = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO,
-        .allocationSize = inputMemoryRequirements.size,
-        .memoryTypeIndex = memoryType,
-    };
-
-    VkDeviceMemory inputMemory = VK_NULL_HANDLE;
-    result = vkAllocateMemory(vkDevice, &inputAllocInfo, &vkAllocationCallback, &inputMemory);
-    if (VK_SUCCESS != result) {
-        LOG_ERROR("[VkMemory] Failed to allocate memory for input buffer (VkResult=%d).", result);
-        goto cleanup_input_buffer;
+    if (!vkc_lease_add_custom(lease, vk_host_destroy, inputData)) {
+        goto cleanup;
     }
 
-    result = vkBindBufferMemory(vkDevice, inputBuffer, inputMemory, 0);
-    if (VK_SUCCESS != result) {
-        LOG_ERROR("[VkMemory] Failed to bind input memory to buffer (VkResult=%d).", result);
-        goto cleanup_input_memory;
+    lehmer_initialize(LEHMER_SEED);
+    for (uint32_t i = 0; i < 64; i++) {
+        inputData[i] = lehmer_generate_float();
     }
 
-    LOG_INFO("[VkMemory] Allocated and bound input buffer to device @ %p.", inputMemory);
-
-    /** @} */
-
-    /**
-     * @name Input Storage Buffer: Upload data
-     * @{
-     */
+    LOG_INFO("[VkCompute] Generated %u input values.", 64);
 
-    void* mapped = NULL;
-    result = vkMapMemory(vkDevice, inputMemory, 0, 64 * sizeof(float), 0, &mapped);
-    if (VK_SUCCESS != result) {
-        LOG_ERROR("[VkMapMemory] Failed to map input memory (VkResult=%d).", result);
-        goto cleanup_input_memory;
+    VkcBuffer* inputBuffer = vkc_buffer_import(
+        memoryPool, inputData, inputSize, VK_BUFFER_USAGE_STORAGE_BUFFER_BIT, VKC_MEMORY_STREAMING
+    );
+    if (NULL == inputBuffer) {
+        LOG_ERROR("[VkcBuffer] Failed to create input storage buffer.");
+        goto cleanup;
     }
 
-    lehmer_initialize(LEHMER_SEED);
-    float* data = (float*) mapped;
-    for (uint32_t i = 0; i < 64; i++) {
-        data[i] = lehmer_generate_float();
+    if (!vkc_lease_add_custom(lease, vk_buffer_destroy, inputBuffer)) {
+        goto cleanup;
     }
-    vkUnmapMemory(vkDevice, inputMemory);
 
-    LOG_INFO("[VkMapMemory] Mapped memory and initialized data @ %p.", mapped);
+    LOG_INFO(
+        "[VkcBuffer] %s input storage buffer @ %p (memory=%p, offset=%llu).",
+        (inputBuffer->flags & VKC_BUFFER_IMPORTED_BIT) ? "Imported" : "Copied",
+        (void*) inputBuffer->object,
+        (void*) inputBuffer->allocation.memory,
+        (unsigned long long) inputBuffer->allocation.offset
+    );
 
     /** @} */
 
     /**
      * @name Output Storage Buffer
-     * @note We do this *after* we submit and sync.
+     * @note Results are copied out through the readback ring after the dispatch.
      * @{
      */
 
-    VkBufferCreateInfo outputBufferCreateInfo = {
-        .sType = VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO,
-        .size = sizeof(float),
-        .usage = VK_BUFFER_USAGE_STORAGE_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_SRC_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT,
-        .sharingMode = VK_SHARING_MODE_EXCLUSIVE,
-    };
+    VkcBuffer* outputBuffer = vkc_buffer_create(
+        memoryPool,
+        sizeof(float),
+        VK_BUFFER_USAGE_STORAGE_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_SRC_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT,
+        VKC_MEMORY_GPU_ONLY,
+        0
+    );
+    if (NULL == outputBuffer) {
+        LOG_ERROR("[VkcBuffer] Failed to create output storage buffer.");
+        goto cleanup;
+    }
 
-    VkBuffer outputBuffer = VK_NULL_HANDLE;
-    result = vkCreateBuffer(vkDevice, &outputBufferCreateInfo, &vkAllocationCallback, &outputBuffer);
-    if (VK_SUCCESS != result) {
-        LOG_ERROR("[VkBuffer] Failed to create output storage buffer (VkResult=%d).", result);
-        goto cleanup_input_memory;
+    if (!vkc_lease_add_custom(lease, vk_buffer_destroy, outputBuffer)) {
+        goto cleanup;
     }
 
+    LOG_INFO(
+        "[VkcBuffer] Created output storage buffer @ %p (memory=%p, offset=%llu).",
+        (void*) outputBuffer->object,
+        (void*) outputBuffer->allocation.memory,
+        (unsigned long long) outputBuffer->allocation.offset
+    );
+
     /** @} */
 
     /**
-     * @name Output Storage Buffer: Allocate Memory
+     * @name Readback Ring
+     * @note Double buffered, so the host can read one batch while the next computes.
      * @{
      */
 
-    VkMemoryRequirements outputMemoryRequirements = {0};
-    vkGetBufferMemoryRequirements(vkDevice, outputBuffer, &outputMemoryRequirements);
-
-    memoryType = UINT32_MAX;
-    for (uint32_t i = 0; i < physicalDeviceMemoryProperties.memoryTypeCount; ++i) {
-        if ((outputMemoryRequirements.memoryTypeBits & (1 << i)) &&
-            (physicalDeviceMemoryProperties.memoryTypes[i].propertyFlags &
-            (VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT)) ==
-                (VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT)) {
-            memoryType = i;
-            break;
-        }
+    VkcReadback* readback = vkc_readback_create(memoryPool, sizeof(float), 2);
+    if (NULL == readback) {
+        LOG_ERROR("[VkcReadback] Failed to create readback ring.");
+        goto cleanup;
     }
 
-    if (UINT32_MAX == memoryType) {
-        LOG_ERROR("[VkMemory] Failed to find a suitable memory type for output buffer.");
-        goto cleanup_output_buffer;
+    if (!vkc_lease_add_custom(lease, vk_readback_destroy, readback)) {
+        goto cleanup;
     }
 
-    VkMemoryAllocateInfo outputAllocInfo = {
-        .sType = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO,
-        .allocationSize = outputMemoryRequirements.size,
-        .memoryTypeIndex = memoryType,
-    };
-
-    VkDeviceMemory outputMemory = VK_NULL_HANDLE;
-    result = vkAllocateMemory(vkDevice, &outputAllocInfo, &vkAllocationCallback, &outputMemory);
-    if (VK_SUCCESS != result) {
-        LOG_ERROR("[VkMemory] Failed to allocate memory for output buffer (VkResult=%d).", result);
-        goto cleanup_output_buffer;
-    }
-
-    result = vkBindBufferMemory(vkDevice, outputBuffer, outputMemory, 0);
-    if (VK_SUCCESS != result) {
-        LOG_ERROR("[VkMemory] Failed to bind output memory to buffer (VkResult=%d).", result);
-        goto cleanup_output_memory;
-    }
-
-    LOG_INFO("[VkMemory] Allocated and bound output buffer to device @ %p.", outputMemory);
+    LOG_INFO("[VkcReadback] Created readback ring with %u slots.", readback->count);
 
     /** @} */
 
@@ -1106,10 +1246,14 @@ int main(void) {
     };
 
     VkDescriptorPool vkDescriptorPool = VK_NULL_HANDLE;
-    result = vkCreateDescriptorPool(vkDevice, &descriptorPoolCreateInfo, &vkAllocationCallback, &vkDescriptorPool);
+    result = vkCreateDescriptorPool(vkDevice, &descriptorPoolCreateInfo, vkAllocationCallback, &vkDescriptorPool);
     if (VK_SUCCESS != result) {
         LOG_ERROR("[VkDescriptorPool] Failed to create descriptor pool (VkResult=%d)", result);
-        goto cleanup_output_memory;
+        goto cleanup;
+    }
+
+    if (!vkc_lease_add(lease, VK_OBJECT_TYPE_DESCRIPTOR_POOL, VKC_LEASE_HANDLE(vkDescriptorPool), vkDevice)) {
+        goto cleanup;
     }
 
     LOG_INFO("[VkDescriptorPool] Created descriptor pool @ %p", vkDescriptorPool);
@@ -1132,7 +1276,7 @@ int main(void) {
     result = vkAllocateDescriptorSets(vkDevice, &descriptorSetAllocationInfo, &vkDescriptorSet);
     if (VK_SUCCESS != result) {
         LOG_ERROR("[VkDescriptorSet] Failed to allocate descriptor set (VkResult=%d)", result);
-        goto cleanup_descriptor_pool;
+        goto cleanup;
     }
 
     LOG_INFO("[VkDescriptorSet] Created descriptor set @ %p", vkDescriptorSet);
@@ -1145,13 +1289,13 @@ int main(void) {
      */
 
     VkDescriptorBufferInfo inputBufferInfo = {
-        .buffer = inputBuffer,
+        .buffer = inputBuffer->object,
         .offset = 0,
         .range = 64 * sizeof(float),
     };
 
     VkDescriptorBufferInfo outputBufferInfo = {
-        .buffer = outputBuffer,
+        .buffer = outputBuffer->object,
         .offset = 0,
         .range = sizeof(float),
     };
@@ -1193,10 +1337,14 @@ int main(void) {
     };
 
     VkCommandPool vkCommandPool = VK_NULL_HANDLE;
-    result = vkCreateCommandPool(vkDevice, &commandPoolCreateInfo, &vkAllocationCallback, &vkCommandPool);
+    result = vkCreateCommandPool(vkDevice, &commandPoolCreateInfo, vkAllocationCallback, &vkCommandPool);
     if (VK_SUCCESS != result) {
         LOG_ERROR("[VkCommandPool] Failed to create command pool (VkResult=%d).", result);
-        goto cleanup_descriptor_set;
+        goto cleanup;
+    }
+
+    if (!vkc_lease_add(lease, VK_OBJECT_TYPE_COMMAND_POOL, VKC_LEASE_HANDLE(vkCommandPool), vkDevice)) {
+        goto cleanup;
     }
 
     LOG_INFO("[VkCommandPool] Created command pool @ %p", vkCommandPool);
@@ -1219,7 +1367,7 @@ int main(void) {
     result = vkAllocateCommandBuffers(vkDevice, &commandBufferAllocateInfo, &vkCommandBuffer);
     if (VK_SUCCESS != result) {
         LOG_ERROR("[VkAllocateCommandBuffers] Failed to allocate command buffer (VkResult=%d).", result);
-        goto cleanup_command_pool;
+        goto cleanup;
     }
 
     LOG_INFO("[VkCommandBuffer] Created command buffer @ %p.", vkCommandBuffer);
@@ -1240,9 +1388,18 @@ int main(void) {
     result = vkBeginCommandBuffer(vkCommandBuffer, &commandBufferBeginInfo);
     if (VK_SUCCESS != result) {
         LOG_ERROR("[vkBeginCommandBuffer] Failed to begin recording (VkResult=%d)", result);
-        goto cleanup_command_buffer;
+        goto cleanup;
     }
 
+    // The shader accumulates atomically, so the sum has to start at zero.
+    vkCmdFillBuffer(vkCommandBuffer, outputBuffer->object, 0, VK_WHOLE_SIZE, 0);
+
+    vkc_staging_ring_barrier(
+        vkCommandBuffer,
+        VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
+        VK_ACCESS_SHADER_READ_BIT | VK_ACCESS_SHADER_WRITE_BIT
+    );
+
     vkCmdBindPipeline(vkCommandBuffer, VK_PIPELINE_BIND_POINT_COMPUTE, vkPipeline);
     vkCmdBindDescriptorSets(
         vkCommandBuffer,
@@ -1259,10 +1416,17 @@ int main(void) {
     // If local_size_x = 64 in shader, use 1
     vkCmdDispatch(vkCommandBuffer, 1, 1, 1);
 
+    VkcReadbackTicket outputTicket = {0};
+    if (!vkc_readback_copy(
+            readback, vkCommandBuffer, outputBuffer->object, 0, sizeof(float), &outputTicket
+        )) {
+        goto cleanup;
+    }
+
     result = vkEndCommandBuffer(vkCommandBuffer);
     if (VK_SUCCESS != result) {
         LOG_ERROR("[vkEndCommandBuffer] Failed to record command buffer (VkResult=%d)", result);
-        goto cleanup_command_buffer;
+        goto cleanup;
     }
 
     LOG_INFO("[VkCommandBuffer] Recorded compute dispatch.");
@@ -1270,29 +1434,52 @@ int main(void) {
     /** @} */
 
     /**
-     * @name Submit Command Buffer and Wait
+     * @name Submit Command Buffer
+     * @note The submission's ticket retires the readback slot.
      * @{
      */
 
-    VkSubmitInfo submitInfo = {
-        .sType = VK_STRUCTURE_TYPE_SUBMIT_INFO,
-        .commandBufferCount = 1,
-        .pCommandBuffers = &vkCommandBuffer,
-    };
+    if (!deviceVulkan12.timelineSemaphore) {
+        LOG_ERROR("[VkcQueue] Timeline semaphores are unsupported for the selected GPU.");
+        goto cleanup;
+    }
 
-    result = vkQueueSubmit(vkQueue, 1, &submitInfo, VK_NULL_HANDLE);
-    if (VK_SUCCESS != result) {
-        LOG_ERROR("[vkQueueSubmit] Failed to submit command buffer (VkResult=%d)", result);
-        goto cleanup_command_buffer;
+    VkcScheduler* scheduler = vkc_scheduler_create(
+        pager, vkDevice, queueRequest, vkAllocationCallback, VKC_SCHEDULER_LEAST_LOADED
+    );
+    if (NULL == scheduler) {
+        LOG_ERROR("[VkcScheduler] Failed to create scheduler.");
+        goto cleanup;
     }
 
-    result = vkQueueWaitIdle(vkQueue);
-    if (VK_SUCCESS != result) {
-        LOG_ERROR("[vkQueueWaitIdle] Failed to idle queue after submission (VkResult=%d)", result);
-        goto cleanup_command_buffer;
+    // Registered after every resource the queues' work touches, so it is
+    // released first and waits for that work before anything is destroyed.
+    if (!vkc_lease_add_custom(lease, vk_scheduler_destroy, scheduler)) {
+        goto cleanup;
     }
 
-    LOG_INFO("[VkQueue] Compute queue submitted and idle.");
+    // Command buffers below come from a pool of vkQueueFamilyIndex.
+    uint32_t computeQueueIndex = vkc_scheduler_pick(scheduler, vkQueueFamilyIndex);
+    if (VKC_SCHEDULER_NONE == computeQueueIndex) {
+        LOG_ERROR("[VkcScheduler] No queue of family %u to submit to.", vkQueueFamilyIndex);
+        goto cleanup;
+    }
+
+    VkcQueue* computeQueue = scheduler->queues[computeQueueIndex];
+
+    VkcQueueSubmit computeSubmit = {
+        .commands = &vkCommandBuffer,
+        .command_count = 1,
+        .prepare = vk_queue_prepare,
+        .user = readback,
+    };
+
+    uint64_t computeTicket = vkc_queue_submit(computeQueue, &computeSubmit);
+    if (0 == computeTicket) {
+        goto cleanup;
+    }
+
+    LOG_INFO("[VkcQueue] Compute queue submitted ticket %llu.", (unsigned long long) computeTicket);
 
     /** @} */
 
@@ -1301,92 +1488,351 @@ int main(void) {
      * @{
      */
 
-    float* out = NULL;
-    result = vkMapMemory(vkDevice, outputMemory, 0, sizeof(float), 0, (void**)&out);
-    if (VK_SUCCESS != result) {
-        LOG_ERROR("[VkMapMemory] Failed to map output memory.");
-        goto cleanup_command_buffer;
+    // Blocks only until this submission's ticket signals, not until the queue idles.
+    const float* out = vkc_readback_wait(readback, outputTicket, UINT64_MAX);
+    if (NULL == out) {
+        LOG_ERROR("[VkcReadback] Failed to read back output.");
+        goto cleanup;
     }
 
-    LOG_INFO("[VkMapMemory] Output result: %.6f", (double) (*out) / 64);
-    vkUnmapMemory(vkDevice, outputMemory);
+    LOG_INFO("[VkcReadback] Output result: %.6f", (double) (*out) / 64);
+    vkc_readback_release(readback, outputTicket);
 
     /** @} */
 
     /**
-     * @name Clean up on Success
+     * @name Out-of-Core Stream
+     * @note Runs the same pipeline over far more input than one dispatch holds.
      * @{
      */
 
-    vkFreeCommandBuffers(vkDevice, vkCommandPool, 1, &vkCommandBuffer);
-    vkDestroyCommandPool(vkDevice, vkCommandPool, &vkAllocationCallback);
-    vkFreeDescriptorSets(vkDevice, vkDescriptorPool, 1, &vkDescriptorSet);
-    vkDestroyDescriptorPool(vkDevice, vkDescriptorPool, &vkAllocationCallback);
-    vkFreeMemory(vkDevice, outputMemory, &vkAllocationCallback);
-    vkDestroyBuffer(vkDevice, outputBuffer, &vkAllocationCallback);
-    vkFreeMemory(vkDevice, inputMemory, &vkAllocationCallback);
-    vkDestroyBuffer(vkDevice, inputBuffer, &vkAllocationCallback);
-    vkDestroyPipeline(vkDevice, vkPipeline, &vkAllocationCallback);
-    vkDestroyPipelineLayout(vkDevice, vkPipelineLayout, &vkAllocationCallback);
-    vkDestroyDescriptorSetLayout(vkDevice, vkDescriptorSetLayout, &vkAllocationCallback);
-    vkDestroyShaderModule(vkDevice, vkShaderModule, &vkAllocationCallback);
-    vkDestroyDevice(vkDevice, &vkAllocationCallback);
-    vkDestroyInstance(vkInstance, &vkAllocationCallback);
-    page_allocator_free(pager);
+    // Copies go to a DMA queue when the device has one, else to computeQueue.
+    VkcQueue* transferQueue = NULL;
+    if (UINT32_MAX != queueRequest->transfer_family) {
+        VkQueue vkTransferQueue = VK_NULL_HANDLE;
+        vkGetDeviceQueue(vkDevice, queueRequest->transfer_family, 0, &vkTransferQueue);
 
-#if defined(VKC_DEBUG) && (1 == VKC_DEBUG)
-    LOG_DEBUG("[VkCompute] Debug Mode: Exit Success");
-#else
-    LOG_INFO("[VkCompute] Release Mode: Exit Success");
-#endif
+        transferQueue = vkc_queue_create(
+            pager, vkDevice, vkTransferQueue, queueRequest->transfer_family, vkAllocationCallback
+        );
+        if (NULL == transferQueue) {
+            goto cleanup;
+        }
 
-    return EXIT_SUCCESS;
+        if (!vkc_lease_add_custom(lease, vk_queue_destroy, transferQueue)) {
+            goto cleanup;
+        }
+    }
 
-    /** {@ */
+    // Each chunk submits an upload and a readback, so twice the stream depth.
+    VkcTransfer* transfer = vkc_transfer_create(transferQueue, computeQueue, 4);
+    if (NULL == transfer) {
+        LOG_ERROR("[VkcTransfer] Failed to create transfer.");
+        goto cleanup;
+    }
 
-/**
- * @name Clean up on Failure
- * @{
- */
+    // Registered before the stream, whose slots wait on its queue when freed.
+    if (!vkc_lease_add_custom(lease, vk_transfer_destroy, transfer)) {
+        goto cleanup;
+    }
+
+    LOG_INFO(
+        "[VkcTransfer] Copying on queue family %u (%s).",
+        transfer->queue->family,
+        transfer->dedicated ? "dedicated" : "shared with compute"
+    );
+
+    VkcStreamInfo streamInfo = {
+        .transfer = transfer,
+        .queue = computeQueue->queue,
+        .queue_family = vkQueueFamilyIndex,
+        .pipeline = vkPipeline,
+        .layout = vkPipelineLayout,
+        .set_layout = vkDescriptorSetLayout,
+        .group_size = 64 * sizeof(float),
+        .chunk_size = 64 * 1024, // Small on purpose, to exercise many chunks.
+        .output_size = sizeof(float),
+        .depth = 2,
+    };
+
+    VkcStream* stream = vkc_stream_create(memoryPool, &streamInfo);
+    if (NULL == stream) {
+        LOG_ERROR("[VkcStream] Failed to create stream.");
+        goto cleanup;
+    }
+
+    if (!vkc_lease_add_custom(lease, vk_stream_destroy, stream)) {
+        goto cleanup;
+    }
+
+    const VkDeviceSize streamCount = 1024 * 1024;
+    double streamSum = 0.0;
+    if (!vkc_stream_run(
+            stream, streamCount * sizeof(float), vk_stream_read, vk_stream_combine, &streamSum
+        )) {
+        LOG_ERROR("[VkcStream] Failed to run stream.");
+        goto cleanup;
+    }
+
+    LOG_INFO(
+        "[VkcStream] Mean of %llu streamed values: %.6f",
+        (unsigned long long) streamCount,
+        streamSum / (double) streamCount
+    );
+
+    /** @} */
+
+    /**
+     * @name Recorded Job
+     * @note Recorded once, then replayed; only the indirect group count is rewritten.
+     * @{
+     */
+
+    VkcJobInfo jobInfo = {
+        .pipeline = vkPipeline,
+        .layout = vkPipelineLayout,
+        .sets = &vkDescriptorSet,
+        .set_count = 1,
+        .frames = 2,
+    };
+
+    VkcRecordedJob* recordedJob = vkc_recorded_job_create(memoryPool, computeQueue, &jobInfo);
+    if (NULL == recordedJob) {
+        LOG_ERROR("[VkcRecordedJob] Failed to create recorded job.");
+        goto cleanup;
+    }
+
+    if (!vkc_lease_add_custom(lease, vk_recorded_job_destroy, recordedJob)) {
+        goto cleanup;
+    }
+
+    const VkDispatchIndirectCommand jobGroups = {.x = 1, .y = 1, .z = 1};
+    uint64_t jobTicket = 0;
+    for (uint32_t i = 0; i < 256; i++) {
+        jobTicket = vkc_recorded_job_submit(recordedJob, NULL, &jobGroups);
+        if (0 == jobTicket) {
+            goto cleanup;
+        }
+    }
+
+    if (!vkc_queue_wait(computeQueue, jobTicket, UINT64_MAX)) {
+        LOG_ERROR("[VkcRecordedJob] Failed to wait for ticket %llu.", (unsigned long long) jobTicket);
+        goto cleanup;
+    }
+
+    LOG_INFO(
+        "[VkcRecordedJob] Replayed %llu calls from %u recordings.",
+        (unsigned long long) recordedJob->submissions,
+        recordedJob->frame_count
+    );
+
+    /** @} */
+
+    /**
+     * @name Batched Submission
+     * @note Tiny jobs, timed one submit per job and then coalesced by a batcher.
+     * @{
+     */
+
+    const uint32_t benchJobs = 4096;
 
-cleanup_command_buffer:
-    vkFreeCommandBuffers(vkDevice, vkCommandPool, 1, &vkCommandBuffer);
-cleanup_command_pool:
-    vkDestroyCommandPool(vkDevice, vkCommandPool, &vkAllocationCallback);
-cleanup_descriptor_set:
-    vkFreeDescriptorSets(vkDevice, vkDescriptorPool, 1, &vkDescriptorSet);
-cleanup_descriptor_pool:
-    vkDestroyDescriptorPool(vkDevice, vkDescriptorPool, &vkAllocationCallback);
-cleanup_output_memory:
-    vkFreeMemory(vkDevice, outputMemory, &vkAllocationCallback);
-cleanup_output_buffer:
-    vkDestroyBuffer(vkDevice, outputBuffer, &vkAllocationCallback);
-cleanup_input_memory:
-    vkFreeMemory(vkDevice, inputMemory, &vkAllocationCallback);
-cleanup_input_buffer:
-    vkDestroyBuffer(vkDevice, inputBuffer, &vkAllocationCallback);
-cleanup_pipeline:
-    vkDestroyPipeline(vkDevice, vkPipeline, &vkAllocationCallback);
-cleanup_pipeline_layout:
-    vkDestroyPipelineLayout(vkDevice, vkPipelineLayout, &vkAllocationCallback);
-cleanup_descriptor_set_layout:
-    vkDestroyDescriptorSetLayout(vkDevice, vkDescriptorSetLayout, &vkAllocationCallback);
-cleanup_shader_module:
-    vkDestroyShaderModule(vkDevice, vkShaderModule, &vkAllocationCallback);
-cleanup_device:
-    vkDestroyDevice(vkDevice, &vkAllocationCallback);
-cleanup_instance:
-    vkDestroyInstance(vkInstance, &vkAllocationCallback);
-cleanup_pager:
-    page_allocator_free(pager);
+    double benchStart = vk_now();
+    for (uint32_t i = 0; i < benchJobs; i++) {
+        jobTicket = vkc_recorded_job_submit(recordedJob, NULL, &jobGroups);
+        if (0 == jobTicket) {
+            goto cleanup;
+        }
+    }
+
+    if (!vkc_queue_wait(computeQueue, jobTicket, UINT64_MAX)) {
+        LOG_ERROR("[VkcRecordedJob] Failed to wait for ticket %llu.", (unsigned long long) jobTicket);
+        goto cleanup;
+    }
+    double unbatchedRate = benchJobs / (vk_now() - benchStart);
+
+    VkcBatcherInfo batcherInfo = {
+        .max_dispatches = 256,
+        .window_ns = 100000, // 100 us
+        .depth = 2,
+    };
+
+    VkcBatcher* batcher = vkc_batcher_create(computeQueue, &batcherInfo);
+    if (NULL == batcher) {
+        LOG_ERROR("[VkcBatcher] Failed to create batcher.");
+        goto cleanup;
+    }
+
+    if (!vkc_lease_add_custom(lease, vk_batcher_destroy, batcher)) {
+        goto cleanup;
+    }
+
+    VkcBatchDispatch batchDispatch = {
+        .pipeline = vkPipeline,
+        .layout = vkPipelineLayout,
+        .sets = &vkDescriptorSet,
+        .set_count = 1,
+        .x = 1,
+        .y = 1,
+        .z = 1,
+    };
+
+    uint64_t batchTicket = 0;
+    benchStart = vk_now();
+    for (uint32_t i = 0; i < benchJobs; i++) {
+        batchTicket = vkc_batcher_dispatch(batcher, &batchDispatch);
+        if (0 == batchTicket) {
+            goto cleanup;
+        }
+    }
+
+    if (!vkc_batcher_wait(batcher, batchTicket, UINT64_MAX)) {
+        LOG_ERROR("[VkcBatcher] Failed to wait for ticket %llu.", (unsigned long long) batchTicket);
+        goto cleanup;
+    }
+    double batchedRate = benchJobs / (vk_now() - benchStart);
+
+    LOG_INFO(
+        "[VkcBatcher] %u jobs: %.0f jobs/s unbatched, %.0f jobs/s in %llu submissions.",
+        benchJobs,
+        unbatchedRate,
+        batchedRate,
+        (unsigned long long) batcher->submitted
+    );
+
+    /** @} */
+
+    /**
+     * @name Multi-Queue Scheduling
+     * @note One recorded job per queue of the family; the scheduler picks a queue per call.
+     * @{
+     */
+
+    VkcRecordedJob* queueJobs[VKC_SCHEDULER_QUEUES_MAX] = {0};
+    uint32_t queueJobCount = 0;
+    for (uint32_t i = 0; i < scheduler->queue_count; i++) {
+        if (vkQueueFamilyIndex != scheduler->queues[i]->family) {
+            continue;
+        }
+
+        queueJobs[i] = vkc_recorded_job_create(memoryPool, scheduler->queues[i], &jobInfo);
+        if (NULL == queueJobs[i]) {
+            LOG_ERROR("[VkcScheduler] Failed to create job for queue %u.", i);
+            goto cleanup;
+        }
+
+        if (!vkc_lease_add_custom(lease, vk_recorded_job_destroy, queueJobs[i])) {
+            goto cleanup;
+        }
+
+        queueJobCount++;
+    }
+
+    benchStart = vk_now();
+    for (uint32_t i = 0; i < benchJobs; i++) {
+        uint32_t index = vkc_scheduler_pick(scheduler, vkQueueFamilyIndex);
+        if (0 == vkc_recorded_job_submit(queueJobs[index], NULL, &jobGroups)) {
+            goto cleanup;
+        }
+    }
+
+    if (!vkc_scheduler_wait_idle(scheduler, UINT64_MAX)) {
+        LOG_ERROR("[VkcScheduler] Failed to drain queues.");
+        goto cleanup;
+    }
+    double scheduledRate = benchJobs / (vk_now() - benchStart);
+
+    LOG_INFO(
+        "[VkcScheduler] %u jobs over %u queues: %.0f jobs/s.",
+        benchJobs,
+        queueJobCount,
+        scheduledRate
+    );
+
+    /** @} */
+
+    /**
+     * @name Parallel Recording
+     * @note One command buffer per job, recorded by one worker and then by one per core.
+     * @{
+     */
+
+    VkCommandBuffer* recordCommands = vkc_allocator_host_malloc(
+        benchJobs * sizeof(VkCommandBuffer), alignof(VkCommandBuffer)
+    );
+    if (NULL == recordCommands) {
+        goto cleanup;
+    }
+
+    if (!vkc_lease_add_custom(lease, vk_host_destroy, recordCommands)) {
+        goto cleanup;
+    }
+
+    const uint32_t workerCounts[] = {1, VKC_WORKERS_AUTO};
+    for (uint32_t i = 0; i < sizeof(workerCounts) / sizeof(*workerCounts); i++) {
+        VkcWorkers* workers = vkc_workers_create(computeQueue, workerCounts[i]);
+        if (NULL == workers) {
+            LOG_ERROR("[VkcWorkers] Failed to create workers.");
+            goto cleanup;
+        }
+
+        if (!vkc_lease_add_custom(lease, vk_workers_destroy, workers)) {
+            goto cleanup;
+        }
+
+        // Workers only record; this thread owns the queue and submits once.
+        benchStart = vk_now();
+        if (!vkc_workers_record(
+                workers, benchJobs, vk_workers_record, &batchDispatch, recordCommands
+            )) {
+            LOG_ERROR("[VkcWorkers] Failed to record %u jobs.", benchJobs);
+            goto cleanup;
+        }
+        double recordedRate = benchJobs / (vk_now() - benchStart);
+
+        VkcQueueSubmit recordSubmit = {
+            .commands = recordCommands,
+            .command_count = benchJobs,
+        };
+
+        uint64_t recordTicket = vkc_queue_submit(computeQueue, &recordSubmit);
+        if (0 == recordTicket || !vkc_queue_wait(computeQueue, recordTicket, UINT64_MAX)) {
+            LOG_ERROR("[VkcWorkers] Failed to run %u recorded jobs.", benchJobs);
+            goto cleanup;
+        }
+
+        if (!vkc_workers_reset(workers)) {
+            goto cleanup;
+        }
+
+        LOG_INFO(
+            "[VkcWorkers] %u jobs on %u workers: %.0f recordings/s.",
+            benchJobs,
+            workers->count,
+            recordedRate
+        );
+    }
+
+    /** @} */
+
+    status = EXIT_SUCCESS;
+
+    /**
+     * @name Clean up
+     * @note The lease destroys every registered object, newest first.
+     * @{
+     */
+
+cleanup:
+    vkc_lease_free(lease);
+    vkc_allocator_destroy();
 
 #if defined(VKC_DEBUG) && (1 == VKC_DEBUG)
-    LOG_DEBUG("[VkCompute] Debug Mode: Exit Failure");
+    LOG_DEBUG("[VkCompute] Debug Mode: Exit %s", EXIT_SUCCESS == status ? "Success" : "Failure");
 #else
-    LOG_INFO("[VkCompute] Release Mode: Exit Failure");
+    LOG_INFO("[VkCompute] Release Mode: Exit %s", EXIT_SUCCESS == status ? "Success" : "Failure");
 #endif
 
-    return EXIT_FAILURE;
+    return status;
 
-/** @} */
+    /** @} */
 }
@@ -3,11 +3,26 @@
  * @brief Vulkan Host Memory Allocator using a tracked page map.
  *
  * This interface manages Vulkan host memory allocations using an internal,
- * thread-safe PageAllocator. It provides a global allocation context which
- * can be safely passed to Vulkan interfaces.
+ * thread-safe PageAllocator. Each VkcAllocatorContext owns its PageAllocator,
+ * thread caches, and callbacks, so contexts created per instance, device, or
+ * worker never contend with each other, and freeing a context releases all of
+ * its memory in bulk. The vkc_allocator_* functions without a context operate
+ * on a global default context for code that does not need isolation.
+ *
+ * Driver allocations are routed through a per-thread cache: COMMAND and OBJECT
+ * scopes are served by the thread's bump arenas, which reset in bulk once all
+ * of their allocations are freed, and small CACHE, DEVICE, and INSTANCE scoped
+ * blocks are recycled through the thread's magazines, which refill in batches
+ * from shared size class slabs. Only oversized or overaligned requests are
+ * tracked individually by the PageAllocator.
  *
  * Use `vkc_allocator_callbacks()` to obtain a Vulkan-compatible callback struct.
  * Use `vkc_allocator_get()` to manually allocate through the internal allocator.
+ * Use `vkc_allocator_host_malloc()` for large host buffers, which are mapped
+ * directly and may be backed by huge pages (see VKC_ALLOCATOR_HUGE_PAGES_BIT).
+ * Use `vkc_allocator_stats()` to inspect callback traffic per allocation scope.
+ * Use `vkc_allocator_trace_begin()`, or set VKC_ALLOCATOR_TRACE to a file path
+ * before `vkc_allocator_create()`, to record every callback for offline replay.
  */
 
 #ifndef VKC_ALLOCATOR_H
@@ -20,31 +35,235 @@
 extern "C" {
 #endif
 
+/**
+ * @brief Number of tracked VkSystemAllocationScope values (COMMAND through INSTANCE).
+ */
+#define VKC_ALLOCATOR_SCOPE_COUNT 5
+
+/**
+ * @brief Number of request size histogram bins.
+ *
+ * Bin i counts requests of at most (16 << i) bytes that did not fit a smaller
+ * bin. The last bin collects every larger request.
+ */
+#define VKC_ALLOCATOR_HISTOGRAM_BINS 16
+
+/**
+ * @brief Allocation statistics for a single VkSystemAllocationScope.
+ */
+typedef struct VkcAllocatorScopeStats {
+    uint64_t live_bytes; /**< Bytes currently allocated through the callbacks. */
+    uint64_t peak_bytes; /**< High water mark of live_bytes. */
+    uint64_t allocation_count; /**< Number of pfnAllocation calls. */
+    uint64_t reallocation_count; /**< Number of pfnReallocation calls. */
+    uint64_t free_count; /**< Number of blocks released. */
+    uint64_t internal_bytes; /**< Live driver-internal bytes reported by the driver. */
+    uint64_t internal_peak_bytes; /**< High water mark of internal_bytes. */
+    uint64_t internal_allocation_count; /**< Number of pfnInternalAllocation notifications. */
+    uint64_t histogram[VKC_ALLOCATOR_HISTOGRAM_BINS]; /**< Request sizes by power of two. */
+} VkcAllocatorScopeStats;
+
+/**
+ * @brief Snapshot of the global allocator statistics.
+ *
+ * Counters are kept per thread and aggregated on read, so they are cheap
+ * enough to stay enabled in release builds. Live byte deltas are folded into
+ * the shared peak once they exceed a small per-thread threshold, so peak_bytes
+ * may trail the true high water mark by up to that threshold for every thread
+ * and scope.
+ */
+typedef struct VkcAllocatorStats {
+    VkcAllocatorScopeStats scopes[VKC_ALLOCATOR_SCOPE_COUNT]; /**< Indexed by allocation scope. */
+    VkcAllocatorScopeStats total; /**< Sum over every scope, with its own peak. */
+} VkcAllocatorStats;
+
+/**
+ * @brief Options accepted by vkc_allocator_create().
+ */
+typedef enum VkcAllocatorFlagBits {
+    /**
+     * Back large mappings with 2 MiB pages. MAP_HUGETLB is tried first, then a
+     * huge page aligned mapping with madvise(MADV_HUGEPAGE).
+     */
+    VKC_ALLOCATOR_HUGE_PAGES_BIT = 0x00000001,
+} VkcAllocatorFlagBits;
+
+typedef uint32_t VkcAllocatorFlags;
+
+/**
+ * @brief Parameters of the global allocation context.
+ */
+typedef struct VkcAllocatorCreateInfo {
+    VkcAllocatorFlags flags; /**< Bitmask of VkcAllocatorFlagBits. */
+    size_t huge_page_threshold; /**< Smallest huge page backed block, or 0 for 2 MiB. */
+} VkcAllocatorCreateInfo;
+
+/**
+ * @brief Independent allocation context with its own tracking table and caches.
+ */
+typedef struct VkcAllocatorContext VkcAllocatorContext;
+
+/**
+ * @name Allocation Contexts
+ * @{
+ */
+
+/**
+ * @brief Create an allocation context.
+ *
+ * Each context creates its own pthread key to find the calling thread's cache,
+ * so at most PTHREAD_KEYS_MAX contexts (128 on some systems, and shared with
+ * every other key in the process) can exist at once. Contexts are meant per
+ * device or per subsystem, not per object.
+ *
+ * @param info Allocator options, or NULL for the defaults.
+ * @return Allocated context, or NULL on failure.
+ */
+VkcAllocatorContext* vkc_allocator_context_create(const VkcAllocatorCreateInfo* info);
+
+/**
+ * @brief Destroy a context and release every block it still owns.
+ *
+ * Every Vulkan object created with the context's callbacks must be destroyed first.
+ *
+ * @param context Pointer returned by vkc_allocator_context_create().
+ */
+void vkc_allocator_context_free(VkcAllocatorContext* context);
+
+/**
+ * @brief Get the Vulkan-compatible allocation callbacks bound to a context.
+ */
+const VkAllocationCallbacks* vkc_allocator_context_callbacks(VkcAllocatorContext* context);
+
+/**
+ * @brief Get the PageAllocator owned by a context.
+ */
+PageAllocator* vkc_allocator_context_pager(VkcAllocatorContext* context);
+
+/**
+ * @brief Aggregate the allocation statistics of a context.
+ */
+bool vkc_allocator_context_stats(VkcAllocatorContext* context, VkcAllocatorStats* stats);
+
+/**
+ * @brief Start recording the callbacks of a context to a trace file.
+ */
+bool vkc_allocator_context_trace_begin(VkcAllocatorContext* context, const char* path);
+
+/**
+ * @brief Stop recording the callbacks of a context.
+ */
+void vkc_allocator_context_trace_end(VkcAllocatorContext* context);
+
+/**
+ * @brief Allocate host memory from a context. See vkc_allocator_host_malloc().
+ */
+void* vkc_allocator_context_host_malloc(
+    VkcAllocatorContext* context, size_t size, size_t alignment
+);
+
+/**
+ * @brief Resize host memory owned by a context. See vkc_allocator_host_realloc().
+ */
+void* vkc_allocator_context_host_realloc(
+    VkcAllocatorContext* context, void* pointer, size_t size, size_t alignment
+);
+
+/**
+ * @brief Free host memory owned by a context.
+ */
+void vkc_allocator_context_host_free(VkcAllocatorContext* context, void* pointer);
+
+/** @} */
+
+/**
+ * @name Global Context
+ * @{
+ */
+
 /**
  * @brief Initialize the global Vulkan allocation context.
  *
  * Allocates and initializes the internal PageAllocator and callback bindings.
  * Must be called before using vkc_allocator_get() or vkc_allocator_callbacks().
  *
+ * @param info Allocator options, or NULL for the defaults.
  * @return true on success, false on failure
  */
-bool vkc_allocator_create(void);
+bool vkc_allocator_create(const VkcAllocatorCreateInfo* info);
 
 /**
  * @brief Destroy the global allocation context and free all memory.
  */
 bool vkc_allocator_destroy(void);
 
+/**
+ * @brief Get the global allocation context, or NULL if it is uninitialized.
+ */
+VkcAllocatorContext* vkc_allocator_context(void);
+
 /**
  * @brief Get the internal PageAllocator used for Vulkan memory.
  */
 PageAllocator* vkc_allocator_get(void);
 
+/**
+ * @brief Allocate host memory outside of the Vulkan callbacks.
+ *
+ * Blocks of 64 KiB or more are private anonymous mappings: they grow with
+ * mremap on reallocation and use huge pages when the allocator was created
+ * with VKC_ALLOCATOR_HUGE_PAGES_BIT. Host blocks are not counted in
+ * vkc_allocator_stats().
+ *
+ * @param size      Number of bytes to allocate.
+ * @param alignment Power of two alignment of the returned address.
+ * @return Allocated block, or NULL on failure.
+ */
+void* vkc_allocator_host_malloc(size_t size, size_t alignment);
+
+/**
+ * @brief Resize a block returned by vkc_allocator_host_malloc().
+ *
+ * @return Resized block, or NULL on failure, in which case pointer is untouched.
+ */
+void* vkc_allocator_host_realloc(void* pointer, size_t size, size_t alignment);
+
+/**
+ * @brief Free a block returned by vkc_allocator_host_malloc().
+ */
+void vkc_allocator_host_free(void* pointer);
+
 /**
  * @brief Get the Vulkan-compatible allocation callbacks.
  */
 const VkAllocationCallbacks* vkc_allocator_callbacks(void);
 
+/**
+ * @brief Aggregate the allocation statistics of every thread.
+ *
+ * @param stats Receives the snapshot.
+ * @return true on success, false if the allocator is uninitialized.
+ */
+bool vkc_allocator_stats(VkcAllocatorStats* stats);
+
+/**
+ * @brief Start recording every allocation callback to a binary trace file.
+ *
+ * Traced callbacks are serialized, so tracing is meant for capturing
+ * allocation patterns rather than for production runs.
+ *
+ * @param path Output file, truncated if it exists. See vk/trace.h for the format.
+ * @return true on success, false if the trace cannot be started.
+ */
+bool vkc_allocator_trace_begin(const char* path);
+
+/**
+ * @brief Stop recording and flush the trace file.
+ */
+void vkc_allocator_trace_end(void);
+
+/** @} */
+
 #ifdef __cplusplus
 }
 #endif
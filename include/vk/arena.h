@@ -0,0 +1,126 @@
+/**
+ * @file include/vk/arena.h
+ * @brief Chunked bump arena for short-lived Vulkan host allocations.
+ *
+ * An arena carves allocations out of fixed-size chunks by bumping a cursor.
+ * Each chunk counts its live allocations; when the count drops to zero the
+ * whole chunk is reset in bulk and recycled. No per-allocation metadata is
+ * tracked, which makes the arena suitable for COMMAND and OBJECT scoped
+ * driver allocations whose lifetimes cluster around a single Vulkan object.
+ *
+ * Chunk storage is obtained from a PageAllocator, so destroying the owning
+ * PageAllocator also releases any chunks still held by the arena.
+ */
+
+#ifndef VKC_ARENA_H
+#define VKC_ARENA_H
+
+#include "allocator/page.h"
+
+#include <pthread.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief Default number of usable bytes per arena chunk.
+ */
+#define VKC_ARENA_CHUNK_SIZE (64 * 1024)
+
+/**
+ * @brief Maximum number of drained chunks retained for reuse.
+ *
+ * Chunks drained beyond this limit are returned to the PageAllocator.
+ */
+#define VKC_ARENA_FREE_LIMIT 4
+
+/**
+ * @brief A single bump allocated region of an arena.
+ */
+typedef struct VkcArenaChunk {
+    struct VkcArenaChunk* next; /**< Next chunk in the arena free list. */
+    size_t capacity; /**< Number of usable bytes following the chunk header. */
+    size_t offset; /**< Bump cursor relative to the start of the chunk data. */
+    size_t live; /**< Number of allocations not yet released. */
+} VkcArenaChunk;
+
+/**
+ * @brief Thread-safe chunked bump arena.
+ */
+typedef struct VkcArena {
+    PageAllocator* pager; /**< Backing allocator for chunk storage. */
+    VkcArenaChunk* current; /**< Chunk currently serving bump allocations. */
+    VkcArenaChunk* free; /**< Drained chunks ready for reuse. */
+    size_t free_count; /**< Number of chunks in the free list. */
+    size_t chunk_size; /**< Number of usable bytes per chunk. */
+    pthread_mutex_t mutex; /**< Guards the chunk lists and cursors. */
+} VkcArena;
+
+/**
+ * @brief Create an arena backed by the given PageAllocator.
+ *
+ * @param pager      Allocator used for the arena and its chunks.
+ * @param chunk_size Usable bytes per chunk, or 0 for VKC_ARENA_CHUNK_SIZE.
+ * @return Allocated arena, or NULL on failure.
+ */
+VkcArena* vkc_arena_create(PageAllocator* pager, size_t chunk_size);
+
+/**
+ * @brief Destroy an arena and return all of its chunks to the PageAllocator.
+ *
+ * Any allocations still outstanding become invalid.
+ *
+ * @param arena Pointer returned by vkc_arena_create().
+ */
+void vkc_arena_free(VkcArena* arena);
+
+/**
+ * @brief Bump allocate a region from the arena.
+ *
+ * Requests that cannot fit into a single chunk are rejected so the caller can
+ * fall back to a general purpose allocator.
+ *
+ * @param arena     Arena to allocate from.
+ * @param size      Number of bytes to allocate.
+ * @param alignment Power of two alignment of the returned address.
+ * @param chunk     Receives the chunk owning the allocation.
+ * @return Aligned address, or NULL if the request does not fit a chunk.
+ */
+void* vkc_arena_malloc(VkcArena* arena, size_t size, size_t alignment, VkcArenaChunk** chunk);
+
+/**
+ * @brief Resize an allocation without moving it.
+ *
+ * Shrinking always succeeds. Growing succeeds only when the allocation is the
+ * most recent bump of its chunk and the chunk has room behind it.
+ *
+ * @param arena    Arena that produced the allocation.
+ * @param chunk    Chunk returned alongside the allocation.
+ * @param address  Address returned by vkc_arena_malloc().
+ * @param size     Current size of the allocation in bytes.
+ * @param new_size Requested size in bytes.
+ * @return true if the allocation now spans new_size bytes.
+ */
+bool vkc_arena_resize(
+    VkcArena* arena, VkcArenaChunk* chunk, void* address, size_t size, size_t new_size
+);
+
+/**
+ * @brief Release one allocation owned by the given chunk.
+ *
+ * When the last live allocation of a chunk is released, the chunk is reset
+ * in bulk and becomes available for reuse.
+ *
+ * @param arena Arena that produced the allocation.
+ * @param chunk Chunk returned alongside the allocation.
+ */
+void vkc_arena_release(VkcArena* arena, VkcArenaChunk* chunk);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // VKC_ARENA_H
@@ -0,0 +1,189 @@
+/**
+ * @file include/vk/batcher.h
+ * @brief Coalesce many small dispatches into one queue submission.
+ *
+ * Every vkQueueSubmit has a fixed driver and kernel cost that dominates when
+ * the dispatches themselves are tiny. A VkcBatcher records dispatches from any
+ * number of callers into one command buffer and submits the batch as a whole
+ * once it holds max_dispatches dispatches, once window_ns has passed since its
+ * first dispatch, or when a caller flushes or waits on it.
+ *
+ * Each dispatch returns a ticket naming its batch. Tickets increase in
+ * dispatch order and completing ticket N implies every earlier ticket is
+ * complete, as with VkcQueue. Waiting on a ticket whose batch is still being
+ * recorded submits that batch early rather than sitting out the window.
+ *
+ * A batch whose submission failed never completes: polling or waiting on its
+ * ticket returns false, even after its command buffer has been reused. Each
+ * command buffer remembers only its newest failure, so an older failed ticket
+ * reads as complete once a later batch on the same buffer fails too.
+ *
+ * The batcher keeps depth command buffers, so callers keep recording into a
+ * new batch while earlier ones execute. Opening a batch on a command buffer
+ * that is still in flight blocks the opening caller until its submission
+ * completes; other callers and the flusher keep running meanwhile.
+ *
+ * Dispatches in a batch run in recording order but may overlap unless
+ * serialize is set, which places a compute-to-compute barrier between them.
+ * Every batch ends with a barrier that makes its shader writes visible to
+ * later submissions and to the host.
+ *
+ * A VkcBatcher is thread-safe.
+ */
+
+#ifndef VKC_BATCHER_H
+#define VKC_BATCHER_H
+
+#include "allocator/page.h"
+#include "vk/queue.h"
+#include <vulkan/vulkan.h>
+
+#include <pthread.h>
+#include <stdbool.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief Upper bound on the batches in flight.
+ */
+#define VKC_BATCHER_DEPTH_MAX 8
+
+/**
+ * @brief Upper bound on the descriptor sets of a single dispatch.
+ */
+#define VKC_BATCHER_SETS_MAX 4
+
+/**
+ * @brief One dispatch to add to a batch.
+ */
+typedef struct VkcBatchDispatch {
+    VkPipeline pipeline; /**< Compute pipeline to dispatch. */
+    VkPipelineLayout layout; /**< Layout of pipeline. */
+    const VkDescriptorSet* sets; /**< Sets bound from set 0, or NULL. */
+    uint32_t set_count; /**< Number of sets, up to VKC_BATCHER_SETS_MAX. */
+    const void* push_data; /**< Push constants, or NULL. */
+    uint32_t push_size; /**< Bytes of push constants. */
+    uint32_t x; /**< Workgroups along x. */
+    uint32_t y; /**< Workgroups along y. */
+    uint32_t z; /**< Workgroups along z. */
+} VkcBatchDispatch;
+
+/**
+ * @brief When and how batches are submitted.
+ */
+typedef struct VkcBatcherInfo {
+    uint32_t max_dispatches; /**< Submit once a batch holds this many dispatches. */
+    uint64_t window_ns; /**< Submit this long after a batch opens, 0 to disable. */
+    uint32_t depth; /**< Batches in flight, 1 to VKC_BATCHER_DEPTH_MAX. */
+    bool serialize; /**< Insert a barrier between dispatches of a batch. */
+} VkcBatcherInfo;
+
+/**
+ * @brief Life cycle of a batch command buffer.
+ */
+typedef enum VkcBatchState {
+    VKC_BATCH_FREE, /**< Not recording: unused, retired, or failed. */
+    VKC_BATCH_RECORDING, /**< Accepting dispatches. */
+    VKC_BATCH_SUBMITTED, /**< Submitted with ticket. */
+} VkcBatchState;
+
+/**
+ * @brief One command buffer of the batcher.
+ */
+typedef struct VkcBatch {
+    VkCommandBuffer command; /**< Dispatches of the batch. */
+    VkcBatchState state; /**< Where the batch is in its life cycle. */
+    VkPipeline pipeline; /**< Pipeline last bound, to skip redundant binds. */
+    uint32_t count; /**< Dispatches recorded. */
+    uint64_t serial; /**< Ticket handed to the batch's dispatches. */
+    uint64_t ticket; /**< Queue ticket once submitted. */
+    uint64_t failed; /**< Serial of the newest batch in this slot that failed, or 0. */
+    uint64_t opened; /**< Monotonic time of the first dispatch in nanoseconds. */
+} VkcBatch;
+
+/**
+ * @brief Records dispatches from many callers into shared submissions.
+ */
+typedef struct VkcBatcher {
+    PageAllocator* pager; /**< Host allocator for the batcher structure. */
+    VkcQueue* queue; /**< Queue batches are submitted to. */
+    VkCommandPool command_pool; /**< Pool of the batch command buffers. */
+    VkcBatch batches[VKC_BATCHER_DEPTH_MAX]; /**< Batches in round-robin order. */
+    uint32_t depth; /**< Number of batches. */
+    uint32_t max_dispatches; /**< Count threshold. */
+    uint64_t window_ns; /**< Latency window, 0 if disabled. */
+    bool serialize; /**< Barrier between dispatches. */
+    uint64_t serial; /**< Ticket of the most recently opened batch. */
+    uint64_t dispatched; /**< Dispatches recorded so far. */
+    uint64_t submitted; /**< Batches submitted so far. */
+    bool running; /**< Cleared to stop the flusher thread. */
+    pthread_t flusher; /**< Submits batches whose window expired. */
+    pthread_mutex_t mutex; /**< Guards the batches and counters. */
+    pthread_cond_t opened; /**< Signaled when a batch opens or the batcher stops. */
+} VkcBatcher;
+
+/**
+ * @brief Create a batcher on a queue.
+ *
+ * Starts a flusher thread if the latency window is enabled.
+ *
+ * @param queue Queue to submit to; command buffers are allocated from its
+ *              family, and its pager and callbacks are used for the batcher.
+ * @param info  Thresholds and depth.
+ * @return Allocated batcher, or NULL on failure.
+ */
+VkcBatcher* vkc_batcher_create(VkcQueue* queue, const VkcBatcherInfo* info);
+
+/**
+ * @brief Submit the open batch, wait for every batch, and destroy the batcher.
+ *
+ * @param batcher Pointer returned by vkc_batcher_create().
+ */
+void vkc_batcher_free(VkcBatcher* batcher);
+
+/**
+ * @brief Record a dispatch into the open batch.
+ *
+ * Opens a batch if none is recording and submits it if the dispatch reaches
+ * the count threshold. Arrays are read during the call only.
+ *
+ * @param batcher  Batcher to record into.
+ * @param dispatch Pipeline, bindings, and workgroup counts.
+ * @return Ticket of the dispatch, or 0 on failure.
+ */
+uint64_t vkc_batcher_dispatch(VkcBatcher* batcher, const VkcBatchDispatch* dispatch);
+
+/**
+ * @brief Submit the open batch now, if there is one.
+ *
+ * @return false if the submission failed.
+ */
+bool vkc_batcher_flush(VkcBatcher* batcher);
+
+/**
+ * @brief Check whether a ticket has completed without blocking or flushing.
+ *
+ * @return true if the ticket completed, false if it is pending or failed.
+ */
+bool vkc_batcher_poll(VkcBatcher* batcher, uint64_t ticket);
+
+/**
+ * @brief Block until a ticket completes or the timeout expires.
+ *
+ * Submits the ticket's batch first if it is still recording.
+ *
+ * @param batcher Batcher the ticket was issued by.
+ * @param ticket  Ticket returned by vkc_batcher_dispatch().
+ * @param timeout Timeout in nanoseconds, UINT64_MAX to wait forever.
+ * @return true if the ticket completed, false on timeout or error.
+ */
+bool vkc_batcher_wait(VkcBatcher* batcher, uint64_t ticket, uint64_t timeout);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // VKC_BATCHER_H
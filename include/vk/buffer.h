@@ -0,0 +1,236 @@
+/**
+ * @file include/vk/buffer.h
+ * @brief Vulkan buffers bound to pooled device memory.
+ *
+ * A VkcBuffer pairs a VkBuffer with a sub-allocation from a VkcMemoryPool, so
+ * creating and destroying buffers costs a bitmap update instead of a
+ * vkAllocateMemory/vkFreeMemory round trip.
+ *
+ * Buffers created with VKC_BUFFER_MAPPED_BIT expose a host pointer that stays
+ * valid for their whole lifetime, so transfers never call vkMapMemory.
+ *
+ * vkc_buffer_import() wraps an application array in a buffer without copying
+ * it when the device supports VK_EXT_external_memory_host, and falls back to
+ * a mapped copy when it does not.
+ *
+ * A VkcBufferPool goes one step further and recycles whole buffers. Released
+ * buffers are cached by power of two size class, usage, intent, and flags, so
+ * a job that acquires the same shapes as the last one makes no Vulkan calls at
+ * all. Cached bytes are capped, and the least recently released buffers are
+ * trimmed first when the cap is reached or device memory runs out.
+ */
+
+#ifndef VKC_BUFFER_H
+#define VKC_BUFFER_H
+
+#include "allocator/page.h"
+#include "vk/memory.h"
+#include <vulkan/vulkan.h>
+
+#include <pthread.h>
+#include <stdbool.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief Buffer creation flags.
+ */
+typedef enum VkcBufferFlagBits {
+    VKC_BUFFER_MAPPED_BIT = 0x1, /**< Persistently map host-visible memory. */
+    VKC_BUFFER_IMPORTED_BIT = 0x2, /**< Memory is the caller's host allocation; set on import. */
+} VkcBufferFlagBits;
+
+typedef uint32_t VkcBufferFlags;
+
+/**
+ * @brief A buffer and the memory bound to it.
+ */
+typedef struct VkcBuffer {
+    VkBuffer object; /**< Vulkan buffer handle. */
+    VkcMemoryPool* pool; /**< Pool the memory came from. */
+    VkcMemoryAllocation allocation; /**< Memory bound to the buffer. */
+    void* mapped; /**< Persistent host pointer, or NULL if not mapped. */
+    VkDeviceSize size; /**< Requested size in bytes. */
+    VkBufferUsageFlags usage; /**< Usage the buffer was created with. */
+    VkcMemoryIntent intent; /**< Access pattern the memory was chosen for. */
+    VkcBufferFlags flags; /**< Flags the buffer was created with. */
+} VkcBuffer;
+
+/**
+ * @brief Create an exclusive buffer and bind pooled memory to it.
+ *
+ * GPU_ONLY buffers that do not fit in the preferred heap, e.g. because VRAM is
+ * over budget, spill to the best type of another heap; check
+ * allocation.flags for DEVICE_LOCAL to tell.
+ *
+ * @param pool       Pool to allocate memory from.
+ * @param size       Buffer size in bytes.
+ * @param usage      Buffer usage flags.
+ * @param intent     Access pattern used to pick the memory type.
+ * @param flags      VkcBufferFlagBits. Mapping requires a host intent.
+ * @return Allocated buffer, or NULL on failure.
+ */
+VkcBuffer* vkc_buffer_create(
+    VkcMemoryPool* pool,
+    VkDeviceSize size,
+    VkBufferUsageFlags usage,
+    VkcMemoryIntent intent,
+    VkcBufferFlags flags
+);
+
+/**
+ * @brief Wrap a host allocation in a buffer, zero-copy when possible.
+ *
+ * When the pool has VKC_MEMORY_POOL_HOST_IMPORT_BIT and host and size are
+ * multiples of the pool's import_alignment, e.g. memory from
+ * vkc_allocator_host_malloc() rounded up to whole pages, the buffer is bound
+ * to the host memory itself: mapped equals host, VKC_BUFFER_IMPORTED_BIT is
+ * set, and host and device see each other's writes without a copy. The host
+ * memory must outlive the buffer.
+ *
+ * Otherwise the buffer is created with VKC_BUFFER_MAPPED_BIT, the contents of
+ * host are copied into it and flushed, and later exchanges go through mapped.
+ *
+ * @param pool   Pool to allocate or account memory with.
+ * @param host   Host data to wrap.
+ * @param size   Size of the host data in bytes.
+ * @param usage  Buffer usage flags.
+ * @param intent Host intent used to pick the memory type.
+ * @return Allocated buffer, or NULL on failure.
+ */
+VkcBuffer* vkc_buffer_import(
+    VkcMemoryPool* pool,
+    void* host,
+    VkDeviceSize size,
+    VkBufferUsageFlags usage,
+    VkcMemoryIntent intent
+);
+
+/**
+ * @brief Destroy a buffer and return its memory to the pool.
+ *
+ * The host memory of an imported buffer is left alone.
+ *
+ * @param buffer Pointer returned by vkc_buffer_create() or vkc_buffer_import().
+ */
+void vkc_buffer_free(VkcBuffer* buffer);
+
+/**
+ * @brief Queue host writes to a mapped buffer for the next submission.
+ *
+ * No-op for coherent memory. Submit the batch before vkQueueSubmit.
+ */
+bool vkc_buffer_flush(
+    VkcBuffer* buffer, VkcMemoryBatch* batch, VkDeviceSize offset, VkDeviceSize size
+);
+
+/**
+ * @brief Queue a mapped buffer range to be made visible to the host.
+ *
+ * No-op for coherent memory. Submit the batch after the submission completes.
+ */
+bool vkc_buffer_invalidate(
+    VkcBuffer* buffer, VkcMemoryBatch* batch, VkDeviceSize offset, VkDeviceSize size
+);
+
+/**
+ * @brief Log2 of the smallest size class of a buffer pool.
+ */
+#define VKC_BUFFER_POOL_MIN_ORDER 8
+
+/**
+ * @brief Number of size classes of a buffer pool, from 256 bytes up.
+ */
+#define VKC_BUFFER_POOL_CLASSES 48
+
+/**
+ * @brief A released buffer waiting to be reused.
+ */
+typedef struct VkcBufferPoolEntry {
+    struct VkcBufferPoolEntry* next; /**< Older entry of the same class. */
+    struct VkcBufferPoolEntry* prev; /**< Newer entry of the same class. */
+    VkcBuffer* buffer; /**< Cached buffer. */
+    uint64_t tick; /**< Release order, used to trim the oldest entries first. */
+} VkcBufferPoolEntry;
+
+/**
+ * @brief Thread-safe cache of released buffers.
+ */
+typedef struct VkcBufferPool {
+    PageAllocator* pager; /**< Host allocator for the pool and its entries. */
+    VkcMemoryPool* memory; /**< Pool new buffers are allocated from. */
+    VkcBufferPoolEntry* head[VKC_BUFFER_POOL_CLASSES]; /**< Newest entry of each class. */
+    VkcBufferPoolEntry* tail[VKC_BUFFER_POOL_CLASSES]; /**< Oldest entry of each class. */
+    VkcBufferPoolEntry* spare; /**< Unused entries kept for reuse. */
+    VkDeviceSize cached; /**< Bytes held by cached buffers. */
+    VkDeviceSize limit; /**< Most bytes to keep cached. */
+    uint64_t tick; /**< Release counter. */
+    uint64_t hits; /**< Acquisitions served from the cache. */
+    uint64_t misses; /**< Acquisitions that created a buffer. */
+    pthread_mutex_t mutex; /**< Guards the entry lists and counters. */
+} VkcBufferPool;
+
+/**
+ * @brief Create an empty buffer pool.
+ *
+ * @param memory Pool to allocate new buffers from; must outlive the buffer pool.
+ * @param limit  Most bytes to keep cached, or 0 for no limit.
+ * @return Allocated pool, or NULL on failure.
+ */
+VkcBufferPool* vkc_buffer_pool_create(VkcMemoryPool* memory, VkDeviceSize limit);
+
+/**
+ * @brief Destroy every cached buffer and the pool.
+ *
+ * Buffers still acquired are not tracked and must be freed by their holders.
+ *
+ * @param pool Pointer returned by vkc_buffer_pool_create().
+ */
+void vkc_buffer_pool_free(VkcBufferPool* pool);
+
+/**
+ * @brief Get a buffer of at least size bytes.
+ *
+ * The size is rounded up to its class, and the returned buffer's size is the
+ * class size. A cached buffer with the same class, usage, intent, and flags is
+ * reused if there is one; otherwise a new one is created, trimming the cache
+ * and retrying once if device memory is exhausted.
+ *
+ * @return Buffer to release with vkc_buffer_pool_release(), or NULL on failure.
+ */
+VkcBuffer* vkc_buffer_pool_acquire(
+    VkcBufferPool* pool,
+    VkDeviceSize size,
+    VkBufferUsageFlags usage,
+    VkcMemoryIntent intent,
+    VkcBufferFlags flags
+);
+
+/**
+ * @brief Return a buffer to the cache.
+ *
+ * The device must be done with the buffer, i.e. the last submission using it
+ * has retired. Buffers not created by the pool, including imported ones, are
+ * freed instead.
+ *
+ * @param pool   Pool the buffer was acquired from.
+ * @param buffer Buffer to release.
+ */
+void vkc_buffer_pool_release(VkcBufferPool* pool, VkcBuffer* buffer);
+
+/**
+ * @brief Free the oldest cached buffers until at most keep bytes remain.
+ *
+ * @param pool Pool to trim.
+ * @param keep Bytes to leave cached; 0 empties the cache.
+ */
+void vkc_buffer_pool_trim(VkcBufferPool* pool, VkDeviceSize keep);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // VKC_BUFFER_H
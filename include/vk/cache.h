@@ -0,0 +1,167 @@
+/**
+ * @file include/vk/cache.h
+ * @brief Per-thread allocation caches for the Vulkan host allocator.
+ *
+ * Each thread that allocates through the VkC callbacks owns a VkcThreadCache.
+ * A cache holds one magazine (a bounded LIFO free list) per size class plus
+ * its own COMMAND and OBJECT scope arenas. Magazine hits and pushes take no
+ * lock at all. Scope arena requests still take the arena's mutex, but the
+ * arena belongs to one thread, so it is contended only when another thread
+ * frees into it. Magazine refills from the shared slabs and misses that fall
+ * through to the PageAllocator take the shared locks.
+ *
+ * Blocks freed by a thread other than their owner are pushed onto the owner's
+ * remote list with a single compare-and-swap. The owner collects the whole
+ * list with one atomic exchange, so the remote path is lock-free and immune
+ * to ABA.
+ */
+
+#ifndef VKC_CACHE_H
+#define VKC_CACHE_H
+
+#include "allocator/page.h"
+#include "vk/allocator.h"
+#include "vk/arena.h"
+
+#include <stdatomic.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief Number of power of two size classes, from 16 bytes to 2 KiB.
+ */
+#define VKC_CACHE_CLASS_COUNT 8
+
+/**
+ * @brief Smallest size class in bytes.
+ */
+#define VKC_CACHE_CLASS_MIN 16
+
+/**
+ * @brief Maximum number of blocks held by a single magazine.
+ */
+#define VKC_CACHE_MAGAZINE_SIZE 128
+
+/**
+ * @brief Sentinel returned by vkc_thread_cache_class() for uncached sizes.
+ */
+#define VKC_CACHE_CLASS_NONE UINT32_MAX
+
+/**
+ * @brief Intrusive free list link stored inside a cached block.
+ */
+typedef struct VkcCacheNode {
+    struct VkcCacheNode* next; /**< Next free block. */
+} VkcCacheNode;
+
+/**
+ * @brief Bounded LIFO free list for a single size class.
+ */
+typedef struct VkcCacheMagazine {
+    VkcCacheNode* head; /**< Most recently freed block. */
+    uint32_t count; /**< Number of blocks in the magazine. */
+} VkcCacheMagazine;
+
+/**
+ * @brief Statistics counters written only by the thread owning the cache.
+ */
+typedef struct VkcCacheStats {
+    atomic_int_fast64_t pending; /**< Live byte delta not yet folded into the totals. */
+    atomic_int_fast64_t internal_pending; /**< Internal byte delta not yet folded. */
+    atomic_uint_fast64_t allocations; /**< Number of allocations. */
+    atomic_uint_fast64_t reallocations; /**< Number of reallocations. */
+    atomic_uint_fast64_t frees; /**< Number of frees. */
+    atomic_uint_fast64_t internal_allocations; /**< Number of internal allocation notices. */
+    atomic_uint_fast64_t histogram[VKC_ALLOCATOR_HISTOGRAM_BINS]; /**< Request sizes. */
+} VkcCacheStats;
+
+/**
+ * @brief Allocation cache owned by a single thread.
+ */
+typedef struct VkcThreadCache {
+    VkcCacheMagazine magazines[VKC_CACHE_CLASS_COUNT]; /**< Local free lists. */
+    VkcCacheStats stats[VKC_ALLOCATOR_SCOPE_COUNT]; /**< Counters per allocation scope. */
+    VkcArena* arenas[2]; /**< COMMAND and OBJECT scope arenas. */
+    _Atomic(VkcCacheNode*) remote; /**< Blocks freed by other threads. */
+    atomic_bool active; /**< False once the owning thread has exited. */
+    struct VkcThreadCache* next; /**< Registry link. */
+} VkcThreadCache;
+
+/**
+ * @brief Map a request onto a cached size class.
+ *
+ * @param size      Number of bytes requested.
+ * @param alignment Requested alignment.
+ * @return Size class index, or VKC_CACHE_CLASS_NONE if the request is not cacheable.
+ */
+uint32_t vkc_thread_cache_class(size_t size, size_t alignment);
+
+/**
+ * @brief Get the number of usable bytes of a size class.
+ */
+size_t vkc_thread_cache_class_size(uint32_t size_class);
+
+/**
+ * @brief Create a thread cache with its own scope arenas.
+ *
+ * @param pager Allocator used for the cache structure and arena chunks.
+ * @return Allocated cache, or NULL on failure.
+ */
+VkcThreadCache* vkc_thread_cache_create(PageAllocator* pager);
+
+/**
+ * @brief Destroy a thread cache and its arenas.
+ *
+ * Cached blocks are not released individually; they belong to the
+ * PageAllocator and are reclaimed when it is freed.
+ *
+ * @param cache Pointer returned by vkc_thread_cache_create().
+ * @param pager Allocator the cache was created with.
+ */
+void vkc_thread_cache_free(VkcThreadCache* cache, PageAllocator* pager);
+
+/**
+ * @brief Pop a free block of the given size class.
+ *
+ * Only the owning thread may call this.
+ *
+ * @return Cached block, or NULL if the magazine is empty.
+ */
+void* vkc_thread_cache_pop(VkcThreadCache* cache, uint32_t size_class);
+
+/**
+ * @brief Push a free block onto the magazine of its size class.
+ *
+ * Only the owning thread may call this.
+ *
+ * @return false if the magazine is full and the block was not cached.
+ */
+bool vkc_thread_cache_push(VkcThreadCache* cache, uint32_t size_class, void* pointer);
+
+/**
+ * @brief Return a block to its owning cache from any thread.
+ *
+ * @param owner   Cache that allocated the block.
+ * @param pointer Block to return.
+ */
+void vkc_thread_cache_push_remote(VkcThreadCache* owner, void* pointer);
+
+/**
+ * @brief Detach every block returned by other threads.
+ *
+ * Only the owning thread may call this.
+ *
+ * @return Singly linked list of returned blocks, or NULL if there are none.
+ */
+VkcCacheNode* vkc_thread_cache_collect(VkcThreadCache* cache);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // VKC_CACHE_H
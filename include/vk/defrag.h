@@ -0,0 +1,151 @@
+/**
+ * @file include/vk/defrag.h
+ * @brief Incremental defragmentation of pooled buffer memory.
+ *
+ * Long-running processes leave VkcMemoryPool blocks sparsely populated: the
+ * total free space is ample, but no single block has a node large enough for
+ * a big request, and none is empty enough to release. A VkcDefrag compacts
+ * them a bounded amount at a time, moving the buffers of the emptiest blocks
+ * into the fullest ones until the emptiest blocks drain and are released.
+ *
+ * Vulkan memory bindings are immutable, so a move creates a new VkBuffer bound
+ * to the new node and swaps it into the VkcBuffer. Host-visible buffers are
+ * copied with memcpy right away; device-local buffers are copied with
+ * vkCmdCopyBuffer and keep their old buffer and node alive until the commit
+ * that carries the copy retires. Buffers that are neither host-visible nor
+ * created with TRANSFER_SRC and TRANSFER_DST usage are left alone.
+ *
+ * Run a step only while no submission references the registered buffers, and
+ * rewrite any descriptor that points at a moved buffer before its next use;
+ * the optional move callback is the place to do it.
+ */
+
+#ifndef VKC_DEFRAG_H
+#define VKC_DEFRAG_H
+
+#include "allocator/page.h"
+#include "vk/memory.h"
+#include "vk/buffer.h"
+#include "vk/sync.h"
+#include <vulkan/vulkan.h>
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief Number of buffers and pending moves reserved when a defragmenter is created.
+ */
+#define VKC_DEFRAG_CAPACITY 64
+
+/**
+ * @brief Called after a buffer has been given a new VkBuffer and memory.
+ *
+ * @param buffer   Moved buffer; object, allocation, and mapped are updated.
+ * @param previous VkBuffer the buffer had before the move.
+ * @param user     Argument passed to vkc_defrag_create().
+ */
+typedef void (*VkcDefragMoved)(VkcBuffer* buffer, VkBuffer previous, void* user);
+
+/**
+ * @brief An old buffer and node waiting for a device copy to complete.
+ */
+typedef struct VkcDefragRetired {
+    VkBuffer object; /**< Old buffer, the copy source. */
+    VkcMemoryAllocation allocation; /**< Old node, released with the buffer. */
+    VkcSyncPoint point; /**< Signaled when the copy completes. */
+    bool committed; /**< True once point is set. */
+} VkcDefragRetired;
+
+/**
+ * @brief Incremental compactor for the buffers of one memory pool.
+ */
+typedef struct VkcDefrag {
+    PageAllocator* pager; /**< Host allocator for the arrays. */
+    VkcMemoryPool* pool; /**< Pool the registered buffers were allocated from. */
+    VkcBuffer** buffers; /**< Registered buffers. */
+    size_t count; /**< Number of registered buffers. */
+    size_t capacity; /**< Number of buffers the array can hold. */
+    VkcDefragRetired* retired; /**< Old buffers of device copies, oldest first. */
+    size_t retired_count; /**< Number of pending old buffers. */
+    size_t retired_capacity; /**< Number of old buffers the array can hold. */
+    VkcDefragMoved moved; /**< Move callback, or NULL. */
+    void* user; /**< Argument passed to the move callback. */
+    VkDeviceSize bytes_moved; /**< Total bytes moved over the defragmenter's life. */
+} VkcDefrag;
+
+/**
+ * @brief Create a defragmenter.
+ *
+ * @param pool  Pool whose buffers are compacted.
+ * @param moved Called for every moved buffer, or NULL.
+ * @param user  Argument passed to moved.
+ * @return Allocated defragmenter, or NULL on failure.
+ */
+VkcDefrag* vkc_defrag_create(VkcMemoryPool* pool, VkcDefragMoved moved, void* user);
+
+/**
+ * @brief Destroy a defragmenter.
+ *
+ * Waits for pending copies, then releases their old buffers. Registered
+ * buffers are not freed.
+ *
+ * @param defrag Pointer returned by vkc_defrag_create().
+ */
+void vkc_defrag_free(VkcDefrag* defrag);
+
+/**
+ * @brief Allow a buffer to be moved.
+ *
+ * @return true on success, false if the buffer is not movable or on
+ *         allocation failure.
+ */
+bool vkc_defrag_add(VkcDefrag* defrag, VkcBuffer* buffer);
+
+/**
+ * @brief Stop tracking a buffer, e.g. before freeing it.
+ */
+void vkc_defrag_remove(VkcDefrag* defrag, VkcBuffer* buffer);
+
+/**
+ * @brief Move buffers out of the emptiest blocks, up to a byte budget.
+ *
+ * Buffers are visited from the least to the most occupied block, and each is
+ * moved only if a denser block has room for it. Device copies are recorded
+ * into command, followed by a barrier that makes them visible to later
+ * commands. Commit them with vkc_defrag_commit() before submitting.
+ *
+ * @param defrag    Defragmenter to step.
+ * @param command   Command buffer in the recording state, or NULL to move
+ *                  host-visible buffers only.
+ * @param max_bytes Most bytes to move in this step.
+ * @return Number of buffers moved.
+ */
+uint32_t vkc_defrag_step(VkcDefrag* defrag, VkCommandBuffer command, VkDeviceSize max_bytes);
+
+/**
+ * @brief Tag the device copies recorded since the last commit.
+ *
+ * @param defrag Defragmenter to commit.
+ * @param point  Fence or timeline value signaled by the submission.
+ */
+void vkc_defrag_commit(VkcDefrag* defrag, VkcSyncPoint point);
+
+/**
+ * @brief Release the old buffers of every completed copy.
+ *
+ * Blocks they leave empty are returned to the device.
+ *
+ * @return Number of copies still pending.
+ */
+size_t vkc_defrag_reclaim(VkcDefrag* defrag);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // VKC_DEFRAG_H
@@ -14,6 +14,7 @@
 #define VKC_DEVICE_H
 
 #include "allocator/page.h"
+#include "vk/allocator.h"
 #include "vk/instance.h"
 #include <vulkan/vulkan.h>
 
@@ -49,6 +50,37 @@ typedef struct VkcDeviceQueueFamily {
 VkcDeviceQueueFamily* vkc_device_queue_family_create(VkPhysicalDevice device);
 void vkc_device_queue_family_free(VkcDeviceQueueFamily* family);
 
+// Index of a family with transfer but neither graphics nor compute, or UINT32_MAX.
+uint32_t vkc_device_queue_family_transfer(const VkcDeviceQueueFamily* family);
+
+/** @} */
+
+/**
+ * @defgroup DeviceQueueRequest Device Queue Requests
+ * @brief Every queue of every family supporting a set of capabilities.
+ *
+ * Families without graphics come first, since they usually map to separate
+ * hardware engines. The infos are passed to VkDeviceCreateInfo as is.
+ *
+ * A dedicated transfer family (a DMA engine on discrete GPUs) can be added
+ * with one queue. It is not counted in queue_count, and transfer_family is
+ * UINT32_MAX when the device has none, as on lavapipe.
+ * @{
+ */
+
+typedef struct VkcDeviceQueueRequest {
+    VkDeviceQueueCreateInfo* infos;
+    float* priorities;
+    uint32_t count;
+    uint32_t queue_count;
+    uint32_t transfer_family;
+} VkcDeviceQueueRequest;
+
+VkcDeviceQueueRequest* vkc_device_queue_request_create(VkPhysicalDevice device, VkQueueFlags flags);
+void vkc_device_queue_request_free(VkcDeviceQueueRequest* request);
+uint32_t vkc_device_queue_request_add_transfer(
+    VkcDeviceQueueRequest* request, VkPhysicalDevice device);
+
 /** @} */
 
 /**
@@ -59,6 +91,7 @@ void vkc_device_queue_family_free(VkcDeviceQueueFamily* family);
 typedef struct VkcPhysicalDevice {
     VkPhysicalDevice object;
     uint32_t queue_family_index;
+    uint32_t transfer_family_index; // Dedicated transfer family, else queue_family_index
 } VkcPhysicalDevice;
 
 VkcPhysicalDevice* vkc_device_physical_create(VkcDeviceList* list);
@@ -135,10 +168,25 @@ void vkc_device_extension_match_free(VkcDeviceExtensionMatch* match);
 
 typedef struct VkcDevice {
     VkDevice object;
-    VkAllocationCallbacks callbacks;
+    VkPhysicalDevice physical;
+    VkcAllocatorContext* context; // Owns the wrapper and the callbacks
+    const VkAllocationCallbacks* callbacks;
 } VkcDevice;
 
-VkcDevice* vkc_device_create(VkcInstance* instance);
+// Create a logical device with the context's callbacks, or the global
+// context's when context is NULL. The context must outlive the device, and
+// objects created on it may use any context's callbacks.
+//
+// features is the VkDeviceCreateInfo pNext chain, e.g. a
+// VkPhysicalDeviceFeatures2, and must enable timelineSemaphore for VkcQueue.
+// When NULL, timelineSemaphore is enabled if the device supports it.
+VkcDevice* vkc_device_create(
+    VkcAllocatorContext* context,
+    const VkcPhysicalDevice* physical,
+    const VkcDeviceQueueRequest* request,
+    const VkcDeviceLayerMatch* layer_match,
+    const VkcDeviceExtensionMatch* extension_match,
+    const void* features);
 void vkc_device_destroy(VkcDevice* device);
 
 /** @} */
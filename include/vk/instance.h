@@ -15,6 +15,7 @@
 #define VKC_INSTANCE_H
 
 #include "allocator/page.h"
+#include "vk/allocator.h"
 #include <vulkan/vulkan.h>
 
 #ifdef __cplusplus
@@ -167,18 +168,25 @@ void vkc_instance_extension_match_free(VkcInstanceExtensionMatch* match);
  */
 typedef struct VkcInstance {
     VkInstance object; /**< Vulkan instance handle. */
+    VkcAllocatorContext* context; /**< Context owning the wrapper and the callbacks. */
     const VkAllocationCallbacks* callbacks; /**< Allocator callbacks used for Vulkan object creation. */
 } VkcInstance;
 
 /**
  * @brief Create a Vulkan instance with the specified enabled layers and extensions.
  *
+ * The instance is created and destroyed with the context's callbacks, and the
+ * context must outlive it.
+ *
+ * @param context         Allocation context, or NULL for the global context.
  * @param layer_match     Optional matched layer list (may be NULL).
  * @param extension_match Optional matched extension list (may be NULL).
  * @return Allocated Vulkan instance wrapper, or NULL on failure.
  */
 VkcInstance* vkc_instance_create(
-    VkcInstanceLayerMatch* layer_match, VkcInstanceExtensionMatch* extension_match);
+    VkcAllocatorContext* context,
+    VkcInstanceLayerMatch* layer_match,
+    VkcInstanceExtensionMatch* extension_match);
 
 /**
  * @brief Destroy a Vulkan instance and free associated tracked memory.
@@ -0,0 +1,160 @@
+/**
+ * @file include/vk/job.h
+ * @brief Compute dispatches recorded once and submitted many times.
+ *
+ * A VkcRecordedJob records a dispatch sequence (bind pipeline, push constants,
+ * bind descriptor sets, dispatch) a single time and replays it on every
+ * submit, so a kernel that runs on fresh inputs over and over pays for
+ * command recording only once.
+ *
+ * What changes between calls never lives in the command buffer:
+ *
+ *   - the workgroup count is read from a mapped indirect buffer by
+ *     vkCmdDispatchIndirect, and
+ *   - per-call parameters are written to a mapped uniform or storage buffer
+ *     bound as the set after the job's stable sets.
+ *
+ * Push constants are recorded with the commands and therefore stay fixed for
+ * the life of the job; use them for configuration, not data.
+ *
+ * The job keeps several frames, each with its own command buffer, indirect
+ * buffer, and parameter buffer, so a new call can be written while earlier
+ * ones are still executing. A frame is reused only once its last ticket has
+ * completed. The stable sets are shared by every frame; the caller must not
+ * overwrite buffers they reference while a submission reading them is in
+ * flight.
+ *
+ * A recorded job is not thread-safe. Use one per submitting thread.
+ */
+
+#ifndef VKC_JOB_H
+#define VKC_JOB_H
+
+#include "vk/memory.h"
+#include "vk/buffer.h"
+#include "vk/queue.h"
+#include <vulkan/vulkan.h>
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief Upper bound on the frames of a job.
+ */
+#define VKC_JOB_FRAMES_MAX 4
+
+/**
+ * @brief Upper bound on the stable descriptor sets of a job.
+ */
+#define VKC_JOB_SETS_MAX 4
+
+/**
+ * @brief Pipeline and bindings of a recorded job.
+ */
+typedef struct VkcJobInfo {
+    VkPipeline pipeline; /**< Compute pipeline to dispatch. */
+    VkPipelineLayout layout; /**< Layout of pipeline. */
+    const VkDescriptorSet* sets; /**< Stable sets, bound from set 0. */
+    uint32_t set_count; /**< Number of stable sets, up to VKC_JOB_SETS_MAX. */
+    VkDescriptorSetLayout params_layout; /**< Params set layout, or VK_NULL_HANDLE. */
+    VkDescriptorType params_type; /**< UNIFORM_BUFFER or STORAGE_BUFFER at binding 0. */
+    VkDeviceSize params_size; /**< Bytes of per-call parameters, 0 for none. */
+    const void* push_data; /**< Push constants recorded once, or NULL. */
+    uint32_t push_size; /**< Bytes of push constants. */
+    uint32_t frames; /**< Calls in flight, 1 to VKC_JOB_FRAMES_MAX. */
+} VkcJobInfo;
+
+/**
+ * @brief One replayable copy of the job.
+ */
+typedef struct VkcJobFrame {
+    VkCommandBuffer command; /**< Recorded once at creation. */
+    VkcBuffer* args; /**< Mapped VkDispatchIndirectCommand. */
+    VkcBuffer* params; /**< Mapped per-call parameters, or NULL. */
+    VkDescriptorSet set; /**< Binds params, or VK_NULL_HANDLE. */
+    uint64_t ticket; /**< Last submission of the frame, 0 if none. */
+} VkcJobFrame;
+
+/**
+ * @brief A dispatch sequence recorded once for replay.
+ */
+typedef struct VkcRecordedJob {
+    VkcMemoryPool* pool; /**< Pool the frame buffers are allocated from. */
+    VkcQueue* queue; /**< Queue the job is submitted to. */
+    VkCommandPool command_pool; /**< Pool of the frame command buffers. */
+    VkDescriptorPool descriptor_pool; /**< Pool of the params sets, or VK_NULL_HANDLE. */
+    VkcJobFrame frames[VKC_JOB_FRAMES_MAX]; /**< Frames in round-robin order. */
+    uint32_t frame_count; /**< Number of frames. */
+    uint32_t next; /**< Frame the next call is written to. */
+    VkDeviceSize params_size; /**< Bytes of per-call parameters. */
+    uint32_t max_groups[3]; /**< maxComputeWorkGroupCount of the device. */
+    uint64_t submissions; /**< Calls staged so far. */
+} VkcRecordedJob;
+
+/**
+ * @brief Create a job and record its frames.
+ *
+ * @param pool  Pool to allocate frame buffers from; its device and callbacks
+ *              are used for every other object.
+ * @param queue Queue to submit to; command buffers are allocated from its
+ *              family.
+ * @param info  Pipeline and bindings. Arrays are read during the call only.
+ * @return Allocated job, or NULL on failure.
+ */
+VkcRecordedJob* vkc_recorded_job_create(
+    VkcMemoryPool* pool, VkcQueue* queue, const VkcJobInfo* info
+);
+
+/**
+ * @brief Wait for every call in flight and destroy the job.
+ *
+ * @param job Pointer returned by vkc_recorded_job_create().
+ */
+void vkc_recorded_job_free(VkcRecordedJob* job);
+
+/**
+ * @brief Get the parameter memory of the next call.
+ *
+ * Waits for the next frame to retire if it is still in flight. Writing the
+ * parameters here and passing NULL to vkc_recorded_job_submit() avoids a copy.
+ *
+ * @return Mapped parameters, or NULL if the job has none or the wait failed.
+ */
+void* vkc_recorded_job_map(VkcRecordedJob* job);
+
+/**
+ * @brief Write a call into the next frame without submitting it.
+ *
+ * Used to submit several jobs in one batch; the caller submits the frame's
+ * command buffer and stores the resulting ticket in the frame.
+ *
+ * @param job    Job to call.
+ * @param params Parameters to copy, or NULL to keep what is mapped.
+ * @param groups Workgroup counts of the dispatch.
+ * @return Frame holding the call, or NULL on failure.
+ */
+VkcJobFrame* vkc_recorded_job_stage(
+    VkcRecordedJob* job, const void* params, const VkDispatchIndirectCommand* groups
+);
+
+/**
+ * @brief Replay the job with new parameters.
+ *
+ * @param job    Job to call.
+ * @param params Parameters to copy, or NULL to keep what is mapped.
+ * @param groups Workgroup counts of the dispatch.
+ * @return Ticket of the call on the job's queue, or 0 on failure.
+ */
+uint64_t vkc_recorded_job_submit(
+    VkcRecordedJob* job, const void* params, const VkDispatchIndirectCommand* groups
+);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // VKC_JOB_H
@@ -0,0 +1,165 @@
+/**
+ * @file include/vk/lease.h
+ * @brief Bulk ownership of Vulkan handles.
+ *
+ * A VkcLease owns the Vulkan objects registered with it and destroys them in
+ * reverse registration order with a single call. Registering a handle right
+ * after it is created replaces per-object cleanup labels: whatever was created
+ * before a failure is exactly what gets torn down.
+ *
+ * Tenants live in a flat array, so registration is an amortized O(1) append
+ * and teardown is a single O(objects) walk. A mark taken with vkc_lease_mark()
+ * lets a short-lived job context release only what it added on top of a
+ * longer-lived base (instance, device, pipelines).
+ *
+ * Descriptor sets and command buffers are released with their pools and need
+ * not be registered.
+ */
+
+#ifndef VKC_LEASE_H
+#define VKC_LEASE_H
+
+#include "allocator/page.h"
+#include <vulkan/vulkan.h>
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief Number of tenants reserved when a lease is created.
+ */
+#define VKC_LEASE_CAPACITY 32
+
+/**
+ * @brief Convert a dispatchable or non-dispatchable handle to a tenant handle.
+ *
+ * Non-dispatchable handles are pointers only on 64-bit targets.
+ */
+#if defined(VK_USE_64_BIT_PTR_DEFINES) && (1 == VK_USE_64_BIT_PTR_DEFINES)
+    #define VKC_LEASE_HANDLE(handle) ((uint64_t) (uintptr_t) (handle))
+#else
+    #define VKC_LEASE_HANDLE(handle) ((uint64_t) (handle))
+#endif
+
+/**
+ * @brief Destructor for tenants the lease has no built-in teardown for.
+ */
+typedef void (*VkcLeaseDestroy)(void* user);
+
+/**
+ * @brief Ownership contract of a tenant.
+ */
+typedef enum VkcLeasePolicy {
+    VKC_LEASE_OWNED, /**< Destroyed when the lease is released. */
+    VKC_LEASE_BORROWED, /**< Tracked only; owned and destroyed elsewhere. */
+} VkcLeasePolicy;
+
+/**
+ * @brief A single handle owned by a lease.
+ */
+typedef struct VkcLeaseTenant {
+    VkObjectType type; /**< Object type, or VK_OBJECT_TYPE_UNKNOWN for custom tenants. */
+    VkcLeasePolicy policy; /**< Whether release destroys the handle. */
+    uint64_t handle; /**< Handle converted with VKC_LEASE_HANDLE(). */
+    void* parent; /**< Owning VkDevice or VkInstance, NULL for root objects. */
+    VkcLeaseDestroy destroy; /**< Custom destructor, or NULL. */
+    void* user; /**< Argument passed to the custom destructor. */
+} VkcLeaseTenant;
+
+/**
+ * @brief Owner of a stack of Vulkan handles.
+ */
+typedef struct VkcLease {
+    PageAllocator* pager; /**< Backing allocator for the lease and its tenants. */
+    const VkAllocationCallbacks* callbacks; /**< Callbacks the handles were created with. */
+    VkcLeaseTenant* tenants; /**< Tenants in registration order. */
+    size_t count; /**< Number of registered tenants. */
+    size_t capacity; /**< Number of tenants the array can hold. */
+} VkcLease;
+
+/**
+ * @brief Create an empty lease.
+ *
+ * @param pager     Allocator used for the lease and its tenant array.
+ * @param callbacks Allocation callbacks passed to every destroy call, or NULL.
+ *                  Must outlive the lease.
+ * @return Allocated lease, or NULL on failure.
+ */
+VkcLease* vkc_lease_create(PageAllocator* pager, const VkAllocationCallbacks* callbacks);
+
+/**
+ * @brief Release every tenant and destroy the lease.
+ *
+ * @param lease Pointer returned by vkc_lease_create().
+ */
+void vkc_lease_free(VkcLease* lease);
+
+/**
+ * @brief Take ownership of a Vulkan handle.
+ *
+ * Supported types are the instance, the device, and the device objects that
+ * have a vkDestroy* or vkFree* entry point taking allocation callbacks.
+ * Null handles are accepted and ignored. If the tenant array cannot grow the
+ * handle is destroyed before returning, so ownership transfers and the
+ * caller only has to release the lease.
+ *
+ * Argument errors are the exception. These are a NULL lease, an unsupported
+ * type, and a device object without a parent. The lease cannot know how to
+ * destroy the handle in those cases, so it never takes ownership. The handle
+ * stays with the caller, who must destroy it.
+ *
+ * @param lease  Lease to register with.
+ * @param type   Object type of the handle.
+ * @param handle Handle converted with VKC_LEASE_HANDLE().
+ * @param parent VkDevice for device objects, NULL for the device and instance.
+ * @return true on success. false on an argument error (the caller still owns
+ *         the handle) or an allocation failure (the handle was destroyed).
+ */
+bool vkc_lease_add(VkcLease* lease, VkObjectType type, uint64_t handle, void* parent);
+
+/**
+ * @brief Track a handle without taking ownership of it.
+ *
+ * @return true on success, false on allocation failure.
+ */
+bool vkc_lease_borrow(VkcLease* lease, VkObjectType type, uint64_t handle, void* parent);
+
+/**
+ * @brief Register a custom destructor, e.g. for extension objects.
+ *
+ * @param lease   Lease to register with.
+ * @param destroy Function called on release.
+ * @param user    Argument passed to destroy.
+ * @return true on success, false on allocation failure, in which case destroy
+ *         has already been called.
+ */
+bool vkc_lease_add_custom(VkcLease* lease, VkcLeaseDestroy destroy, void* user);
+
+/**
+ * @brief Get the current position in the tenant stack.
+ */
+size_t vkc_lease_mark(const VkcLease* lease);
+
+/**
+ * @brief Destroy every tenant registered after mark, newest first.
+ *
+ * @param lease Lease to release from.
+ * @param mark  Value returned by vkc_lease_mark().
+ */
+void vkc_lease_release_to(VkcLease* lease, size_t mark);
+
+/**
+ * @brief Destroy every tenant, newest first, and keep the lease for reuse.
+ */
+void vkc_lease_release(VkcLease* lease);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // VKC_LEASE_H
@@ -0,0 +1,400 @@
+/**
+ * @file include/vk/memory.h
+ * @brief Device memory sub-allocation for Vulkan resources.
+ *
+ * A VkcMemoryPool allocates large VkDeviceMemory blocks per memory type and
+ * carves resources out of them with a binary buddy allocator. Every node is
+ * aligned to its own size, so any power of two alignment up to the node size
+ * is satisfied for free, and a released node merges with its buddy in
+ * O(log n) without searching.
+ *
+ * Free nodes are tracked in one host-side bitmap per order because device
+ * memory cannot hold intrusive links. Requests larger than a block get a
+ * dedicated VkDeviceMemory of their own.
+ *
+ * When bufferImageGranularity exceeds the smallest node, linear and optimal
+ * resources are served from separate blocks so they never share a page.
+ *
+ * Host-visible blocks are mapped once, on first request, and stay mapped
+ * until the block is released, so allocations expose a stable pointer. Writes
+ * to and reads from non-coherent memory are made visible with a VkcMemoryBatch,
+ * which collects the ranges touched for a submission and issues a single
+ * flush or invalidate call.
+ *
+ * Every heap has a budget: the driver's figure when VK_EXT_memory_budget is
+ * enabled, else a fixed share of the heap size. A new block that would take a
+ * heap past its budget is refused with an error instead of letting the driver
+ * fail with VK_ERROR_OUT_OF_DEVICE_MEMORY or silently page memory out, which
+ * matters when several processes share one device.
+ *
+ * With VK_EXT_external_memory_host enabled, suitably aligned host allocations
+ * can be imported as device memory of their own, so the device reads and
+ * writes application arrays in place instead of through a staging copy.
+ *
+ * The pool is shared between threads and guarded by a mutex.
+ */
+
+#ifndef VKC_MEMORY_H
+#define VKC_MEMORY_H
+
+#include "allocator/page.h"
+#include <vulkan/vulkan.h>
+
+#include <pthread.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief Preferred size of a device memory block in bytes.
+ *
+ * Heaps of 1 GiB or less use an eighth of the heap instead.
+ */
+#define VKC_MEMORY_BLOCK_SIZE (64ull * 1024 * 1024)
+
+/**
+ * @brief Smallest buddy node in bytes. Must be a power of two.
+ */
+#define VKC_MEMORY_MIN_SIZE 256ull
+
+/**
+ * @brief Upper bound on the number of buddy orders in a block.
+ */
+#define VKC_MEMORY_ORDER_MAX 32
+
+/**
+ * @brief Sentinel returned when no memory type qualifies.
+ */
+#define VKC_MEMORY_TYPE_NONE UINT32_MAX
+
+/**
+ * @brief Number of ranges a batch holds before it is submitted implicitly.
+ */
+#define VKC_MEMORY_BATCH_SIZE 32
+
+/**
+ * @brief Share of a heap, in percent, used as its budget without VK_EXT_memory_budget.
+ */
+#define VKC_MEMORY_BUDGET_PERCENT 80
+
+/**
+ * @brief Pool creation flags.
+ */
+typedef enum VkcMemoryPoolFlagBits {
+    VKC_MEMORY_POOL_BUDGET_BIT = 0x1, /**< VK_EXT_memory_budget is enabled on the device. */
+    VKC_MEMORY_POOL_HOST_IMPORT_BIT = 0x2, /**< VK_EXT_external_memory_host is enabled. */
+} VkcMemoryPoolFlagBits;
+
+typedef uint32_t VkcMemoryPoolFlags;
+
+/**
+ * @brief How a resource is accessed, used to score memory types.
+ */
+typedef enum VkcMemoryIntent {
+    VKC_MEMORY_GPU_ONLY, /**< Device reads and writes only; prefers DEVICE_LOCAL. */
+    VKC_MEMORY_UPLOAD, /**< Host writes once for a copy; prefers plain system memory. */
+    VKC_MEMORY_READBACK, /**< Device writes, host reads; prefers HOST_CACHED. */
+    VKC_MEMORY_STREAMING, /**< Host writes, device reads in place; prefers ReBAR. */
+    VKC_MEMORY_INTENT_COUNT,
+} VkcMemoryIntent;
+
+/**
+ * @brief Resource layout class, used to honour bufferImageGranularity.
+ */
+typedef enum VkcMemoryResource {
+    VKC_MEMORY_LINEAR, /**< Buffers and linear images. */
+    VKC_MEMORY_OPTIMAL, /**< Images with optimal tiling. */
+    VKC_MEMORY_RESOURCE_COUNT,
+} VkcMemoryResource;
+
+/**
+ * @brief Direction of a non-coherent memory batch.
+ */
+typedef enum VkcMemorySync {
+    VKC_MEMORY_FLUSH, /**< Host writes made visible to the device. */
+    VKC_MEMORY_INVALIDATE, /**< Device writes made visible to the host. */
+} VkcMemorySync;
+
+/**
+ * @brief A VkDeviceMemory block split into buddy nodes.
+ */
+typedef struct VkcMemoryBlock {
+    struct VkcMemoryBlock* next; /**< Next block of the same type and resource. */
+    struct VkcMemoryBlock* prev; /**< Previous block of the same type and resource. */
+    VkDeviceMemory memory; /**< Backing device memory. */
+    VkDeviceSize size; /**< Block size in bytes, a power of two unless dedicated. */
+    VkDeviceSize used; /**< Bytes held by live nodes. */
+    void* mapped; /**< Persistent host mapping of the whole block, or NULL. */
+    uint64_t* bitmap; /**< Free node bits of every order, NULL if dedicated. */
+    size_t words[VKC_MEMORY_ORDER_MAX]; /**< First bitmap word of each order. */
+    size_t hint[VKC_MEMORY_ORDER_MAX]; /**< Lowest word of an order that may hold a free node. */
+    uint32_t free[VKC_MEMORY_ORDER_MAX]; /**< Number of free nodes per order. */
+    uint32_t orders; /**< Number of orders, from VKC_MEMORY_MIN_SIZE to size. */
+    uint32_t type; /**< Memory type index. */
+    VkcMemoryResource resource; /**< Resource class served by the block. */
+    bool dedicated; /**< True if the block backs a single allocation. */
+    bool imported; /**< True if the block wraps a host allocation it does not own. */
+} VkcMemoryBlock;
+
+/**
+ * @brief A sub-allocation handed out by a pool.
+ */
+typedef struct VkcMemoryAllocation {
+    VkDeviceMemory memory; /**< Device memory to bind. */
+    VkDeviceSize offset; /**< Offset to bind at. */
+    VkDeviceSize size; /**< Requested size in bytes. */
+    VkcMemoryBlock* block; /**< Owning block. */
+    void* mapped; /**< Host address of offset once mapped, else NULL. */
+    uint32_t order; /**< Buddy order of the node. */
+    uint32_t type; /**< Memory type index. */
+    VkMemoryPropertyFlags flags; /**< Property flags of the memory type. */
+} VkcMemoryAllocation;
+
+/**
+ * @brief Budget and usage of a memory heap.
+ */
+typedef struct VkcMemoryBudget {
+    VkDeviceSize size; /**< Heap size in bytes. */
+    VkDeviceSize budget; /**< Bytes the process can allocate from the heap. */
+    VkDeviceSize usage; /**< Bytes the process holds, all allocators included if known. */
+    VkDeviceSize pool_usage; /**< Bytes held by this pool. */
+} VkcMemoryBudget;
+
+/**
+ * @brief Thread-safe device memory pool for a single VkDevice.
+ */
+typedef struct VkcMemoryPool {
+    PageAllocator* pager; /**< Host allocator for blocks and bitmaps. */
+    VkPhysicalDevice physical; /**< Physical device, queried for budgets. */
+    VkDevice device; /**< Device the memory is allocated from. */
+    const VkAllocationCallbacks* callbacks; /**< Host callbacks for vkAllocateMemory, or NULL. */
+    VkPhysicalDeviceMemoryProperties properties; /**< Cached memory types and heaps. */
+    VkDeviceSize granularity; /**< bufferImageGranularity of the device. */
+    VkDeviceSize atom; /**< nonCoherentAtomSize of the device. */
+    uint32_t allocation_count; /**< Live VkDeviceMemory objects. */
+    uint32_t allocation_limit; /**< maxMemoryAllocationCount of the device. */
+    VkDeviceSize import_alignment; /**< minImportedHostPointerAlignment, or 0 without import. */
+    PFN_vkGetMemoryHostPointerPropertiesEXT host_pointer_properties; /**< Import type query. */
+    VkcMemoryBlock* blocks[VK_MAX_MEMORY_TYPES][VKC_MEMORY_RESOURCE_COUNT]; /**< Block lists. */
+    VkcMemoryBudget budgets[VK_MAX_MEMORY_HEAPS]; /**< Per-heap budget as of the last block. */
+    VkcMemoryPoolFlags flags; /**< Flags the pool was created with. */
+    pthread_mutex_t mutex; /**< Guards the block lists and budgets. */
+} VkcMemoryPool;
+
+/**
+ * @brief Ranges of non-coherent memory to flush or invalidate together.
+ *
+ * Initialize with `VkcMemoryBatch batch = {.op = VKC_MEMORY_FLUSH};`.
+ */
+typedef struct VkcMemoryBatch {
+    VkcMemorySync op; /**< Flush or invalidate. */
+    uint32_t count; /**< Number of pending ranges. */
+    VkMappedMemoryRange ranges[VKC_MEMORY_BATCH_SIZE]; /**< Pending ranges. */
+} VkcMemoryBatch;
+
+/**
+ * @brief Create an empty pool.
+ *
+ * @param pager     Allocator used for the pool and its host-side metadata.
+ * @param physical  Physical device the logical device was created from.
+ * @param device    Logical device to allocate from.
+ * @param callbacks Host callbacks passed to vkAllocateMemory, or NULL. Must
+ *                  outlive the pool.
+ * @param flags     VkcMemoryPoolFlagBits.
+ * @return Allocated pool, or NULL on failure.
+ */
+VkcMemoryPool* vkc_memory_pool_create(
+    PageAllocator* pager,
+    VkPhysicalDevice physical,
+    VkDevice device,
+    const VkAllocationCallbacks* callbacks,
+    VkcMemoryPoolFlags flags
+);
+
+/**
+ * @brief Release every block and destroy the pool.
+ *
+ * All resources bound to pool memory must be destroyed first.
+ *
+ * @param pool Pointer returned by vkc_memory_pool_create().
+ */
+void vkc_memory_pool_free(VkcMemoryPool* pool);
+
+/**
+ * @brief Find the first memory type allowed by type_bits with every required flag.
+ *
+ * @return Memory type index, or VKC_MEMORY_TYPE_NONE.
+ */
+uint32_t vkc_memory_type_find(
+    const VkcMemoryPool* pool, uint32_t type_bits, VkMemoryPropertyFlags required
+);
+
+/**
+ * @brief Pick the best memory type for an access pattern.
+ *
+ * Every type allowed by type_bits is scored against the intent using the
+ * cached memory properties; the highest score wins and ties go to the lower
+ * index, which drivers order by performance. Host intents require
+ * HOST_VISIBLE; READBACK favours HOST_CACHED over HOST_COHERENT and the others
+ * the reverse. Protected and lazily allocated types are never chosen.
+ * GPU_ONLY accepts any type, so CPU implementations without DEVICE_LOCAL
+ * memory still get a valid choice.
+ *
+ * @return Memory type index, or VKC_MEMORY_TYPE_NONE.
+ */
+uint32_t vkc_memory_type_select(
+    const VkcMemoryPool* pool, uint32_t type_bits, VkcMemoryIntent intent
+);
+
+/**
+ * @brief Get the memory types that share a heap with a given type.
+ *
+ * Clearing these bits from memoryTypeBits and selecting again moves a
+ * resource to another heap, e.g. from an exhausted DEVICE_LOCAL heap to
+ * host-visible system memory.
+ *
+ * @return Bit mask of memory type indices.
+ */
+uint32_t vkc_memory_heap_types(const VkcMemoryPool* pool, uint32_t type);
+
+/**
+ * @brief Refresh and copy the budget of every heap.
+ *
+ * @param pool    Pool to query.
+ * @param budgets Array of VK_MAX_MEMORY_HEAPS entries to fill.
+ * @return Number of heaps filled in.
+ */
+uint32_t vkc_memory_budget_query(VkcMemoryPool* pool, VkcMemoryBudget* budgets);
+
+/**
+ * @brief Sub-allocate memory for a resource.
+ *
+ * @param pool         Pool to allocate from.
+ * @param requirements Size, alignment, and allowed types of the resource.
+ * @param type         Memory type index, which must be in memoryTypeBits.
+ * @param resource     Layout class of the resource.
+ * @param allocation   Receives the allocation on success.
+ * @return true on success, false on failure, including when a new block would
+ *         exceed the heap budget.
+ */
+bool vkc_memory_malloc(
+    VkcMemoryPool* pool,
+    const VkMemoryRequirements* requirements,
+    uint32_t type,
+    VkcMemoryResource resource,
+    VkcMemoryAllocation* allocation
+);
+
+/**
+ * @brief Move an allocation's node into a denser block of the same list.
+ *
+ * Used by defragmentation: the new node is taken from the fullest block of the
+ * same memory type and resource class that is denser than the source block.
+ * No VkDeviceMemory is ever allocated, so the call fails rather than grow the
+ * pool. The source allocation is left untouched; free it once its contents
+ * have been copied.
+ *
+ * @param pool         Pool that produced the source allocation.
+ * @param source       Allocation to move. Dedicated allocations never move.
+ * @param requirements Requirements of the resource that will be bound.
+ * @param allocation   Receives the new allocation on success.
+ * @return true if a denser home was found, false otherwise.
+ */
+bool vkc_memory_relocate(
+    VkcMemoryPool* pool,
+    const VkcMemoryAllocation* source,
+    const VkMemoryRequirements* requirements,
+    VkcMemoryAllocation* allocation
+);
+
+/**
+ * @brief Import a host allocation as dedicated device memory.
+ *
+ * Requires VKC_MEMORY_POOL_HOST_IMPORT_BIT. host and size must be multiples
+ * of import_alignment, and the memory must stay allocated until the
+ * allocation is freed. The allocation is mapped at host from the start, and
+ * the device sees the application's writes without a copy. Fails quietly
+ * when the pool cannot import, so callers can fall back to a copy.
+ *
+ * @param pool         Pool to account the memory to.
+ * @param host         Start of the host allocation.
+ * @param size         Bytes of the host allocation to import.
+ * @param requirements Requirements of the resource that will be bound; its
+ *                     size may not exceed size.
+ * @param intent       Access pattern used to pick among importable types.
+ * @param allocation   Receives the allocation on success.
+ * @return true on success, false if the range cannot be imported.
+ */
+bool vkc_memory_import(
+    VkcMemoryPool* pool,
+    void* host,
+    VkDeviceSize size,
+    const VkMemoryRequirements* requirements,
+    VkcMemoryIntent intent,
+    VkcMemoryAllocation* allocation
+);
+
+/**
+ * @brief Return an allocation to its pool.
+ *
+ * A block left empty is released unless it is the last of its list.
+ *
+ * @param pool       Pool that produced the allocation.
+ * @param allocation Allocation to release. Reset to zero on return.
+ */
+void vkc_memory_free(VkcMemoryPool* pool, VkcMemoryAllocation* allocation);
+
+/**
+ * @brief Get a persistent host pointer to an allocation.
+ *
+ * The owning block is mapped on first use and stays mapped until it is
+ * released; later calls cost nothing.
+ *
+ * @param pool       Pool that produced the allocation.
+ * @param allocation Allocation in a host-visible memory type.
+ * @return Host address of the allocation, or NULL on failure.
+ */
+void* vkc_memory_map(VkcMemoryPool* pool, VkcMemoryAllocation* allocation);
+
+/**
+ * @brief Queue a range of a mapped allocation for flush or invalidate.
+ *
+ * Ranges in coherent memory are skipped. Ranges are widened to
+ * nonCoherentAtomSize, which never crosses into a neighbouring node because
+ * nodes are at least VKC_MEMORY_MIN_SIZE aligned. Adjacent ranges of the same
+ * memory are merged. A full batch is submitted before the range is added.
+ *
+ * @param pool       Pool that produced the allocation.
+ * @param batch      Batch to add to.
+ * @param allocation Mapped allocation.
+ * @param offset     Offset of the range within the allocation.
+ * @param size       Size of the range, or VK_WHOLE_SIZE for the rest of it.
+ * @return true on success, false if an implicit submit failed.
+ */
+bool vkc_memory_batch_add(
+    VkcMemoryPool* pool,
+    VkcMemoryBatch* batch,
+    const VkcMemoryAllocation* allocation,
+    VkDeviceSize offset,
+    VkDeviceSize size
+);
+
+/**
+ * @brief Flush or invalidate every pending range with a single call.
+ *
+ * Flush before vkQueueSubmit; invalidate after the submission's fence or
+ * semaphore has been waited on. The batch is empty on return.
+ *
+ * @return true on success or if nothing was pending, false on failure.
+ */
+bool vkc_memory_batch_submit(VkcMemoryPool* pool, VkcMemoryBatch* batch);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // VKC_MEMORY_H
@@ -0,0 +1,152 @@
+/**
+ * @file include/vk/queue.h
+ * @brief Ticketed submission on a timeline semaphore.
+ *
+ * A VkcQueue owns a VkQueue's submissions and one Vulkan 1.2 timeline
+ * semaphore. Every submit signals the next value of the timeline and returns
+ * it as a ticket, so tickets increase monotonically in submission order and
+ * completing ticket N implies every earlier ticket is complete. The caller
+ * polls or waits on a single job instead of draining the queue with
+ * vkQueueWaitIdle, which lets any number of jobs stay in flight.
+ *
+ * Tickets convert to VkcSyncPoint values, so staging rings and readbacks can
+ * be committed against the submission that consumes them. Since that has to
+ * happen before vkQueueSubmit, a submission can name a prepare callback that
+ * is handed the ticket's sync point just before the submit.
+ *
+ * A VkcQueue is thread-safe. All submissions to its VkQueue must go through
+ * it, since Vulkan requires queue access to be externally synchronized.
+ */
+
+#ifndef VKC_QUEUE_H
+#define VKC_QUEUE_H
+
+#include "allocator/page.h"
+#include "vk/sync.h"
+#include <vulkan/vulkan.h>
+
+#include <pthread.h>
+#include <stdbool.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief Upper bound on the sync points a single submission waits on.
+ */
+#define VKC_QUEUE_WAITS_MAX 8
+
+/**
+ * @brief Called with a submission's sync point right before it is submitted.
+ *
+ * @param point Sync point the submission will signal.
+ * @param user  Argument given in VkcQueueSubmit.
+ * @return true to submit, false to abort the submission.
+ */
+typedef bool (*VkcQueuePrepare)(VkcSyncPoint point, void* user);
+
+/**
+ * @brief Work and dependencies of one submission.
+ */
+typedef struct VkcQueueSubmit {
+    const VkCommandBuffer* commands; /**< Command buffers to execute in order. */
+    uint32_t command_count; /**< Number of command buffers, may be 0. */
+    const VkcSyncPoint* waits; /**< Timeline points to wait on, e.g. other queues' tickets. */
+    uint32_t wait_count; /**< Number of wait points, up to VKC_QUEUE_WAITS_MAX. */
+    VkPipelineStageFlags wait_stage; /**< Stages blocked by the waits, 0 for all commands. */
+    VkcQueuePrepare prepare; /**< Optional hook run before the submit. */
+    void* user; /**< Argument passed to prepare. */
+} VkcQueueSubmit;
+
+/**
+ * @brief A queue whose submissions are tracked by timeline value.
+ */
+typedef struct VkcQueue {
+    PageAllocator* pager; /**< Host allocator for the queue structure. */
+    VkDevice device; /**< Device the queue belongs to. */
+    const VkAllocationCallbacks* callbacks; /**< Callbacks for the semaphore, or NULL. */
+    VkQueue queue; /**< Queue submitted to. */
+    uint32_t family; /**< Queue family index of queue. */
+    VkSemaphore timeline; /**< Signaled with each submission's ticket. */
+    uint64_t submitted; /**< Last ticket issued. */
+    uint64_t completed; /**< Highest ticket known to be complete. */
+    pthread_mutex_t mutex; /**< Serializes submissions and guards the counters. */
+} VkcQueue;
+
+/**
+ * @brief Wrap a VkQueue and create its timeline semaphore.
+ *
+ * The device must have been created with the timelineSemaphore feature.
+ *
+ * @param pager     Allocator used for the queue structure.
+ * @param device    Device the queue belongs to.
+ * @param queue     Queue to submit to.
+ * @param family    Queue family index of queue.
+ * @param callbacks Allocation callbacks for the semaphore, or NULL. Must
+ *                  outlive the queue.
+ * @return Allocated queue, or NULL on failure.
+ */
+VkcQueue* vkc_queue_create(
+    PageAllocator* pager,
+    VkDevice device,
+    VkQueue queue,
+    uint32_t family,
+    const VkAllocationCallbacks* callbacks
+);
+
+/**
+ * @brief Wait for every ticket issued so far and destroy the queue.
+ *
+ * @param queue Pointer returned by vkc_queue_create().
+ */
+void vkc_queue_free(VkcQueue* queue);
+
+/**
+ * @brief Submit work and get a ticket for it.
+ *
+ * Wait points must be timeline sync points, e.g. from vkc_queue_point() on
+ * another queue; empty points are skipped.
+ *
+ * @param queue  Queue to submit to.
+ * @param submit Work and dependencies of the submission.
+ * @return Ticket signaled when the work completes, or 0 on failure.
+ */
+uint64_t vkc_queue_submit(VkcQueue* queue, const VkcQueueSubmit* submit);
+
+/**
+ * @brief Get the sync point of a ticket.
+ */
+VkcSyncPoint vkc_queue_point(const VkcQueue* queue, uint64_t ticket);
+
+/**
+ * @brief Get the highest completed ticket, querying the timeline.
+ */
+uint64_t vkc_queue_completed(VkcQueue* queue);
+
+/**
+ * @brief Get the number of tickets issued but not yet complete.
+ */
+uint64_t vkc_queue_pending(VkcQueue* queue);
+
+/**
+ * @brief Check whether a ticket has completed without blocking.
+ */
+bool vkc_queue_poll(VkcQueue* queue, uint64_t ticket);
+
+/**
+ * @brief Block until a ticket completes or the timeout expires.
+ *
+ * @param queue   Queue the ticket was issued by.
+ * @param ticket  Ticket returned by vkc_queue_submit().
+ * @param timeout Timeout in nanoseconds, UINT64_MAX to wait forever.
+ * @return true if the ticket completed, false on timeout or error.
+ */
+bool vkc_queue_wait(VkcQueue* queue, uint64_t ticket, uint64_t timeout);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // VKC_QUEUE_H
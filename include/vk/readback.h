@@ -0,0 +1,181 @@
+/**
+ * @file include/vk/readback.h
+ * @brief Asynchronous readback of device results into host memory.
+ *
+ * A VkcReadback rotates a small set of HOST_CACHED download buffers. Recording
+ * a readback copies a device buffer range into the next free slot and hands
+ * back a ticket; the ticket is redeemed for a host pointer once the
+ * submission's sync point retires. With two or three slots the host consumes
+ * the results of batch N while the device computes batch N+1, instead of
+ * idling the queue after every dispatch.
+ *
+ * A slot is reused only after its ticket is released and its copy has
+ * completed, so a pointer returned by vkc_readback_wait() stays valid until
+ * the release, and a ticket released before it was waited on keeps its slot
+ * until its sync point is reached. Recording fails rather than blocks when
+ * every slot is held.
+ *
+ * A readback is not thread-safe. Use one per recording thread.
+ */
+
+#ifndef VKC_READBACK_H
+#define VKC_READBACK_H
+
+#include "vk/memory.h"
+#include "vk/buffer.h"
+#include "vk/sync.h"
+#include <vulkan/vulkan.h>
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief Upper bound on the number of download slots.
+ */
+#define VKC_READBACK_SLOTS_MAX 4
+
+/**
+ * @brief Lifecycle of a download slot.
+ */
+typedef enum VkcReadbackState {
+    VKC_READBACK_FREE, /**< Available for the next copy. */
+    VKC_READBACK_RECORDED, /**< Copy recorded, not yet committed. */
+    VKC_READBACK_PENDING, /**< Committed; waiting on its sync point. */
+    VKC_READBACK_READY, /**< Invalidated and readable by the host. */
+    VKC_READBACK_RETIRING, /**< Released while pending; free once its sync point is reached. */
+} VkcReadbackState;
+
+/**
+ * @brief A HOST_CACHED download buffer and the copy it holds.
+ */
+typedef struct VkcReadbackSlot {
+    VkcBuffer* buffer; /**< Mapped READBACK buffer with TRANSFER_DST usage. */
+    VkcSyncPoint point; /**< Signaled when the copy completes. */
+    VkDeviceSize size; /**< Bytes copied into the slot. */
+    uint64_t serial; /**< Serial of the ticket holding the slot. */
+    VkcReadbackState state; /**< Where the slot is in its lifecycle. */
+} VkcReadbackSlot;
+
+/**
+ * @brief Handle to a recorded readback.
+ */
+typedef struct VkcReadbackTicket {
+    uint64_t serial; /**< Unique per readback; zero is never issued. */
+    uint32_t slot; /**< Slot the copy was recorded into. */
+} VkcReadbackTicket;
+
+/**
+ * @brief Ring of download buffers for asynchronous readback.
+ */
+typedef struct VkcReadback {
+    VkcMemoryPool* pool; /**< Pool the slots are allocated from. */
+    VkcReadbackSlot slots[VKC_READBACK_SLOTS_MAX]; /**< Download slots. */
+    VkDeviceSize capacity; /**< Size of each slot in bytes. */
+    uint64_t serial; /**< Serial of the last issued ticket. */
+    uint32_t count; /**< Number of slots in use. */
+    uint32_t next; /**< First slot searched for the next copy. */
+    VkPipelineStageFlags source_stage; /**< Stage whose writes a copy waits for. */
+    VkAccessFlags source_access; /**< Writes a copy waits for. */
+} VkcReadback;
+
+/**
+ * @brief Create a readback ring.
+ *
+ * @param pool     Pool to allocate the download buffers from.
+ * @param capacity Size of each slot in bytes; bounds a single readback.
+ * @param slots    Number of slots, from 1 to VKC_READBACK_SLOTS_MAX. Use 2 to
+ *                 double buffer and 3 to triple buffer.
+ * @return Allocated readback, or NULL on failure.
+ */
+VkcReadback* vkc_readback_create(VkcMemoryPool* pool, VkDeviceSize capacity, uint32_t slots);
+
+/**
+ * @brief Destroy a readback ring.
+ *
+ * Every submission that writes to it must have completed.
+ *
+ * @param readback Pointer returned by vkc_readback_create().
+ */
+void vkc_readback_free(VkcReadback* readback);
+
+/**
+ * @brief Set the writes a copy is ordered after.
+ *
+ * Defaults to compute shader writes. A readback recorded on a transfer-only
+ * queue, which has no compute stage, uses the transfer stage instead and
+ * relies on the semaphore and ownership acquire to order it after the
+ * compute queue.
+ *
+ * @param readback Readback to configure.
+ * @param stage    Source stage of the barrier before each copy.
+ * @param access   Source access of the barrier before each copy.
+ */
+void vkc_readback_source(VkcReadback* readback, VkPipelineStageFlags stage, VkAccessFlags access);
+
+/**
+ * @brief Record a copy of a device buffer range into the next free slot.
+ *
+ * The copy is preceded by a barrier from compute shader writes, or whatever
+ * vkc_readback_source() set, and followed by one to host reads, so it can be
+ * recorded right after a dispatch.
+ *
+ * @param readback   Readback to record into.
+ * @param command    Command buffer in the recording state.
+ * @param src        Source buffer, created with TRANSFER_SRC usage.
+ * @param src_offset Offset in the source buffer.
+ * @param size       Number of bytes to copy, at most the slot capacity.
+ * @param ticket     Receives the ticket on success.
+ * @return true on success, false if every slot is still held or on error.
+ */
+bool vkc_readback_copy(
+    VkcReadback* readback,
+    VkCommandBuffer command,
+    VkBuffer src,
+    VkDeviceSize src_offset,
+    VkDeviceSize size,
+    VkcReadbackTicket* ticket
+);
+
+/**
+ * @brief Tag every copy recorded since the last commit with a sync point.
+ *
+ * @param readback Readback to commit.
+ * @param point    Fence or timeline value signaled by the submission.
+ */
+void vkc_readback_commit(VkcReadback* readback, VkcSyncPoint point);
+
+/**
+ * @brief Check whether a committed readback has completed without blocking.
+ */
+bool vkc_readback_poll(VkcReadback* readback, VkcReadbackTicket ticket);
+
+/**
+ * @brief Wait for a readback and get its data.
+ *
+ * The slot is invalidated once, on the first successful call.
+ *
+ * @param readback Readback the ticket came from.
+ * @param ticket   Committed ticket.
+ * @param timeout  Timeout in nanoseconds, UINT64_MAX to wait forever.
+ * @return Host pointer to the copied bytes, valid until the ticket is
+ *         released, or NULL on timeout or error.
+ */
+const void* vkc_readback_wait(VkcReadback* readback, VkcReadbackTicket ticket, uint64_t timeout);
+
+/**
+ * @brief Return a ticket's slot to the rotation.
+ *
+ * A ticket may be released in any state. If its copy is still pending, the
+ * slot is reused only once the copy's sync point is reached.
+ */
+void vkc_readback_release(VkcReadback* readback, VkcReadbackTicket ticket);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // VKC_READBACK_H
@@ -0,0 +1,148 @@
+/**
+ * @file include/vk/scheduler.h
+ * @brief Spread independent jobs over every compute queue of a device.
+ *
+ * A VkcScheduler wraps every queue named by a VkcDeviceQueueRequest, except
+ * its dedicated transfer queue, in its own VkcQueue, so each hardware queue
+ * has its own timeline and its own submission lock, and picks one of them per
+ * job:
+ *
+ *   - VKC_SCHEDULER_ROUND_ROBIN cycles through the candidate queues, and
+ *   - VKC_SCHEDULER_LEAST_LOADED takes the queue with the fewest tickets in
+ *     flight, breaking ties in round-robin order.
+ *
+ * A command buffer can only be submitted to queues of the family its pool was
+ * created for, and exclusive resources must not be used by two families
+ * without an ownership transfer, so picks can be restricted to one family.
+ * Queues of the same family share everything and need no transfers.
+ *
+ * Independent kernels on separate queues may run concurrently on hardware
+ * that supports it; elsewhere the driver serializes them. Jobs that depend
+ * on each other across queues wait on each other's vkc_queue_point().
+ *
+ * A VkcScheduler is thread-safe.
+ */
+
+#ifndef VKC_SCHEDULER_H
+#define VKC_SCHEDULER_H
+
+#include "allocator/page.h"
+#include "vk/device.h"
+#include "vk/queue.h"
+#include <vulkan/vulkan.h>
+
+#include <stdatomic.h>
+#include <stdbool.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief Upper bound on the queues of a scheduler.
+ */
+#define VKC_SCHEDULER_QUEUES_MAX 32
+
+/**
+ * @brief Family argument accepting queues of any family.
+ */
+#define VKC_SCHEDULER_ANY_FAMILY UINT32_MAX
+
+/**
+ * @brief Returned by vkc_scheduler_pick() when no queue qualifies.
+ */
+#define VKC_SCHEDULER_NONE UINT32_MAX
+
+/**
+ * @brief How a queue is chosen for a job.
+ */
+typedef enum VkcSchedulerPolicy {
+    VKC_SCHEDULER_ROUND_ROBIN, /**< Cycle through the candidates. */
+    VKC_SCHEDULER_LEAST_LOADED, /**< Fewest tickets in flight. */
+} VkcSchedulerPolicy;
+
+/**
+ * @brief A ticket together with the queue that issued it.
+ */
+typedef struct VkcSchedulerTicket {
+    VkcQueue* queue; /**< Queue the job was submitted to, NULL on failure. */
+    uint64_t ticket; /**< Ticket on queue. */
+} VkcSchedulerTicket;
+
+/**
+ * @brief The compute queues of a device.
+ */
+typedef struct VkcScheduler {
+    PageAllocator* pager; /**< Host allocator for the scheduler structure. */
+    VkcQueue* queues[VKC_SCHEDULER_QUEUES_MAX]; /**< One per hardware queue. */
+    uint32_t queue_count; /**< Number of queues. */
+    uint32_t family_count; /**< Number of distinct families among the queues. */
+    VkcSchedulerPolicy policy; /**< How vkc_scheduler_pick() chooses. */
+    atomic_uint cursor; /**< Round-robin position. */
+} VkcScheduler;
+
+/**
+ * @brief Wrap every queue of a request.
+ *
+ * The device must have been created with the request's infos and with the
+ * timelineSemaphore feature.
+ *
+ * @param pager     Allocator used for the scheduler and its queues.
+ * @param device    Device the queues belong to.
+ * @param request   Families and queue counts the device was created with.
+ * @param callbacks Allocation callbacks for the timelines, or NULL. Must
+ *                  outlive the scheduler.
+ * @param policy    How queues are chosen.
+ * @return Allocated scheduler, or NULL on failure.
+ */
+VkcScheduler* vkc_scheduler_create(
+    PageAllocator* pager,
+    VkDevice device,
+    const VkcDeviceQueueRequest* request,
+    const VkAllocationCallbacks* callbacks,
+    VkcSchedulerPolicy policy
+);
+
+/**
+ * @brief Wait for every queue and destroy the scheduler.
+ *
+ * @param scheduler Pointer returned by vkc_scheduler_create().
+ */
+void vkc_scheduler_free(VkcScheduler* scheduler);
+
+/**
+ * @brief Choose a queue for the next job.
+ *
+ * @param scheduler Scheduler to choose from.
+ * @param family    Required queue family, or VKC_SCHEDULER_ANY_FAMILY.
+ * @return Index into queues, or VKC_SCHEDULER_NONE if no queue qualifies.
+ */
+uint32_t vkc_scheduler_pick(VkcScheduler* scheduler, uint32_t family);
+
+/**
+ * @brief Submit a job to the queue chosen by vkc_scheduler_pick().
+ *
+ * @param scheduler Scheduler to submit through.
+ * @param family    Family the job's command buffers were allocated for.
+ * @param submit    Work and dependencies of the job.
+ * @return Queue and ticket of the job; queue is NULL on failure.
+ */
+VkcSchedulerTicket vkc_scheduler_submit(
+    VkcScheduler* scheduler, uint32_t family, const VkcQueueSubmit* submit
+);
+
+/**
+ * @brief Block until every ticket issued on every queue completes.
+ *
+ * @param scheduler Scheduler to drain.
+ * @param timeout   Timeout in nanoseconds per queue, UINT64_MAX to wait forever.
+ * @return true if all queues drained, false on timeout or error.
+ */
+bool vkc_scheduler_wait_idle(VkcScheduler* scheduler, uint64_t timeout);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // VKC_SCHEDULER_H
@@ -0,0 +1,113 @@
+/**
+ * @file include/vk/slab.h
+ * @brief Fixed-size slot slabs for small Vulkan host allocations.
+ *
+ * A slab serves a single slot size. Slots are carved out of large pages
+ * obtained from a PageAllocator, so the tracking hash map holds one entry per
+ * page instead of one per allocation. Pages with free slots are kept on a
+ * partial list; allocation and release are O(1).
+ *
+ * Slabs are shared between threads and guarded by a mutex. Callers amortize
+ * the lock by moving slots in batches, e.g. to refill a thread cache magazine.
+ */
+
+#ifndef VKC_SLAB_H
+#define VKC_SLAB_H
+
+#include "allocator/page.h"
+
+#include <pthread.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief Number of bytes per slab page, including the page header.
+ */
+#define VKC_SLAB_PAGE_SIZE (64 * 1024)
+
+/**
+ * @brief Number of slots moved per batch refill.
+ */
+#define VKC_SLAB_BATCH 32
+
+/**
+ * @brief Intrusive free list link stored inside a free slot.
+ */
+typedef struct VkcSlabNode {
+    struct VkcSlabNode* next; /**< Next free slot of the same page. */
+} VkcSlabNode;
+
+/**
+ * @brief Header at the start of every slab page.
+ */
+typedef struct VkcSlabPage {
+    struct VkcSlabPage* next; /**< Next page in the partial list. */
+    struct VkcSlabPage* prev; /**< Previous page in the partial list. */
+    VkcSlabNode* free; /**< Released slots ready for reuse. */
+    uint32_t carved; /**< Number of slots handed out by the bump cursor. */
+    uint32_t used; /**< Number of slots currently allocated. */
+    uint32_t capacity; /**< Total number of slots in the page. */
+    bool partial; /**< True while the page is linked into the partial list. */
+} VkcSlabPage;
+
+/**
+ * @brief Thread-safe slab of equally sized slots.
+ */
+typedef struct VkcSlab {
+    PageAllocator* pager; /**< Backing allocator for page storage. */
+    VkcSlabPage* partial; /**< Pages with at least one free slot. */
+    VkcSlabPage* empty; /**< One fully released page kept warm for reuse. */
+    size_t slot_size; /**< Stride between slots in bytes. */
+    size_t slot_offset; /**< Offset of the first slot from the page header. */
+    pthread_mutex_t mutex; /**< Guards the page lists. */
+} VkcSlab;
+
+/**
+ * @brief Create a slab serving slots of the given size.
+ *
+ * @param pager     Allocator used for the slab and its pages.
+ * @param slot_size Size of a slot in bytes. Rounded up to alignof(max_align_t).
+ * @return Allocated slab, or NULL on failure.
+ */
+VkcSlab* vkc_slab_create(PageAllocator* pager, size_t slot_size);
+
+/**
+ * @brief Destroy a slab.
+ *
+ * Pages still holding allocated slots are not released individually; they
+ * belong to the PageAllocator and are reclaimed when it is freed.
+ *
+ * @param slab Pointer returned by vkc_slab_create().
+ */
+void vkc_slab_free(VkcSlab* slab);
+
+/**
+ * @brief Allocate up to count slots in a single critical section.
+ *
+ * @param slab  Slab to allocate from.
+ * @param slots Receives the slot addresses.
+ * @param pages Receives the page owning each slot.
+ * @param count Number of slots requested.
+ * @return Number of slots allocated, which is less than count only on failure.
+ */
+uint32_t vkc_slab_malloc(VkcSlab* slab, void** slots, VkcSlabPage** pages, uint32_t count);
+
+/**
+ * @brief Return a slot to the page that owns it.
+ *
+ * @param slab Slab that produced the slot.
+ * @param page Page returned alongside the slot.
+ * @param slot Slot to release.
+ */
+void vkc_slab_release(VkcSlab* slab, VkcSlabPage* page, void* slot);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // VKC_SLAB_H
@@ -0,0 +1,192 @@
+/**
+ * @file include/vk/staging.h
+ * @brief Circular staging buffer for uploads to device-local memory.
+ *
+ * A VkcStagingRing is a single persistently mapped host-visible buffer used as
+ * a FIFO allocator. Each upload copies host data into the next free range and
+ * records a vkCmdCopyBuffer into a device-local destination, so kernels read
+ * from VRAM instead of across the bus, and the host can fill the next batch
+ * while the previous one is still being consumed.
+ *
+ * Ranges are tagged with a VkcSyncPoint when their submission is committed and
+ * reclaimed once it retires. Positions are tracked as 64-bit virtual offsets
+ * that only grow, so full and empty never look alike and wrapping is a modulo.
+ * An allocation never straddles the end of the buffer; the remainder of the
+ * lap is skipped instead.
+ *
+ * A ring is not thread-safe. Use one per recording thread.
+ */
+
+#ifndef VKC_STAGING_H
+#define VKC_STAGING_H
+
+#include "vk/memory.h"
+#include "vk/buffer.h"
+#include "vk/sync.h"
+#include <vulkan/vulkan.h>
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief Number of commits that can be in flight at once.
+ */
+#define VKC_STAGING_PENDING 64
+
+/**
+ * @brief Minimum alignment of a staging range in bytes.
+ *
+ * Ranges are also aligned to nonCoherentAtomSize, so flushing one never
+ * touches a neighbour the device may still be reading.
+ */
+#define VKC_STAGING_ALIGNMENT 16
+
+/**
+ * @brief Ranges written before a submission and the point it retires at.
+ */
+typedef struct VkcStagingCommit {
+    VkcSyncPoint point; /**< Signaled when the submission completes. */
+    uint64_t head; /**< Virtual position of the end of the committed ranges. */
+} VkcStagingCommit;
+
+/**
+ * @brief Persistently mapped upload buffer used as a circular allocator.
+ */
+typedef struct VkcStagingRing {
+    VkcBuffer* buffer; /**< Host-visible TRANSFER_SRC buffer. */
+    VkcMemoryBatch batch; /**< Ranges to flush on the next commit. */
+    VkDeviceSize capacity; /**< Size of the buffer in bytes. */
+    VkDeviceSize alignment; /**< Alignment of every range. */
+    uint64_t head; /**< Virtual position of the next allocation. */
+    uint64_t tail; /**< Virtual position of the oldest range still in flight. */
+    uint64_t committed; /**< Virtual position of the end of the last commit. */
+    VkcStagingCommit pending[VKC_STAGING_PENDING]; /**< In-flight commits, oldest first. */
+    uint32_t first; /**< Index of the oldest pending commit. */
+    uint32_t count; /**< Number of pending commits. */
+} VkcStagingRing;
+
+/**
+ * @brief Create a staging ring.
+ *
+ * @param pool     Pool to allocate the buffer from.
+ * @param capacity Size of the ring in bytes; bounds the largest single upload.
+ * @return Allocated ring, or NULL on failure.
+ */
+VkcStagingRing* vkc_staging_ring_create(VkcMemoryPool* pool, VkDeviceSize capacity);
+
+/**
+ * @brief Destroy a staging ring.
+ *
+ * Every submission that reads from it must have completed.
+ *
+ * @param ring Pointer returned by vkc_staging_ring_create().
+ */
+void vkc_staging_ring_free(VkcStagingRing* ring);
+
+/**
+ * @brief Reserve a range to write into.
+ *
+ * Retired commits are reclaimed first. If the ring is still full, the call
+ * blocks on the oldest pending commit. It fails if the space is held by
+ * uncommitted ranges, which no submission can free.
+ *
+ * @param ring   Ring to allocate from.
+ * @param size   Size of the range in bytes, at most the ring capacity.
+ * @param offset Receives the offset of the range in the ring buffer.
+ * @return Host pointer to the range, or NULL on failure.
+ */
+void* vkc_staging_ring_alloc(VkcStagingRing* ring, VkDeviceSize size, VkDeviceSize* offset);
+
+/**
+ * @brief Record a copy from a written range to a destination buffer.
+ *
+ * The range is queued for flushing on the next commit.
+ *
+ * @param ring       Ring the range was allocated from.
+ * @param command    Command buffer in the recording state.
+ * @param offset     Offset returned by vkc_staging_ring_alloc().
+ * @param size       Number of bytes to copy.
+ * @param dst        Destination buffer, created with TRANSFER_DST usage.
+ * @param dst_offset Offset in the destination buffer.
+ * @return true on success, false on failure.
+ */
+bool vkc_staging_ring_copy(
+    VkcStagingRing* ring,
+    VkCommandBuffer command,
+    VkDeviceSize offset,
+    VkDeviceSize size,
+    VkBuffer dst,
+    VkDeviceSize dst_offset
+);
+
+/**
+ * @brief Stage host data and record its copy to a destination buffer.
+ *
+ * Shorthand for vkc_staging_ring_alloc(), a memcpy, and vkc_staging_ring_copy().
+ *
+ * @return true on success, false on failure.
+ */
+bool vkc_staging_ring_upload(
+    VkcStagingRing* ring,
+    VkCommandBuffer command,
+    const void* data,
+    VkDeviceSize size,
+    VkBuffer dst,
+    VkDeviceSize dst_offset
+);
+
+/**
+ * @brief Make transfer writes visible to later pipeline stages.
+ *
+ * Record after the copies of a batch and before the commands that read the
+ * destinations.
+ *
+ * @param command Command buffer in the recording state.
+ * @param stage   Stages that read the destinations.
+ * @param access  Access types of those reads.
+ */
+void vkc_staging_ring_barrier(
+    VkCommandBuffer command, VkPipelineStageFlags stage, VkAccessFlags access
+);
+
+/**
+ * @brief Flush every range allocated since the last commit without tagging it.
+ *
+ * Also waits for the oldest commit if no commit slot is free, so a
+ * vkc_staging_ring_commit() right after it neither blocks nor fails. Use it
+ * when the sync point is only known to signal once the submit succeeded:
+ * flush, submit, then commit.
+ *
+ * @return true on success, false on failure.
+ */
+bool vkc_staging_ring_flush(VkcStagingRing* ring);
+
+/**
+ * @brief Flush every range allocated since the last commit and tag it.
+ *
+ * Call before the vkQueueSubmit that signals point, or after a
+ * vkc_staging_ring_flush() once the submit succeeded. A commit whose point
+ * never signals stalls every later allocation that needs its space.
+ *
+ * @param ring  Ring to commit.
+ * @param point Fence or timeline value signaled by the submission.
+ * @return true on success, false on failure.
+ */
+bool vkc_staging_ring_commit(VkcStagingRing* ring, VkcSyncPoint point);
+
+/**
+ * @brief Reclaim the space of every retired commit without blocking.
+ *
+ * @return Number of commits still pending.
+ */
+uint32_t vkc_staging_ring_reclaim(VkcStagingRing* ring);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // VKC_STAGING_H
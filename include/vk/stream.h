@@ -0,0 +1,172 @@
+/**
+ * @file include/vk/stream.h
+ * @brief Out-of-core execution of a kernel over data larger than device memory.
+ *
+ * A VkcStream runs a compute pipeline over an input of any size by splitting
+ * it into fixed-size chunks and streaming them through a small device working
+ * set: depth slots, each with an input and an output storage buffer in
+ * device-local memory. Per chunk it
+ *
+ *   1. reads the chunk straight into a VkcStagingRing and copies it to the
+ *      slot's input buffer,
+ *   2. clears the slot's output buffer and dispatches the kernel,
+ *   3. copies the output into a VkcReadback slot and submits with the slot's
+ *      fence,
+ *
+ * and once a slot comes around again, hands its finished partial result to a
+ * combine callback, so reductions fold partials on the host in chunk order.
+ * With two or more slots the upload of chunk N+1 and the host-side combine of
+ * chunk N-1 overlap the dispatch of chunk N.
+ *
+ * Given a VkcTransfer, steps 1 and 3 are submitted to its transfer queue and
+ * step 2 to its compute queue, chained by timeline waits, so on hardware with
+ * DMA engines the copies of neighbouring chunks also overlap the dispatch.
+ *
+ * The pipeline must use one descriptor set with the input chunk at binding 0
+ * and the output at binding 1, both storage buffers, as shaders/atomic_sum.comp
+ * does. Each workgroup consumes group_size bytes of input; a short final chunk
+ * is zero padded to a whole group, which suits sums and other reductions where
+ * zero is neutral.
+ */
+
+#ifndef VKC_STREAM_H
+#define VKC_STREAM_H
+
+#include "vk/memory.h"
+#include "vk/buffer.h"
+#include "vk/staging.h"
+#include "vk/readback.h"
+#include "vk/transfer.h"
+#include <vulkan/vulkan.h>
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief Upper bound on the number of chunks in flight.
+ */
+#define VKC_STREAM_DEPTH_MAX VKC_READBACK_SLOTS_MAX
+
+/**
+ * @brief Chunk size used when none is given and the heap budget allows it.
+ */
+#define VKC_STREAM_CHUNK_SIZE (64ull * 1024 * 1024)
+
+/**
+ * @brief Produce a range of the input.
+ *
+ * @param dst    Host-visible staging memory to write the range to.
+ * @param offset Byte offset of the range in the whole input.
+ * @param size   Number of bytes to write.
+ * @param user   Argument passed to vkc_stream_run().
+ * @return true on success, false to abort the run.
+ */
+typedef bool (*VkcStreamRead)(void* dst, VkDeviceSize offset, VkDeviceSize size, void* user);
+
+/**
+ * @brief Consume the output of one chunk.
+ *
+ * @param partial Output of the chunk, valid for the duration of the call.
+ * @param size    Output size in bytes.
+ * @param chunk   Index of the chunk; calls arrive in increasing order.
+ * @param user    Argument passed to vkc_stream_run().
+ */
+typedef void (*VkcStreamCombine)(
+    const void* partial, VkDeviceSize size, uint64_t chunk, void* user
+);
+
+/**
+ * @brief Pipeline and working set description of a stream.
+ */
+typedef struct VkcStreamInfo {
+    VkQueue queue; /**< Compute queue to submit to, unused with a transfer. */
+    uint32_t queue_family; /**< Family of queue, unused with a transfer. */
+    VkcTransfer* transfer; /**< Copies on its queue and dispatches on its compute, or NULL. */
+    VkPipeline pipeline; /**< Compute pipeline to dispatch. */
+    VkPipelineLayout layout; /**< Layout of pipeline. */
+    VkDescriptorSetLayout set_layout; /**< Set 0 layout: input at binding 0, output at 1. */
+    VkDeviceSize group_size; /**< Input bytes consumed by one workgroup. */
+    VkDeviceSize chunk_size; /**< Input bytes per chunk, or 0 to size from the budget. */
+    VkDeviceSize output_size; /**< Output bytes per chunk. */
+    uint32_t depth; /**< Chunks in flight, 1 to VKC_STREAM_DEPTH_MAX. */
+} VkcStreamInfo;
+
+/**
+ * @brief One chunk's share of the device working set.
+ */
+typedef struct VkcStreamSlot {
+    VkcBuffer* input; /**< Device-local input chunk. */
+    VkcBuffer* output; /**< Device-local output of the chunk. */
+    VkDescriptorSet set; /**< Binds input and output. */
+    VkCommandBuffer command; /**< Re-recorded for every chunk. */
+    VkFence fence; /**< Signaled when the chunk's submission completes. */
+    uint64_t copied; /**< Transfer ticket of the chunk's readback, with a transfer. */
+    VkcReadbackTicket ticket; /**< Readback of the output. */
+    uint64_t chunk; /**< Index of the chunk in flight. */
+    bool busy; /**< True while a chunk is in flight. */
+} VkcStreamSlot;
+
+/**
+ * @brief Chunked executor with a fixed device working set.
+ */
+typedef struct VkcStream {
+    VkcMemoryPool* pool; /**< Pool the working set is allocated from. */
+    VkcStreamInfo info; /**< Pipeline description, with chunk_size resolved. */
+    VkCommandPool command_pool; /**< Pool of the slot command buffers. */
+    VkDescriptorPool descriptor_pool; /**< Pool of the slot descriptor sets. */
+    VkcStagingRing* ring; /**< Uploads, room for every slot plus one chunk. */
+    VkcReadback* readback; /**< Downloads, one slot per chunk in flight. */
+    VkcStreamSlot slots[VKC_STREAM_DEPTH_MAX]; /**< Working set. */
+} VkcStream;
+
+/**
+ * @brief Create a stream and its device working set.
+ *
+ * A zero chunk_size picks VKC_STREAM_CHUNK_SIZE, shrunk to fit a quarter of
+ * the remaining budget of the device-local heap. The chunk size is rounded
+ * down to a whole number of groups and capped by maxStorageBufferRange and
+ * maxComputeWorkGroupCount.
+ *
+ * @param pool Pool to allocate buffers from; its device and callbacks are used
+ *             for every other object.
+ * @param info Pipeline and working set description.
+ * @return Allocated stream, or NULL on failure.
+ */
+VkcStream* vkc_stream_create(VkcMemoryPool* pool, const VkcStreamInfo* info);
+
+/**
+ * @brief Wait for chunks in flight and destroy the stream.
+ *
+ * @param stream Pointer returned by vkc_stream_create().
+ */
+void vkc_stream_free(VkcStream* stream);
+
+/**
+ * @brief Run the pipeline over size bytes of input.
+ *
+ * Blocks until every chunk has been combined.
+ *
+ * @param stream  Stream to run.
+ * @param size    Total input size in bytes.
+ * @param read    Called once per chunk to fill staging memory.
+ * @param combine Called once per chunk with its output.
+ * @param user    Argument passed to read and combine.
+ * @return true on success, false on failure.
+ */
+bool vkc_stream_run(
+    VkcStream* stream,
+    VkDeviceSize size,
+    VkcStreamRead read,
+    VkcStreamCombine combine,
+    void* user
+);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // VKC_STREAM_H
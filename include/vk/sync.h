@@ -0,0 +1,83 @@
+/**
+ * @file include/vk/sync.h
+ * @brief Retirement points for GPU work.
+ *
+ * A VkcSyncPoint names the moment a submission completes, either as a fence
+ * or as a value on a timeline semaphore. Modules that recycle host-visible or
+ * device memory after the GPU is done with it (staging rings, readback
+ * buffers) tag their regions with a sync point and poll it instead of idling
+ * the queue.
+ *
+ * A fence used as a sync point must not be reset while anything tagged with
+ * it is still pending; timeline semaphores have no such restriction.
+ */
+
+#ifndef VKC_SYNC_H
+#define VKC_SYNC_H
+
+#include <vulkan/vulkan.h>
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief A fence or timeline semaphore value that signals completion.
+ */
+typedef struct VkcSyncPoint {
+    VkFence fence; /**< Fence signaled by the submission, or VK_NULL_HANDLE. */
+    VkSemaphore semaphore; /**< Timeline semaphore, or VK_NULL_HANDLE. */
+    uint64_t value; /**< Timeline value signaled by the submission. */
+} VkcSyncPoint;
+
+/**
+ * @brief Sync point for a fence.
+ */
+static inline VkcSyncPoint vkc_sync_fence(VkFence fence) {
+    return (VkcSyncPoint) {.fence = fence, .semaphore = VK_NULL_HANDLE, .value = 0};
+}
+
+/**
+ * @brief Sync point for a timeline semaphore value.
+ */
+static inline VkcSyncPoint vkc_sync_timeline(VkSemaphore semaphore, uint64_t value) {
+    return (VkcSyncPoint) {.fence = VK_NULL_HANDLE, .semaphore = semaphore, .value = value};
+}
+
+/**
+ * @brief Check whether a sync point has been reached without blocking.
+ *
+ * An empty sync point is always reached.
+ */
+bool vkc_sync_point_poll(VkDevice device, const VkcSyncPoint* point);
+
+/**
+ * @brief Block until a sync point is reached or the timeout expires.
+ *
+ * @param device  Device the fence or semaphore belongs to.
+ * @param point   Sync point to wait on.
+ * @param timeout Timeout in nanoseconds, UINT64_MAX to wait forever.
+ * @return true if the point was reached, false on timeout or error.
+ */
+bool vkc_sync_point_wait(VkDevice device, const VkcSyncPoint* point, uint64_t timeout);
+
+/**
+ * @brief Record the barrier that ends a command buffer of compute work.
+ *
+ * Shader writes recorded so far become visible to every later command, to
+ * later submissions on any queue, and to the host once the submission's sync
+ * point is reached. Recording it last lets a caller hand the results to code
+ * that knows nothing about how they were produced.
+ *
+ * @param command Command buffer being recorded.
+ */
+void vkc_sync_compute_barrier(VkCommandBuffer command);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // VKC_SYNC_H
@@ -0,0 +1,136 @@
+/**
+ * @file include/vk/trace.h
+ * @brief Binary allocation trace capture for the Vulkan host allocator.
+ *
+ * A trace file starts with a VkcTraceHeader followed by a flat array of
+ * fixed-size VkcTraceRecord entries, one per allocation callback, in the order
+ * the calls completed. Records are written in host byte order.
+ *
+ * While a trace is active every callback is serialized behind the trace mutex
+ * so that the recorded order is a valid replay order: an address never appears
+ * in a new allocation before the record releasing it.
+ */
+
+#ifndef VKC_TRACE_H
+#define VKC_TRACE_H
+
+#include "allocator/page.h"
+
+#include <pthread.h>
+#include <stdatomic.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief File signature stored in VkcTraceHeader::magic.
+ */
+#define VKC_TRACE_MAGIC "VKCTRACE"
+
+/**
+ * @brief Current trace format version.
+ */
+#define VKC_TRACE_VERSION 1
+
+/**
+ * @brief Kind of allocation callback recorded.
+ */
+typedef enum VkcTraceOp {
+    VKC_TRACE_MALLOC, /**< pfnAllocation. */
+    VKC_TRACE_REALLOC, /**< pfnReallocation. */
+    VKC_TRACE_FREE, /**< pfnFree. */
+} VkcTraceOp;
+
+/**
+ * @brief Header at the start of every trace file.
+ */
+typedef struct VkcTraceHeader {
+    char magic[8]; /**< VKC_TRACE_MAGIC without the terminator. */
+    uint32_t version; /**< VKC_TRACE_VERSION. */
+    uint32_t record_size; /**< sizeof(VkcTraceRecord) of the writer. */
+} VkcTraceHeader;
+
+/**
+ * @brief A single recorded allocation callback.
+ */
+typedef struct VkcTraceRecord {
+    uint64_t timestamp; /**< Nanoseconds since the trace started. */
+    uint64_t address; /**< Returned (or freed) address, 0 on failure. */
+    uint64_t original; /**< Original address of a reallocation, else 0. */
+    uint64_t size; /**< Requested size in bytes. */
+    uint32_t alignment; /**< Requested alignment in bytes. */
+    uint32_t thread; /**< Sequential id of the calling thread. */
+    uint8_t op; /**< VkcTraceOp of the call. */
+    uint8_t scope; /**< VkSystemAllocationScope of the call. */
+    uint8_t reserved[6]; /**< Zero. */
+} VkcTraceRecord;
+
+/**
+ * @brief Trace writer shared by every thread.
+ */
+typedef struct VkcTrace {
+    pthread_mutex_t mutex; /**< Serializes traced callbacks and writes. */
+    FILE* file; /**< Output stream, or NULL while inactive. */
+    uint64_t start; /**< Monotonic time the trace was opened at. */
+    atomic_bool active; /**< Fast check for the callbacks. */
+} VkcTrace;
+
+/**
+ * @brief Create an inactive trace writer.
+ *
+ * @param pager Allocator used for the writer.
+ * @return Allocated writer, or NULL on failure.
+ */
+VkcTrace* vkc_trace_create(PageAllocator* pager);
+
+/**
+ * @brief Close any open trace and destroy the writer.
+ */
+void vkc_trace_free(VkcTrace* trace, PageAllocator* pager);
+
+/**
+ * @brief Start recording to the given file, truncating it.
+ *
+ * @return true on success, false if the file cannot be written.
+ */
+bool vkc_trace_open(VkcTrace* trace, const char* path);
+
+/**
+ * @brief Stop recording and flush the file.
+ */
+void vkc_trace_close(VkcTrace* trace);
+
+/**
+ * @brief Check whether callbacks should be recorded.
+ */
+static inline bool vkc_trace_active(VkcTrace* trace) {
+    return trace && atomic_load_explicit(&trace->active, memory_order_relaxed);
+}
+
+/**
+ * @brief Acquire the trace mutex around a traced callback.
+ *
+ * @return true if the trace is still open and must be written to.
+ */
+bool vkc_trace_lock(VkcTrace* trace);
+
+/**
+ * @brief Release the trace mutex.
+ */
+void vkc_trace_unlock(VkcTrace* trace);
+
+/**
+ * @brief Append a record. The caller must hold the trace lock.
+ */
+void vkc_trace_write(VkcTrace* trace, VkcTraceRecord record);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // VKC_TRACE_H
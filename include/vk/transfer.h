@@ -0,0 +1,159 @@
+/**
+ * @file include/vk/transfer.h
+ * @brief Copies on a dedicated transfer queue, handed to and from compute.
+ *
+ * Discrete GPUs expose transfer-only queue families backed by DMA engines. A
+ * VkcTransfer records uploads and readbacks into its own command buffers and
+ * submits them there, so PCIe copies for one chunk of work overlap kernels
+ * running on the compute queue for another.
+ *
+ * Buffers are created with exclusive sharing, so a buffer written on one
+ * family and read on the other changes ownership:
+ *
+ *   1. the giving queue records vkc_transfer_release() after its last use,
+ *   2. the receiving submission waits on the giving submission's ticket, and
+ *   3. the receiving queue records vkc_transfer_acquire() before its first use.
+ *
+ * A buffer whose contents are about to be overwritten needs no transfer, only
+ * the wait.
+ *
+ * Without a transfer queue, as on lavapipe, copies are submitted to the
+ * compute queue instead. Releases then record nothing and acquires record a
+ * plain memory barrier, so callers use one code path for both.
+ *
+ * A transfer is not thread-safe. Use one per recording thread; the queues it
+ * submits to may be shared.
+ */
+
+#ifndef VKC_TRANSFER_H
+#define VKC_TRANSFER_H
+
+#include "vk/queue.h"
+#include <vulkan/vulkan.h>
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief Upper bound on the copy submissions in flight.
+ */
+#define VKC_TRANSFER_DEPTH_MAX 8
+
+/**
+ * @brief Which way a buffer changes hands.
+ */
+typedef enum VkcTransferDirection {
+    VKC_TRANSFER_TO_COMPUTE, /**< Uploaded on the transfer queue, used by compute. */
+    VKC_TRANSFER_TO_HOST, /**< Written by compute, read back on the transfer queue. */
+} VkcTransferDirection;
+
+/**
+ * @brief Copy command buffers bound to a transfer queue.
+ */
+typedef struct VkcTransfer {
+    VkcQueue* queue; /**< Queue copies are submitted to. */
+    VkcQueue* compute; /**< Queue buffers are handed to and from. */
+    bool dedicated; /**< The queues' families differ; ownership is transferred. */
+    VkCommandPool command_pool; /**< Pool on queue's family. */
+    VkCommandBuffer commands[VKC_TRANSFER_DEPTH_MAX]; /**< Copy buffers, round-robin. */
+    uint64_t tickets[VKC_TRANSFER_DEPTH_MAX]; /**< Last submission of each buffer. */
+    uint32_t depth; /**< Number of command buffers. */
+    uint32_t next; /**< Buffer the next copy is recorded into. */
+    bool recording; /**< A buffer is open between begin and submit. */
+    uint64_t submissions; /**< Copy submissions so far. */
+} VkcTransfer;
+
+/**
+ * @brief Create copy command buffers for a transfer queue.
+ *
+ * @param transfer Queue of a transfer-only family, or NULL to copy on compute.
+ * @param compute  Compute queue buffers are handed to. Its pager and
+ *                 callbacks are used for the transfer.
+ * @param depth    Copy submissions in flight, 1 to VKC_TRANSFER_DEPTH_MAX.
+ * @return Allocated transfer, or NULL on failure.
+ */
+VkcTransfer* vkc_transfer_create(VkcQueue* transfer, VkcQueue* compute, uint32_t depth);
+
+/**
+ * @brief Wait for every copy in flight and destroy the transfer.
+ *
+ * The queues are not destroyed.
+ *
+ * @param transfer Pointer returned by vkc_transfer_create().
+ */
+void vkc_transfer_free(VkcTransfer* transfer);
+
+/**
+ * @brief Open the next copy command buffer.
+ *
+ * Waits for the buffer's previous submission if it is still in flight.
+ * Record copies with e.g. vkc_staging_ring_copy() or vkc_readback_copy().
+ *
+ * @return Command buffer in the recording state, or VK_NULL_HANDLE on failure.
+ */
+VkCommandBuffer vkc_transfer_begin(VkcTransfer* transfer);
+
+/**
+ * @brief Close and discard the open copy command buffer.
+ */
+void vkc_transfer_cancel(VkcTransfer* transfer);
+
+/**
+ * @brief Close and submit the open copy command buffer.
+ *
+ * @param transfer Transfer to submit.
+ * @param deps     Waits and prepare hook, or NULL. Its commands are ignored.
+ * @return Ticket on transfer->queue, or 0 on failure.
+ */
+uint64_t vkc_transfer_submit(VkcTransfer* transfer, const VkcQueueSubmit* deps);
+
+/**
+ * @brief Record the giving half of an ownership transfer.
+ *
+ * @param transfer  Transfer the queues belong to.
+ * @param command   Command buffer of the giving queue.
+ * @param direction Which way the buffer is handed.
+ * @param buffer    Buffer to hand over, whole.
+ * @param stage     Stages of the giving queue's last use.
+ * @param access    Writes of the giving queue's last use.
+ */
+void vkc_transfer_release(
+    const VkcTransfer* transfer,
+    VkCommandBuffer command,
+    VkcTransferDirection direction,
+    VkBuffer buffer,
+    VkPipelineStageFlags stage,
+    VkAccessFlags access
+);
+
+/**
+ * @brief Record the receiving half of an ownership transfer.
+ *
+ * The receiving submission must wait on the giving ticket at one of the
+ * stages in stage.
+ *
+ * @param transfer  Transfer the queues belong to.
+ * @param command   Command buffer of the receiving queue.
+ * @param direction Which way the buffer is handed.
+ * @param buffer    Buffer to take over, whole.
+ * @param stage     Stages of the receiving queue's first use.
+ * @param access    Accesses of the receiving queue's first use.
+ */
+void vkc_transfer_acquire(
+    const VkcTransfer* transfer,
+    VkCommandBuffer command,
+    VkcTransferDirection direction,
+    VkBuffer buffer,
+    VkPipelineStageFlags stage,
+    VkAccessFlags access
+);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // VKC_TRANSFER_H
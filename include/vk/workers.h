@@ -0,0 +1,219 @@
+/**
+ * @file include/vk/workers.h
+ * @brief Work-stealing host threads for parallel command recording.
+ *
+ * Recording is CPU work, and a VkCommandPool is externally synchronized, so
+ * command buffers from one pool cannot be recorded on two threads at once. A
+ * VkcWorkers pool runs one thread per core, each with its own command pool
+ * on the queue's family, and spreads tasks over them:
+ *
+ *   - every worker owns a deque; it pushes and pops its own tasks at the
+ *     back, newest first, which keeps recently touched data in cache,
+ *   - an idle worker steals the oldest task from the front of another
+ *     worker's deque, so uneven tasks balance without a central queue, and
+ *   - tasks posted from outside the pool are dealt round-robin.
+ *
+ * Tasks are plain callbacks, so host-side pre- and post-processing runs on
+ * the same threads as recording.
+ *
+ * Workers never touch the VkQueue. vkc_workers_record() records many command
+ * buffers in parallel and hands them back, and the thread owning the queue
+ * submits them, typically all in one vkc_queue_submit().
+ *
+ * Buffers from vkc_worker_command() stay valid until vkc_workers_reset(),
+ * which recycles every worker's pool at once once their submissions have
+ * completed.
+ *
+ * vkc_workers_post() and vkc_worker_post() are thread-safe. The remaining
+ * calls are made by the owning thread, never from inside a task.
+ */
+
+#ifndef VKC_WORKERS_H
+#define VKC_WORKERS_H
+
+#include "allocator/page.h"
+#include "vk/queue.h"
+#include <vulkan/vulkan.h>
+
+#include <pthread.h>
+#include <stdalign.h>
+#include <stdatomic.h>
+#include <stdbool.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief Upper bound on the threads of a pool.
+ */
+#define VKC_WORKERS_MAX 64
+
+/**
+ * @brief Count argument sizing the pool to the online processors.
+ */
+#define VKC_WORKERS_AUTO 0
+
+typedef struct VkcWorker VkcWorker;
+typedef struct VkcWorkers VkcWorkers;
+
+/**
+ * @brief Work run on some worker's thread.
+ *
+ * @param worker Worker running the task; its command pool is free to use.
+ * @param index  Index the task was posted with.
+ * @param user   Argument the task was posted with.
+ */
+typedef void (*VkcWorkerTask)(VkcWorker* worker, uint32_t index, void* user);
+
+/**
+ * @brief Record one command buffer for vkc_workers_record().
+ *
+ * @param command Command buffer, already begun; it is ended by the caller.
+ * @param index   Index of the buffer, 0 to count - 1.
+ * @param user    Argument passed to vkc_workers_record().
+ * @return true on success, false to fail the whole recording.
+ */
+typedef bool (*VkcWorkerRecord)(VkCommandBuffer command, uint32_t index, void* user);
+
+/**
+ * @brief A task waiting in a deque.
+ */
+typedef struct VkcWorkerJob {
+    VkcWorkerTask task; /**< Callback to run. */
+    void* user; /**< Argument passed to task. */
+    uint32_t index; /**< Index passed to task. */
+} VkcWorkerJob;
+
+/**
+ * @brief One thread with its deque and command pool.
+ */
+struct VkcWorker {
+    alignas(64) VkcWorkers* workers; /**< Pool the worker belongs to; line-aligned. */
+    uint32_t index; /**< Position in the pool. */
+    pthread_t thread; /**< Thread running the worker. */
+    bool started; /**< thread was created and must be joined. */
+    VkCommandPool command_pool; /**< Used only by this worker's tasks. */
+    VkCommandBuffer* commands; /**< Buffers allocated from command_pool. */
+    uint32_t command_count; /**< Buffers allocated. */
+    uint32_t command_used; /**< Buffers handed out since the last reset. */
+    VkcWorkerJob* jobs; /**< Deque storage, a ring of capacity entries. */
+    uint32_t capacity; /**< Size of jobs, a power of two. */
+    uint64_t head; /**< Front of the deque; thieves take from here. */
+    uint64_t tail; /**< Back of the deque; the owner pushes and pops here. */
+    pthread_mutex_t mutex; /**< Guards the deque. */
+    uint64_t executed; /**< Tasks run by this worker. */
+    uint64_t stolen; /**< Of those, tasks taken from other deques. */
+};
+
+/**
+ * @brief Work-stealing thread pool bound to a queue's family.
+ */
+struct VkcWorkers {
+    PageAllocator* pager; /**< Host allocator for the pool and its deques. */
+    VkcQueue* queue; /**< Queue the recorded buffers are for; never submitted to. */
+    VkcWorker workers[VKC_WORKERS_MAX]; /**< Threads. */
+    uint32_t count; /**< Number of threads. */
+    atomic_uint cursor; /**< Round-robin position for outside posts. */
+    atomic_uint queued; /**< Tasks sitting in deques. */
+    atomic_uint pending; /**< Tasks posted and not yet finished. */
+    bool running; /**< Cleared to stop the threads. */
+    pthread_mutex_t mutex; /**< Guards sleeping and waking. */
+    pthread_cond_t work; /**< Signaled when a task is posted. */
+    pthread_cond_t done; /**< Signaled when pending reaches zero. */
+};
+
+/**
+ * @brief Start a pool of worker threads.
+ *
+ * @param queue Queue whose pager, device, family and callbacks are used.
+ * @param count Number of threads, or VKC_WORKERS_AUTO for one per online
+ *              processor, capped at VKC_WORKERS_MAX.
+ * @return Allocated pool, or NULL on failure.
+ */
+VkcWorkers* vkc_workers_create(VkcQueue* queue, uint32_t count);
+
+/**
+ * @brief Finish posted tasks, stop the threads and destroy the pool.
+ *
+ * Buffers from vkc_worker_command() must no longer be executing.
+ *
+ * @param workers Pointer returned by vkc_workers_create().
+ */
+void vkc_workers_free(VkcWorkers* workers);
+
+/**
+ * @brief Post a task from outside the pool.
+ *
+ * @return true on success, false if the task could not be queued.
+ */
+bool vkc_workers_post(VkcWorkers* workers, VkcWorkerTask task, uint32_t index, void* user);
+
+/**
+ * @brief Post a follow-up task from inside a task, onto the worker's own deque.
+ *
+ * @return true on success, false if the task could not be queued.
+ */
+bool vkc_worker_post(VkcWorker* worker, VkcWorkerTask task, uint32_t index, void* user);
+
+/**
+ * @brief Block until every posted task, and the tasks they posted, finish.
+ */
+void vkc_workers_wait(VkcWorkers* workers);
+
+/**
+ * @brief Run task for indices 0 to count - 1 and wait for all of them.
+ *
+ * Indices are dealt to the workers in contiguous blocks; stealing evens out
+ * the rest.
+ *
+ * @return true on success, false if the tasks could not be queued.
+ */
+bool vkc_workers_for(VkcWorkers* workers, uint32_t count, VkcWorkerTask task, void* user);
+
+/**
+ * @brief A primary command buffer from the worker's pool.
+ *
+ * Called from inside a task. The buffer is in the initial state and stays
+ * the caller's until vkc_workers_reset().
+ *
+ * @return Command buffer, or VK_NULL_HANDLE on failure.
+ */
+VkCommandBuffer vkc_worker_command(VkcWorker* worker);
+
+/**
+ * @brief Record count one-time-submit command buffers in parallel.
+ *
+ * Each buffer comes from the pool of the worker that records it. The caller
+ * submits them, e.g. in one vkc_queue_submit() on workers->queue.
+ *
+ * @param workers  Pool to record on.
+ * @param count    Number of command buffers.
+ * @param record   Fills one buffer.
+ * @param user     Argument passed to record.
+ * @param commands Receives count executable command buffers.
+ * @return true if every buffer was recorded, false otherwise.
+ */
+bool vkc_workers_record(
+    VkcWorkers* workers,
+    uint32_t count,
+    VkcWorkerRecord record,
+    void* user,
+    VkCommandBuffer* commands
+);
+
+/**
+ * @brief Recycle every buffer handed out by vkc_worker_command().
+ *
+ * The buffers' submissions must have completed and no task may be running.
+ *
+ * @return true on success, false if a pool failed to reset.
+ */
+bool vkc_workers_reset(VkcWorkers* workers);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // VKC_WORKERS_H
@@ -1,30 +1,793 @@
 /**
  * @file src/vk/allocator.c
  * @brief Vulkan Host Memory Allocator using a tracked page map.
+ *
+ * Every block handed to Vulkan is prefixed with a VkcBlock header recording
+ * where the block came from. Each calling thread owns a VkcThreadCache:
+ * COMMAND and OBJECT scoped requests are served by the thread's bump arenas,
+ * small CACHE, DEVICE, and INSTANCE scoped requests are recycled through the
+ * thread's magazines, and everything else goes to the tracked PageAllocator.
+ *
+ * Magazines refill in batches from shared size class slabs, so small blocks
+ * cost one PageAllocator entry per slab page rather than one per block.
+ *
+ * Requests of VKC_ALLOCATOR_MMAP_THRESHOLD bytes or more are mapped directly
+ * so that reallocation can grow them with mremap instead of copying. Smaller
+ * reallocations stay in place whenever the block already has room.
+ *
+ * Statistics are counted by the calling thread into its own cache with plain
+ * relaxed stores. Live byte deltas accumulate locally and are folded into the
+ * shared totals once they exceed VKC_ALLOCATOR_STATS_FLUSH, which is the only
+ * point where threads contend on the counters.
  */
 
+// mremap() is a GNU extension and must be requested before any system header.
+#ifndef _GNU_SOURCE
+    #define _GNU_SOURCE
+#endif
+
 #include "core/posix.h"
 #include "core/memory.h"
 #include "core/logger.h"
 #include "allocator/page.h"
+#include "vk/arena.h"
+#include "vk/cache.h"
+#include "vk/slab.h"
+#include "vk/trace.h"
 #include "vk/allocator.h"
 
+#include <pthread.h>
+#include <stdlib.h>
+#include <sys/mman.h>
+#include <unistd.h>
+
 /**
  * @section Private
  * {@
  */
 
-void* VKAPI_CALL
-vkc_malloc(void* pUserData, size_t size, size_t alignment, VkSystemAllocationScope scope) {
-    (void) scope;
+/**
+ * @brief Number of allocation scopes backed by a bump arena.
+ *
+ * VK_SYSTEM_ALLOCATION_SCOPE_COMMAND (0) and VK_SYSTEM_ALLOCATION_SCOPE_OBJECT (1)
+ * index directly into the arena table of a thread cache.
+ */
+#define VKC_ALLOCATOR_ARENA_COUNT 2
+
+/**
+ * @brief Live byte delta a thread accumulates before folding it into the totals.
+ */
+#define VKC_ALLOCATOR_STATS_FLUSH (64 * 1024)
+
+/**
+ * @brief Smallest request, in bytes, served by a private anonymous mapping.
+ */
+#define VKC_ALLOCATOR_MMAP_THRESHOLD (64 * 1024)
+
+/**
+ * @brief Huge page size mappings are rounded and aligned to when huge pages are enabled.
+ */
+#define VKC_ALLOCATOR_HUGE_PAGE_SIZE (2 * 1024 * 1024)
+
+typedef enum VkcBlockKind {
+    VKC_BLOCK_PAGE, /**< Tracked by the PageAllocator. */
+    VKC_BLOCK_ARENA, /**< Bump allocated from a scope arena chunk. */
+    VKC_BLOCK_CACHE, /**< Slab slot recycled through a thread cache. */
+    VKC_BLOCK_MAP, /**< Private anonymous mapping resized with mremap. */
+} VkcBlockKind;
+
+/**
+ * @brief Registry link stored at the start of every mapped block.
+ */
+typedef struct VkcMapNode {
+    alignas(16) struct VkcMapNode* next; /**< Next mapping in the registry. */
+    struct VkcMapNode* prev; /**< Previous mapping in the registry. */
+    size_t length; /**< Length of the mapping in bytes. */
+    size_t granule; /**< Page size the length is rounded to. */
+} VkcMapNode;
+
+/**
+ * @brief Header stored immediately before every pointer returned to Vulkan.
+ */
+typedef struct VkcBlock {
+    alignas(16) void* origin; /**< Owning arena chunk, slab page, or mapping, or NULL. */
+    VkcThreadCache* cache; /**< Owning thread cache, or NULL for page blocks. */
+    size_t size; /**< Requested size in bytes. */
+    uint32_t offset; /**< Distance from the allocation base to the user pointer. */
+    uint8_t kind; /**< VkcBlockKind of the allocation. */
+    uint8_t scope; /**< VkSystemAllocationScope of the request. */
+    uint8_t size_class; /**< Thread cache size class of cached blocks. */
+} VkcBlock;
+
+/**
+ * @brief Folded live byte totals shared by every thread.
+ */
+typedef struct VkcAllocatorTotals {
+    atomic_int_fast64_t live; /**< Folded live bytes. */
+    atomic_int_fast64_t peak; /**< High water mark of live. */
+    atomic_int_fast64_t internal; /**< Folded driver-internal bytes. */
+    atomic_int_fast64_t internal_peak; /**< High water mark of internal. */
+} VkcAllocatorTotals;
+
+struct VkcAllocatorContext {
+    PageAllocator* pager; /**< Tracked allocator backing every block. */
+    VkAllocationCallbacks callbacks; /**< Vulkan callbacks bound to this context. */
+    VkcThreadCache* caches; /**< Registry of every thread cache created. */
+    VkcMapNode* maps; /**< Registry of every live mapped block. */
+    pthread_mutex_t mutex; /**< Guards the cache and mapping registries. */
+    pthread_key_t key; /**< Thread cache of the calling thread. */
+    size_t page_size; /**< System page size used to round mappings. */
+    VkcAllocatorFlags flags; /**< Options selected at creation. */
+    size_t huge_page_threshold; /**< Smallest mapping backed by huge pages. */
+    VkcSlab* slabs[VKC_CACHE_CLASS_COUNT]; /**< Slot storage for each size class. */
+    VkcTrace* trace; /**< Allocation trace writer. */
+    VkcAllocatorTotals scopes[VKC_ALLOCATOR_SCOPE_COUNT]; /**< Totals per allocation scope. */
+    VkcAllocatorTotals total; /**< Totals over every scope. */
+    VkcCacheStats orphan[VKC_ALLOCATOR_SCOPE_COUNT]; /**< Counters of cacheless threads. */
+};
+
+static inline size_t vkc_block_alignment(size_t alignment) {
+    return alignment > alignof(VkcBlock) ? alignment : alignof(VkcBlock);
+}
+
+static inline size_t vkc_block_offset(size_t alignment) {
+    // Both values are powers of two, so the larger one keeps the user pointer aligned.
+    return alignment > sizeof(VkcBlock) ? alignment : sizeof(VkcBlock);
+}
+
+static inline VkcBlock* vkc_block_header(void* pointer) {
+    return (VkcBlock*) pointer - 1;
+}
+
+static inline void* vkc_block_base(VkcBlock* block) {
+    return (unsigned char*) (block + 1) - block->offset;
+}
+
+static void* vkc_block_init(
+    void* base, size_t offset, size_t size, VkSystemAllocationScope scope, VkcBlock block
+) {
+    void* pointer = (unsigned char*) base + offset;
+    block.size = size;
+    block.offset = (uint32_t) offset;
+    block.scope = (uint8_t) scope;
+    *vkc_block_header(pointer) = block;
+    return pointer;
+}
+
+static inline size_t vkc_map_offset(size_t alignment) {
+    size_t header = sizeof(VkcMapNode) + sizeof(VkcBlock);
+    return alignment > header ? alignment : header;
+}
+
+static inline size_t vkc_map_length(size_t size, size_t granule) {
+    return (size + granule - 1) & ~(granule - 1);
+}
+
+/**
+ * @brief Map a huge page aligned region and ask for transparent huge pages.
+ */
+static void* vkc_map_transparent(size_t length) {
+    size_t granule = VKC_ALLOCATOR_HUGE_PAGE_SIZE;
+    unsigned char* region = mmap(
+        NULL, length + granule, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0
+    );
+    if (MAP_FAILED == region) {
+        return MAP_FAILED;
+    }
+
+    // Trim the slack so the mapping starts on a huge page boundary.
+    unsigned char* base = (unsigned char*) vkc_map_length((uintptr_t) region, granule);
+    size_t head = (size_t) (base - region);
+    if (head) {
+        munmap(region, head);
+    }
+    if (granule - head) {
+        munmap(base + length, granule - head);
+    }
+
+#ifdef MADV_HUGEPAGE
+    madvise(base, length, MADV_HUGEPAGE);
+#endif
+
+    return base;
+}
+
+static void vkc_map_link(VkcAllocatorContext* context, VkcMapNode* node) {
+    pthread_mutex_lock(&context->mutex);
+    node->prev = NULL;
+    node->next = context->maps;
+    if (context->maps) {
+        context->maps->prev = node;
+    }
+    context->maps = node;
+    pthread_mutex_unlock(&context->mutex);
+}
+
+static void vkc_map_unlink(VkcAllocatorContext* context, VkcMapNode* node) {
+    pthread_mutex_lock(&context->mutex);
+    if (node->prev) {
+        node->prev->next = node->next;
+    } else {
+        context->maps = node->next;
+    }
+    if (node->next) {
+        node->next->prev = node->prev;
+    }
+    pthread_mutex_unlock(&context->mutex);
+}
 
-    PageAllocator* allocator = (PageAllocator*) pUserData;
-    if (NULL == allocator) {
-        LOG_ERROR("[VK_ALLOC] Missing allocation context (PageAllocator)");
+static void* vkc_map_malloc(
+    VkcAllocatorContext* context, size_t size, size_t alignment, VkSystemAllocationScope scope
+) {
+    size_t offset = vkc_map_offset(alignment);
+    bool huge = (context->flags & VKC_ALLOCATOR_HUGE_PAGES_BIT)
+                && offset + size >= context->huge_page_threshold;
+    size_t granule = huge ? VKC_ALLOCATOR_HUGE_PAGE_SIZE : context->page_size;
+    size_t length = vkc_map_length(offset + size, granule);
+
+    int flags = MAP_PRIVATE | MAP_ANONYMOUS;
+    void* base = MAP_FAILED;
+    if (huge) {
+        // Prefer reserved hugetlbfs pages and fall back to transparent huge pages.
+#ifdef MAP_HUGETLB
+        base = mmap(NULL, length, PROT_READ | PROT_WRITE, flags | MAP_HUGETLB, -1, 0);
+#endif
+        if (MAP_FAILED == base) {
+            base = vkc_map_transparent(length);
+        }
+    } else {
+        base = mmap(NULL, length, PROT_READ | PROT_WRITE, flags, -1, 0);
+    }
+
+    if (MAP_FAILED == base) {
+        LOG_ERROR("[VkcAllocator] Failed to map %zu bytes.", length);
         return NULL;
     }
 
-    void* address = page_malloc(allocator, size, alignment);
+    VkcMapNode* node = (VkcMapNode*) base;
+    node->length = length;
+    node->granule = granule;
+    vkc_map_link(context, node);
+
+    return vkc_block_init(
+        base, offset, size, scope, (VkcBlock) {.kind = VKC_BLOCK_MAP, .origin = node}
+    );
+}
+
+static void vkc_map_free(VkcAllocatorContext* context, VkcMapNode* node) {
+    vkc_map_unlink(context, node);
+    munmap(node, node->length);
+}
+
+static void* vkc_map_resize(VkcAllocatorContext* context, VkcBlock* block, size_t size) {
+    VkcMapNode* node = (VkcMapNode*) block->origin;
+    size_t offset = block->offset;
+    size_t length = vkc_map_length(offset + size, node->granule);
+    if (length == node->length) {
+        return block + 1;
+    }
+
+    // Unlink first: a moving mremap invalidates the node address.
+    vkc_map_unlink(context, node);
+
+    void* base = mremap(node, node->length, length, 0);
+    if (MAP_FAILED == base) {
+        base = mremap(node, node->length, length, MREMAP_MAYMOVE);
+    }
+
+    if (MAP_FAILED == base) {
+        vkc_map_link(context, node);
+        return NULL;
+    }
+
+    node = (VkcMapNode*) base;
+    node->length = length;
+    vkc_map_link(context, node);
+
+    // The header moved with the mapping; only its origin needs fixing up.
+    void* pointer = (unsigned char*) base + offset;
+    vkc_block_header(pointer)->origin = node;
+    return pointer;
+}
+
+static inline void vkc_stats_add(atomic_uint_fast64_t* counter, uint64_t value) {
+    // Counters have a single writer, so a relaxed load and store avoids a locked add.
+    atomic_store_explicit(
+        counter, atomic_load_explicit(counter, memory_order_relaxed) + value, memory_order_relaxed
+    );
+}
+
+static inline void vkc_stats_max(atomic_int_fast64_t* peak, int_fast64_t value) {
+    int_fast64_t current = atomic_load_explicit(peak, memory_order_relaxed);
+    while (value > current
+           && !atomic_compare_exchange_weak_explicit(
+               peak, &current, value, memory_order_relaxed, memory_order_relaxed
+           )) {}
+}
+
+static inline uint32_t vkc_stats_scope(VkSystemAllocationScope scope) {
+    return (uint32_t) scope < VKC_ALLOCATOR_SCOPE_COUNT ? (uint32_t) scope
+                                                         : VKC_ALLOCATOR_SCOPE_COUNT - 1;
+}
+
+static inline uint32_t vkc_stats_bin(size_t size) {
+    uint32_t bin = 0;
+    for (size_t limit = 16; size > limit && bin < VKC_ALLOCATOR_HISTOGRAM_BINS - 1; limit <<= 1) {
+        bin++;
+    }
+    return bin;
+}
+
+static VkcCacheStats* vkc_stats_get(
+    VkcAllocatorContext* context, VkcThreadCache* cache, VkSystemAllocationScope scope
+) {
+    uint32_t index = vkc_stats_scope(scope);
+    return cache ? &cache->stats[index] : &context->orphan[index];
+}
+
+/**
+ * @brief Apply a live byte delta and fold it into the totals once it grows large.
+ */
+static void vkc_stats_track(
+    VkcAllocatorContext* context,
+    VkcThreadCache* cache,
+    VkSystemAllocationScope scope,
+    int_fast64_t delta,
+    bool internal
+) {
+    VkcCacheStats* stats = vkc_stats_get(context, cache, scope);
+    atomic_int_fast64_t* pending = internal ? &stats->internal_pending : &stats->pending;
+
+    int_fast64_t value;
+    if (cache) {
+        value = atomic_load_explicit(pending, memory_order_relaxed) + delta;
+    } else {
+        // Threads without a cache share the orphan counters.
+        value = atomic_fetch_add_explicit(pending, delta, memory_order_relaxed) + delta;
+    }
+
+    if (value > -VKC_ALLOCATOR_STATS_FLUSH && value < VKC_ALLOCATOR_STATS_FLUSH) {
+        if (cache) {
+            atomic_store_explicit(pending, value, memory_order_relaxed);
+        }
+        return;
+    }
+
+    if (cache) {
+        atomic_store_explicit(pending, 0, memory_order_relaxed);
+    } else {
+        atomic_fetch_sub_explicit(pending, value, memory_order_relaxed);
+    }
+
+    VkcAllocatorTotals* totals[] = {&context->scopes[vkc_stats_scope(scope)], &context->total};
+    for (uint32_t i = 0; i < 2; i++) {
+        atomic_int_fast64_t* live = internal ? &totals[i]->internal : &totals[i]->live;
+        atomic_int_fast64_t* peak = internal ? &totals[i]->internal_peak : &totals[i]->peak;
+        vkc_stats_max(peak, atomic_fetch_add_explicit(live, value, memory_order_relaxed) + value);
+    }
+}
+
+static void vkc_stats_count(
+    VkcAllocatorContext* context,
+    VkcThreadCache* cache,
+    VkSystemAllocationScope scope,
+    size_t size,
+    bool reallocation
+) {
+    VkcCacheStats* stats = vkc_stats_get(context, cache, scope);
+    atomic_uint_fast64_t* counter = reallocation ? &stats->reallocations : &stats->allocations;
+    atomic_uint_fast64_t* bin = &stats->histogram[vkc_stats_bin(size)];
+
+    if (cache) {
+        vkc_stats_add(counter, 1);
+        vkc_stats_add(bin, 1);
+    } else {
+        atomic_fetch_add_explicit(counter, 1, memory_order_relaxed);
+        atomic_fetch_add_explicit(bin, 1, memory_order_relaxed);
+    }
+}
+
+static void vkc_stats_count_free(
+    VkcAllocatorContext* context, VkcThreadCache* cache, VkSystemAllocationScope scope
+) {
+    VkcCacheStats* stats = vkc_stats_get(context, cache, scope);
+    if (cache) {
+        vkc_stats_add(&stats->frees, 1);
+    } else {
+        atomic_fetch_add_explicit(&stats->frees, 1, memory_order_relaxed);
+    }
+}
+
+static void vkc_stats_accumulate(VkcAllocatorScopeStats* out, VkcCacheStats* stats) {
+    out->live_bytes += atomic_load_explicit(&stats->pending, memory_order_relaxed);
+    out->internal_bytes += atomic_load_explicit(&stats->internal_pending, memory_order_relaxed);
+    out->allocation_count += atomic_load_explicit(&stats->allocations, memory_order_relaxed);
+    out->reallocation_count += atomic_load_explicit(&stats->reallocations, memory_order_relaxed);
+    out->free_count += atomic_load_explicit(&stats->frees, memory_order_relaxed);
+    out->internal_allocation_count
+        += atomic_load_explicit(&stats->internal_allocations, memory_order_relaxed);
+    for (uint32_t i = 0; i < VKC_ALLOCATOR_HISTOGRAM_BINS; i++) {
+        out->histogram[i] += atomic_load_explicit(&stats->histogram[i], memory_order_relaxed);
+    }
+}
+
+static void vkc_stats_finish(VkcAllocatorScopeStats* out, VkcAllocatorTotals* totals) {
+    // Pending deltas may be negative, so sum as signed before clamping.
+    int64_t live = (int64_t) out->live_bytes + atomic_load(&totals->live);
+    int64_t internal = (int64_t) out->internal_bytes + atomic_load(&totals->internal);
+
+    // Remember the observed value so later snapshots never report a lower peak.
+    vkc_stats_max(&totals->peak, live);
+    vkc_stats_max(&totals->internal_peak, internal);
+    int64_t peak = atomic_load(&totals->peak);
+    int64_t internal_peak = atomic_load(&totals->internal_peak);
+
+    out->live_bytes = live > 0 ? (uint64_t) live : 0;
+    out->internal_bytes = internal > 0 ? (uint64_t) internal : 0;
+    out->peak_bytes = peak > 0 ? (uint64_t) peak : 0;
+    out->internal_peak_bytes = internal_peak > 0 ? (uint64_t) internal_peak : 0;
+}
+
+static void vkc_stats_collect(VkcAllocatorContext* context, VkcAllocatorStats* stats) {
+    memset(stats, 0, sizeof(*stats));
+
+    pthread_mutex_lock(&context->mutex);
+    for (uint32_t s = 0; s < VKC_ALLOCATOR_SCOPE_COUNT; s++) {
+        VkcAllocatorScopeStats* scope = &stats->scopes[s];
+        for (VkcThreadCache* it = context->caches; it; it = it->next) {
+            vkc_stats_accumulate(scope, &it->stats[s]);
+            vkc_stats_accumulate(&stats->total, &it->stats[s]);
+        }
+        vkc_stats_accumulate(scope, &context->orphan[s]);
+        vkc_stats_accumulate(&stats->total, &context->orphan[s]);
+        vkc_stats_finish(scope, &context->scopes[s]);
+    }
+    pthread_mutex_unlock(&context->mutex);
+
+    vkc_stats_finish(&stats->total, &context->total);
+}
+
+static void vkc_thread_cache_exit(void* value) {
+    // Leave the magazines warm for whichever thread adopts this cache next.
+    VkcThreadCache* cache = (VkcThreadCache*) value;
+    atomic_store_explicit(&cache->active, false, memory_order_release);
+}
+
+static VkcThreadCache* vkc_thread_cache_get(VkcAllocatorContext* context) {
+    VkcThreadCache* cache = pthread_getspecific(context->key);
+    if (cache) {
+        return cache;
+    }
+
+    pthread_mutex_lock(&context->mutex);
+
+    // Adopt a cache abandoned by an exited thread before creating a new one.
+    for (VkcThreadCache* it = context->caches; it; it = it->next) {
+        bool expected = false;
+        if (atomic_compare_exchange_strong(&it->active, &expected, true)) {
+            cache = it;
+            break;
+        }
+    }
+
+    if (!cache) {
+        cache = vkc_thread_cache_create(context->pager);
+        if (cache) {
+            cache->next = context->caches;
+            context->caches = cache;
+        }
+    }
+
+    pthread_mutex_unlock(&context->mutex);
+
+    if (cache) {
+        pthread_setspecific(context->key, cache);
+    }
+
+    return cache;
+}
+
+static inline void vkc_block_release(VkcAllocatorContext* context, VkcBlock* block) {
+    vkc_slab_release(
+        context->slabs[block->size_class], (VkcSlabPage*) block->origin, vkc_block_base(block)
+    );
+}
+
+static void vkc_thread_cache_drain(VkcAllocatorContext* context, VkcThreadCache* cache) {
+    VkcCacheNode* node = vkc_thread_cache_collect(cache);
+    while (node) {
+        VkcCacheNode* next = node->next;
+        VkcBlock* block = vkc_block_header(node);
+        if (!vkc_thread_cache_push(cache, block->size_class, node)) {
+            vkc_block_release(context, block);
+        }
+        node = next;
+    }
+}
+
+static void vkc_thread_cache_refill(
+    VkcAllocatorContext* context, VkcThreadCache* cache, uint32_t size_class
+) {
+    void* slots[VKC_SLAB_BATCH];
+    VkcSlabPage* pages[VKC_SLAB_BATCH];
+
+    uint32_t count = vkc_slab_malloc(context->slabs[size_class], slots, pages, VKC_SLAB_BATCH);
+    for (uint32_t i = 0; i < count; i++) {
+        // Slot headers are stamped once here and survive every trip through the magazine.
+        void* pointer = vkc_block_init(
+            slots[i],
+            sizeof(VkcBlock),
+            0,
+            VK_SYSTEM_ALLOCATION_SCOPE_COMMAND,
+            (VkcBlock) {
+                .kind = VKC_BLOCK_CACHE,
+                .origin = pages[i],
+                .cache = cache,
+                .size_class = (uint8_t) size_class,
+            }
+        );
+        if (!vkc_thread_cache_push(cache, size_class, pointer)) {
+            vkc_slab_release(context->slabs[size_class], pages[i], slots[i]);
+        }
+    }
+}
+
+static void* vkc_block_malloc(
+    VkcAllocatorContext* context,
+    VkcThreadCache* cache,
+    size_t size,
+    size_t alignment,
+    VkSystemAllocationScope scope
+) {
+    alignment = vkc_block_alignment(alignment);
+    size_t offset = vkc_block_offset(alignment);
+
+    if (cache) {
+        if ((size_t) scope < VKC_ALLOCATOR_ARENA_COUNT) {
+            VkcArenaChunk* chunk = NULL;
+            void* base = vkc_arena_malloc(cache->arenas[scope], offset + size, alignment, &chunk);
+            if (base) {
+                return vkc_block_init(
+                    base,
+                    offset,
+                    size,
+                    scope,
+                    (VkcBlock) {.kind = VKC_BLOCK_ARENA, .origin = chunk, .cache = cache}
+                );
+            }
+        }
+
+        uint32_t size_class = vkc_thread_cache_class(size, alignment);
+        if (VKC_CACHE_CLASS_NONE != size_class) {
+            void* pointer = vkc_thread_cache_pop(cache, size_class);
+            if (!pointer) {
+                vkc_thread_cache_drain(context, cache);
+                pointer = vkc_thread_cache_pop(cache, size_class);
+            }
+            if (!pointer) {
+                vkc_thread_cache_refill(context, cache, size_class);
+                pointer = vkc_thread_cache_pop(cache, size_class);
+            }
+
+            if (pointer) {
+                // Cached classes only accept alignments the slab slots already satisfy.
+                VkcBlock* block = vkc_block_header(pointer);
+                return vkc_block_init(
+                    vkc_block_base(block),
+                    offset,
+                    size,
+                    scope,
+                    (VkcBlock) {
+                        .kind = VKC_BLOCK_CACHE,
+                        .origin = block->origin,
+                        .cache = cache,
+                        .size_class = (uint8_t) size_class,
+                    }
+                );
+            }
+        }
+    }
+
+    // Mapped blocks start page aligned, so they honor any alignment up to a page.
+    if (size >= VKC_ALLOCATOR_MMAP_THRESHOLD && alignment <= context->page_size) {
+        void* pointer = vkc_map_malloc(context, size, alignment, scope);
+        if (pointer) {
+            return pointer;
+        }
+    }
+
+    void* base = page_malloc(context->pager, offset + size, alignment);
+    if (!base) {
+        return NULL;
+    }
+
+    return vkc_block_init(base, offset, size, scope, (VkcBlock) {.kind = VKC_BLOCK_PAGE});
+}
+
+/**
+ * @brief Resize a block without copying its contents.
+ *
+ * @return The (possibly moved) user pointer, or NULL if the block must be reallocated.
+ */
+static void* vkc_block_resize(
+    VkcAllocatorContext* context,
+    void* pointer,
+    size_t size,
+    size_t alignment,
+    VkSystemAllocationScope scope
+) {
+    VkcBlock* block = vkc_block_header(pointer);
+    if (0 != ((uintptr_t) pointer & (vkc_block_alignment(alignment) - 1))) {
+        return NULL;
+    }
+
+    switch ((VkcBlockKind) block->kind) {
+        case VKC_BLOCK_ARENA:
+            // Arena blocks must stay in the arena of their scope.
+            if ((uint8_t) scope != block->scope
+                || !vkc_arena_resize(
+                    block->cache->arenas[block->scope],
+                    (VkcArenaChunk*) block->origin,
+                    vkc_block_base(block),
+                    block->offset + block->size,
+                    block->offset + size
+                )) {
+                return NULL;
+            }
+            break;
+        case VKC_BLOCK_CACHE:
+            if (vkc_thread_cache_class(size, alignment) != block->size_class) {
+                return NULL;
+            }
+            break;
+        case VKC_BLOCK_PAGE:
+            // Shrink in place unless that would strand more than half of the block.
+            if (size > block->size || size < block->size / 2) {
+                return NULL;
+            }
+            break;
+        case VKC_BLOCK_MAP:
+            // A moving mremap only preserves page alignment.
+            if (alignment > context->page_size) {
+                return NULL;
+            }
+            pointer = vkc_map_resize(context, block, size);
+            if (!pointer) {
+                return NULL;
+            }
+            block = vkc_block_header(pointer);
+            break;
+    }
+
+    block->size = size;
+    block->scope = (uint8_t) scope;
+    return pointer;
+}
+
+static void vkc_block_free(VkcAllocatorContext* context, VkcThreadCache* cache, void* pointer) {
+    VkcBlock* block = vkc_block_header(pointer);
+
+    switch ((VkcBlockKind) block->kind) {
+        case VKC_BLOCK_ARENA:
+            vkc_arena_release(block->cache->arenas[block->scope], (VkcArenaChunk*) block->origin);
+            break;
+        case VKC_BLOCK_CACHE: {
+            VkcThreadCache* owner = block->cache;
+            if (owner == cache) {
+                if (!vkc_thread_cache_push(owner, block->size_class, pointer)) {
+                    vkc_block_release(context, block);
+                }
+            } else if (atomic_load_explicit(&owner->active, memory_order_acquire)) {
+                vkc_thread_cache_push_remote(owner, pointer);
+            } else {
+                // Nobody is draining an abandoned cache, so skip the round trip.
+                vkc_block_release(context, block);
+            }
+            break;
+        }
+        case VKC_BLOCK_PAGE:
+            page_free(context->pager, vkc_block_base(block));
+            break;
+        case VKC_BLOCK_MAP:
+            vkc_map_free(context, (VkcMapNode*) block->origin);
+            break;
+    }
+}
+
+static void* vkc_host_malloc(
+    VkcAllocatorContext* context, size_t size, size_t alignment, VkSystemAllocationScope scope
+) {
+    VkcThreadCache* cache = vkc_thread_cache_get(context);
+    void* address = vkc_block_malloc(context, cache, size, alignment, scope);
+    if (address) {
+        vkc_stats_count(context, cache, scope, size, false);
+        vkc_stats_track(context, cache, scope, (int_fast64_t) size, false);
+    }
+    return address;
+}
+
+static void* vkc_host_realloc(
+    VkcAllocatorContext* context,
+    void* original,
+    size_t size,
+    size_t alignment,
+    VkSystemAllocationScope scope
+) {
+    if (NULL == original) {
+        return vkc_host_malloc(context, size, alignment, scope);
+    }
+
+    VkcThreadCache* cache = vkc_thread_cache_get(context);
+    VkcBlock* block = vkc_block_header(original);
+    size_t original_size = block->size;
+    VkSystemAllocationScope original_scope = (VkSystemAllocationScope) block->scope;
+
+    // The spec treats a zero size reallocation as a free.
+    if (0 == size) {
+        vkc_block_free(context, cache, original);
+        vkc_stats_count_free(context, cache, original_scope);
+        vkc_stats_track(context, cache, original_scope, -(int_fast64_t) original_size, false);
+        return NULL;
+    }
+
+    void* address = vkc_block_resize(context, original, size, alignment, scope);
+    if (!address) {
+        address = vkc_block_malloc(context, cache, size, alignment, scope);
+        if (!address) {
+            return NULL;
+        }
+
+        memcpy(address, original, original_size < size ? original_size : size);
+        vkc_block_free(context, cache, original);
+    }
+
+    vkc_stats_count(context, cache, scope, size, true);
+    vkc_stats_track(context, cache, original_scope, -(int_fast64_t) original_size, false);
+    vkc_stats_track(context, cache, scope, (int_fast64_t) size, false);
+
+    return address;
+}
+
+static void vkc_host_free(VkcAllocatorContext* context, void* pointer) {
+    VkcThreadCache* cache = vkc_thread_cache_get(context);
+    VkcBlock* block = vkc_block_header(pointer);
+    size_t size = block->size;
+    VkSystemAllocationScope scope = (VkSystemAllocationScope) block->scope;
+
+    vkc_block_free(context, cache, pointer);
+    vkc_stats_count_free(context, cache, scope);
+    vkc_stats_track(context, cache, scope, -(int_fast64_t) size, false);
+}
+
+static void* VKAPI_CALL
+vkc_malloc(void* pUserData, size_t size, size_t alignment, VkSystemAllocationScope scope) {
+    VkcAllocatorContext* context = (VkcAllocatorContext*) pUserData;
+    if (NULL == context) {
+        LOG_ERROR("[VK_ALLOC] Missing allocation context (VkcAllocatorContext)");
+        return NULL;
+    }
+
+    void* address = NULL;
+    if (vkc_trace_active(context->trace)) {
+        bool traced = vkc_trace_lock(context->trace);
+        address = vkc_host_malloc(context, size, alignment, scope);
+        if (traced) {
+            vkc_trace_write(
+                context->trace,
+                (VkcTraceRecord) {
+                    .op = VKC_TRACE_MALLOC,
+                    .scope = (uint8_t) scope,
+                    .size = size,
+                    .alignment = (uint32_t) alignment,
+                    .address = (uintptr_t) address,
+                }
+            );
+        }
+        vkc_trace_unlock(context->trace);
+    } else {
+        address = vkc_host_malloc(context, size, alignment, scope);
+    }
+
     if (NULL == address) {
         LOG_ERROR("[VK_ALLOC] Allocation failed (size=%zu, align=%zu)", size, alignment);
         return NULL;
@@ -33,19 +796,38 @@ vkc_malloc(void* pUserData, size_t size, size_t alignment, VkSystemAllocationSco
     return address;
 }
 
-void* VKAPI_CALL vkc_realloc(
+static void* VKAPI_CALL vkc_realloc(
     void* pUserData, void* pOriginal, size_t size, size_t alignment, VkSystemAllocationScope scope
 ) {
-    (void) scope;
-
-    PageAllocator* allocator = (PageAllocator*) pUserData;
-    if (NULL == allocator) {
-        LOG_ERROR("[VK_REALLOC] Missing allocation context (PageAllocator)");
+    VkcAllocatorContext* context = (VkcAllocatorContext*) pUserData;
+    if (NULL == context) {
+        LOG_ERROR("[VK_REALLOC] Missing allocation context (VkcAllocatorContext)");
         return NULL;
     }
 
-    void* address = page_realloc(allocator, pOriginal, size, alignment);
-    if (!address) {
+    void* address = NULL;
+    if (vkc_trace_active(context->trace)) {
+        bool traced = vkc_trace_lock(context->trace);
+        address = vkc_host_realloc(context, pOriginal, size, alignment, scope);
+        if (traced) {
+            vkc_trace_write(
+                context->trace,
+                (VkcTraceRecord) {
+                    .op = VKC_TRACE_REALLOC,
+                    .scope = (uint8_t) scope,
+                    .size = size,
+                    .alignment = (uint32_t) alignment,
+                    .address = (uintptr_t) address,
+                    .original = (uintptr_t) pOriginal,
+                }
+            );
+        }
+        vkc_trace_unlock(context->trace);
+    } else {
+        address = vkc_host_realloc(context, pOriginal, size, alignment, scope);
+    }
+
+    if (NULL == address && 0 != size) {
         LOG_ERROR(
             "[VK_REALLOC] Allocation failed (pOriginal=%p, size=%zu, align=%zu)",
             pOriginal,
@@ -58,13 +840,72 @@ void* VKAPI_CALL vkc_realloc(
     return address;
 }
 
-void VKAPI_CALL vkc_free(void* pUserData, void* pMemory) {
-    PageAllocator* allocator = (PageAllocator*) pUserData;
-    if (NULL == allocator || NULL == pMemory) {
+static void VKAPI_CALL vkc_free(void* pUserData, void* pMemory) {
+    VkcAllocatorContext* context = (VkcAllocatorContext*) pUserData;
+    if (NULL == context || NULL == pMemory) {
+        return;
+    }
+
+    if (vkc_trace_active(context->trace)) {
+        bool traced = vkc_trace_lock(context->trace);
+        if (traced) {
+            VkcBlock* block = vkc_block_header(pMemory);
+            vkc_trace_write(
+                context->trace,
+                (VkcTraceRecord) {
+                    .op = VKC_TRACE_FREE,
+                    .scope = block->scope,
+                    .size = block->size,
+                    .address = (uintptr_t) pMemory,
+                }
+            );
+        }
+        vkc_host_free(context, pMemory);
+        vkc_trace_unlock(context->trace);
+        return;
+    }
+
+    vkc_host_free(context, pMemory);
+}
+
+static void VKAPI_CALL vkc_internal_malloc(
+    void* pUserData,
+    size_t size,
+    VkInternalAllocationType allocationType,
+    VkSystemAllocationScope scope
+) {
+    (void) allocationType;
+
+    VkcAllocatorContext* context = (VkcAllocatorContext*) pUserData;
+    if (NULL == context) {
         return;
     }
 
-    page_free(allocator, pMemory);
+    VkcThreadCache* cache = vkc_thread_cache_get(context);
+    VkcCacheStats* stats = vkc_stats_get(context, cache, scope);
+    if (cache) {
+        vkc_stats_add(&stats->internal_allocations, 1);
+    } else {
+        atomic_fetch_add_explicit(&stats->internal_allocations, 1, memory_order_relaxed);
+    }
+    vkc_stats_track(context, cache, scope, (int_fast64_t) size, true);
+}
+
+static void VKAPI_CALL vkc_internal_free(
+    void* pUserData,
+    size_t size,
+    VkInternalAllocationType allocationType,
+    VkSystemAllocationScope scope
+) {
+    (void) allocationType;
+
+    VkcAllocatorContext* context = (VkcAllocatorContext*) pUserData;
+    if (NULL == context) {
+        return;
+    }
+
+    VkcThreadCache* cache = vkc_thread_cache_get(context);
+    vkc_stats_track(context, cache, scope, -(int_fast64_t) size, true);
 }
 
 /** @} */
@@ -74,41 +915,285 @@ void VKAPI_CALL vkc_free(void* pUserData, void* pMemory) {
  * {@
  */
 
-static PageAllocator* _vkc_allocator = NULL;
-static VkAllocationCallbacks _vkc_callbacks = {0};
+VkcAllocatorContext* vkc_allocator_context_create(const VkcAllocatorCreateInfo* info) {
+    if (info && info->huge_page_threshold > 0
+        && info->huge_page_threshold < VKC_ALLOCATOR_MMAP_THRESHOLD) {
+        LOG_WARN(
+            "[VkcAllocator] Huge page threshold %zu is below the %d byte mapping threshold.",
+            info->huge_page_threshold,
+            VKC_ALLOCATOR_MMAP_THRESHOLD
+        );
+    }
 
-bool vkc_allocator_create(void) {
-    if (_vkc_allocator) {
-        return true; // Already initialized
+    // Each context owns its PageAllocator, so freeing the context releases
+    // every block it ever handed out in one sweep.
+    PageAllocator* pager = page_allocator_create(1);
+    if (!pager) {
+        LOG_ERROR("[VkcAllocator] Failed to create PageAllocator.");
+        return NULL;
     }
 
-    _vkc_allocator = page_allocator_create(1);
-    if (!_vkc_allocator) {
-        LOG_ERROR("[VkcAllocator] Failed to create global PageAllocator.");
-        return false;
+    VkcAllocatorContext* context = page_malloc(pager, sizeof(*context), alignof(*context));
+    if (!context) {
+        LOG_ERROR("[VkcAllocator] Failed to allocate allocation context.");
+        page_allocator_free(pager);
+        return NULL;
+    }
+
+    memset(context, 0, sizeof(*context));
+    context->pager = pager;
+
+    if (0 != pthread_mutex_init(&context->mutex, NULL)) {
+        LOG_ERROR("[VkcAllocator] Failed to initialize thread cache registry.");
+        page_allocator_free(pager);
+        return NULL;
+    }
+
+    int error = pthread_key_create(&context->key, vkc_thread_cache_exit);
+    if (0 != error) {
+        // EAGAIN means the process ran out of keys, i.e. too many live contexts.
+        LOG_ERROR("[VkcAllocator] Failed to create thread cache key (error=%d).", error);
+        pthread_mutex_destroy(&context->mutex);
+        page_allocator_free(pager);
+        return NULL;
+    }
+
+    long page_size = sysconf(_SC_PAGESIZE);
+    context->page_size = page_size > 0 ? (size_t) page_size : 4096;
+    context->flags = info ? info->flags : 0;
+    context->huge_page_threshold = info && info->huge_page_threshold
+                                       ? info->huge_page_threshold
+                                       : VKC_ALLOCATOR_HUGE_PAGE_SIZE;
+
+    for (uint32_t i = 0; i < VKC_CACHE_CLASS_COUNT; i++) {
+        size_t slot_size = sizeof(VkcBlock) + vkc_thread_cache_class_size(i);
+        context->slabs[i] = vkc_slab_create(pager, slot_size);
+        if (!context->slabs[i]) {
+            LOG_ERROR("[VkcAllocator] Failed to create slab for size class %u.", i);
+            while (i--) {
+                vkc_slab_free(context->slabs[i]);
+            }
+            pthread_key_delete(context->key);
+            pthread_mutex_destroy(&context->mutex);
+            page_allocator_free(pager);
+            return NULL;
+        }
     }
 
-    _vkc_callbacks = (VkAllocationCallbacks) {
-        .pUserData = _vkc_allocator,
+    // Tracing is a diagnostic; the allocator works without it.
+    context->trace = vkc_trace_create(pager);
+    if (!context->trace) {
+        LOG_WARN("[VkcAllocator] Allocation tracing is unavailable.");
+    }
+
+    context->callbacks = (VkAllocationCallbacks) {
+        .pUserData = context,
         .pfnAllocation = vkc_malloc,
         .pfnReallocation = vkc_realloc,
         .pfnFree = vkc_free,
-        .pfnInternalAllocation = NULL,
-        .pfnInternalFree = NULL,
+        .pfnInternalAllocation = vkc_internal_malloc,
+        .pfnInternalFree = vkc_internal_free,
     };
 
+#if defined(VKC_DEBUG) && (1 == VKC_DEBUG)
+    LOG_DEBUG("[VkcAllocator] Created allocation context @ %p.", (void*) context);
+#endif
+
+    return context;
+}
+
+void vkc_allocator_context_free(VkcAllocatorContext* context) {
+    if (!context) {
+        return;
+    }
+
+#if defined(VKC_DEBUG) && (1 == VKC_DEBUG)
+    static const char* const scopes[] = {"command", "object", "cache", "device", "instance"};
+    VkcAllocatorStats stats;
+    vkc_stats_collect(context, &stats);
+    for (uint32_t i = 0; i < VKC_ALLOCATOR_SCOPE_COUNT; i++) {
+        VkcAllocatorScopeStats* scope = &stats.scopes[i];
+        LOG_DEBUG(
+            "[VkcAllocator] scope=%s live=%lu peak=%lu allocs=%lu reallocs=%lu frees=%lu "
+            "internal_peak=%lu",
+            scopes[i],
+            (unsigned long) scope->live_bytes,
+            (unsigned long) scope->peak_bytes,
+            (unsigned long) scope->allocation_count,
+            (unsigned long) scope->reallocation_count,
+            (unsigned long) scope->free_count,
+            (unsigned long) scope->internal_peak_bytes
+        );
+    }
+#endif
+
+    PageAllocator* pager = context->pager;
+
+    vkc_trace_free(context->trace, pager);
+    pthread_key_delete(context->key);
+
+    VkcThreadCache* cache = context->caches;
+    while (cache) {
+        VkcThreadCache* next = cache->next;
+        vkc_thread_cache_free(cache, pager);
+        cache = next;
+    }
+
+    for (uint32_t i = 0; i < VKC_CACHE_CLASS_COUNT; i++) {
+        vkc_slab_free(context->slabs[i]);
+    }
+
+    // Mappings are not owned by the PageAllocator and must be released here.
+    while (context->maps) {
+        VkcMapNode* next = context->maps->next;
+        munmap(context->maps, context->maps->length);
+        context->maps = next;
+    }
+
+    pthread_mutex_destroy(&context->mutex);
+
+#if defined(VKC_DEBUG) && (1 == VKC_DEBUG)
+    LOG_DEBUG("[VkcAllocator] Destroyed allocation context @ %p.", (void*) context);
+#endif
+
+    // The context itself lives in the pager, so this must come last.
+    page_allocator_free(pager);
+}
+
+const VkAllocationCallbacks* vkc_allocator_context_callbacks(VkcAllocatorContext* context) {
+    return context ? &context->callbacks : NULL;
+}
+
+PageAllocator* vkc_allocator_context_pager(VkcAllocatorContext* context) {
+    return context ? context->pager : NULL;
+}
+
+bool vkc_allocator_context_stats(VkcAllocatorContext* context, VkcAllocatorStats* stats) {
+    if (!context || !stats) {
+        LOG_ERROR("[VkcAllocator] Invalid statistics arguments.");
+        return false;
+    }
+
+    vkc_stats_collect(context, stats);
+    return true;
+}
+
+bool vkc_allocator_context_trace_begin(VkcAllocatorContext* context, const char* path) {
+    if (!context) {
+        LOG_ERROR("[VkcAllocator] Missing allocation context.");
+        return false;
+    }
+
+    if (!context->trace) {
+        LOG_ERROR("[VkcAllocator] Allocation tracing is unavailable.");
+        return false;
+    }
+
+    return vkc_trace_open(context->trace, path);
+}
+
+void vkc_allocator_context_trace_end(VkcAllocatorContext* context) {
+    if (context) {
+        vkc_trace_close(context->trace);
+    }
+}
+
+void* vkc_allocator_context_host_malloc(
+    VkcAllocatorContext* context, size_t size, size_t alignment
+) {
+    if (!context) {
+        LOG_ERROR("[VkcAllocator] Missing allocation context.");
+        return NULL;
+    }
+
+    if (0 == size) {
+        return NULL;
+    }
+
+    void* address
+        = vkc_block_malloc(context, NULL, size, alignment, VK_SYSTEM_ALLOCATION_SCOPE_INSTANCE);
+    if (!address) {
+        LOG_ERROR("[VkcAllocator] Host allocation failed (size=%zu, align=%zu)", size, alignment);
+    }
+
+    return address;
+}
+
+void* vkc_allocator_context_host_realloc(
+    VkcAllocatorContext* context, void* pointer, size_t size, size_t alignment
+) {
+    if (!context) {
+        LOG_ERROR("[VkcAllocator] Missing allocation context.");
+        return NULL;
+    }
+
+    if (!pointer) {
+        return vkc_allocator_context_host_malloc(context, size, alignment);
+    }
+
+    if (0 == size) {
+        vkc_allocator_context_host_free(context, pointer);
+        return NULL;
+    }
+
+    void* address
+        = vkc_block_resize(context, pointer, size, alignment, VK_SYSTEM_ALLOCATION_SCOPE_INSTANCE);
+    if (address) {
+        return address;
+    }
+
+    address = vkc_allocator_context_host_malloc(context, size, alignment);
+    if (address) {
+        size_t original_size = vkc_block_header(pointer)->size;
+        memcpy(address, pointer, original_size < size ? original_size : size);
+        vkc_allocator_context_host_free(context, pointer);
+    }
+
+    return address;
+}
+
+void vkc_allocator_context_host_free(VkcAllocatorContext* context, void* pointer) {
+    if (context && pointer) {
+        vkc_block_free(context, NULL, pointer);
+    }
+}
+
+/** @} */
+
+/**
+ * @name Global Context
+ * {@
+ */
+
+static VkcAllocatorContext* _vkc_context = NULL;
+
+bool vkc_allocator_create(const VkcAllocatorCreateInfo* info) {
+    if (_vkc_context) {
+        return true; // Already initialized
+    }
+
+    _vkc_context = vkc_allocator_context_create(info);
+    if (!_vkc_context) {
+        LOG_ERROR("[VkcAllocator] Failed to create global allocation context.");
+        return false;
+    }
+
 #if defined(VKC_DEBUG) && (1 == VKC_DEBUG)
     LOG_DEBUG("[VkcAllocator] Initialized global Vulkan allocator.");
 #endif
 
+    const char* trace_path = getenv("VKC_ALLOCATOR_TRACE");
+    if (trace_path && *trace_path) {
+        vkc_allocator_trace_begin(trace_path);
+    }
+
     return true;
 }
 
 bool vkc_allocator_destroy(void) {
-    if (_vkc_allocator) {
-        page_allocator_free(_vkc_allocator);
-        _vkc_allocator = NULL;
-        memset(&_vkc_callbacks, 0, sizeof(_vkc_callbacks));
+    if (_vkc_context) {
+        vkc_allocator_context_free(_vkc_context);
+        _vkc_context = NULL;
 
 #if defined(VKC_DEBUG) && (1 == VKC_DEBUG)
         LOG_DEBUG("[VkcAllocator] Global Vulkan allocator destroyed.");
@@ -124,8 +1209,12 @@ bool vkc_allocator_destroy(void) {
     return false;
 }
 
+VkcAllocatorContext* vkc_allocator_context(void) {
+    return _vkc_context;
+}
+
 PageAllocator* vkc_allocator_get(void) {
-    if (!_vkc_allocator) {
+    if (!_vkc_context) {
         LOG_ERROR("[VkcAllocator] Global Vulkan allocator is unintialized!");
 
 #if defined(VKC_DEBUG) && (1 == VKC_DEBUG)
@@ -135,11 +1224,55 @@ PageAllocator* vkc_allocator_get(void) {
         return NULL;
     }
 
-    return _vkc_allocator;
+    return _vkc_context->pager;
 }
 
 const VkAllocationCallbacks* vkc_allocator_callbacks(void) {
-    return _vkc_allocator ? &_vkc_callbacks : NULL;
+    return vkc_allocator_context_callbacks(_vkc_context);
+}
+
+bool vkc_allocator_stats(VkcAllocatorStats* stats) {
+    if (!_vkc_context) {
+        LOG_ERROR("[VkcAllocator] Global Vulkan allocator is unintialized!");
+        return false;
+    }
+
+    return vkc_allocator_context_stats(_vkc_context, stats);
+}
+
+bool vkc_allocator_trace_begin(const char* path) {
+    if (!_vkc_context) {
+        LOG_ERROR("[VkcAllocator] Global Vulkan allocator is unintialized!");
+        return false;
+    }
+
+    return vkc_allocator_context_trace_begin(_vkc_context, path);
+}
+
+void vkc_allocator_trace_end(void) {
+    vkc_allocator_context_trace_end(_vkc_context);
+}
+
+void* vkc_allocator_host_malloc(size_t size, size_t alignment) {
+    if (!_vkc_context) {
+        LOG_ERROR("[VkcAllocator] Global Vulkan allocator is unintialized!");
+        return NULL;
+    }
+
+    return vkc_allocator_context_host_malloc(_vkc_context, size, alignment);
+}
+
+void* vkc_allocator_host_realloc(void* pointer, size_t size, size_t alignment) {
+    if (!_vkc_context) {
+        LOG_ERROR("[VkcAllocator] Global Vulkan allocator is unintialized!");
+        return NULL;
+    }
+
+    return vkc_allocator_context_host_realloc(_vkc_context, pointer, size, alignment);
+}
+
+void vkc_allocator_host_free(void* pointer) {
+    vkc_allocator_context_host_free(_vkc_context, pointer);
 }
 
 /** @} */
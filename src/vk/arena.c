@@ -0,0 +1,212 @@
+/**
+ * @file src/vk/arena.c
+ * @brief Chunked bump arena for short-lived Vulkan host allocations.
+ */
+
+#include "core/posix.h"
+#include "core/memory.h"
+#include "core/logger.h"
+#include "allocator/page.h"
+#include "vk/arena.h"
+
+/**
+ * @section Private
+ * {@
+ */
+
+static inline unsigned char* vkc_arena_chunk_data(VkcArenaChunk* chunk) {
+    return (unsigned char*) (chunk + 1);
+}
+
+static VkcArenaChunk* vkc_arena_chunk_create(VkcArena* arena) {
+    VkcArenaChunk* chunk = page_malloc(
+        arena->pager, sizeof(VkcArenaChunk) + arena->chunk_size, alignof(max_align_t)
+    );
+    if (!chunk) {
+        LOG_ERROR("[VkcArena] Failed to allocate %zu byte chunk.", arena->chunk_size);
+        return NULL;
+    }
+
+    *chunk = (VkcArenaChunk) {
+        .next = NULL,
+        .capacity = arena->chunk_size,
+        .offset = 0,
+        .live = 0,
+    };
+
+    return chunk;
+}
+
+static void* vkc_arena_chunk_bump(VkcArenaChunk* chunk, size_t size, size_t alignment) {
+    uintptr_t data = (uintptr_t) vkc_arena_chunk_data(chunk);
+    uintptr_t address = (data + chunk->offset + (alignment - 1)) & ~((uintptr_t) alignment - 1);
+    if (address + size > data + chunk->capacity) {
+        return NULL;
+    }
+
+    chunk->offset = (address + size) - data;
+    chunk->live++;
+    return (void*) address;
+}
+
+/** @} */
+
+/**
+ * @name Public
+ * {@
+ */
+
+VkcArena* vkc_arena_create(PageAllocator* pager, size_t chunk_size) {
+    if (!pager) {
+        LOG_ERROR("[VkcArena] Missing allocation context (PageAllocator).");
+        return NULL;
+    }
+
+    VkcArena* arena = page_malloc(pager, sizeof(*arena), alignof(*arena));
+    if (!arena) {
+        LOG_ERROR("[VkcArena] Failed to allocate arena structure.");
+        return NULL;
+    }
+
+    *arena = (VkcArena) {
+        .pager = pager,
+        .current = NULL,
+        .free = NULL,
+        .free_count = 0,
+        .chunk_size = chunk_size ? chunk_size : VKC_ARENA_CHUNK_SIZE,
+    };
+
+    if (0 != pthread_mutex_init(&arena->mutex, NULL)) {
+        LOG_ERROR("[VkcArena] Failed to initialize arena mutex.");
+        page_free(pager, arena);
+        return NULL;
+    }
+
+    return arena;
+}
+
+void vkc_arena_free(VkcArena* arena) {
+    if (!arena) {
+        return;
+    }
+
+    PageAllocator* pager = arena->pager;
+
+    while (arena->free) {
+        VkcArenaChunk* next = arena->free->next;
+        page_free(pager, arena->free);
+        arena->free = next;
+    }
+
+    // Chunks that still hold live allocations are not linked anywhere, so
+    // they are reclaimed when the owning PageAllocator is freed.
+    if (arena->current && 0 == arena->current->live) {
+        page_free(pager, arena->current);
+    }
+
+    pthread_mutex_destroy(&arena->mutex);
+    page_free(pager, arena);
+}
+
+void* vkc_arena_malloc(VkcArena* arena, size_t size, size_t alignment, VkcArenaChunk** chunk) {
+    if (!arena || !chunk || 0 == size) {
+        return NULL;
+    }
+
+    // Oversized requests belong to the general purpose allocator.
+    if (size + alignment > arena->chunk_size) {
+        return NULL;
+    }
+
+    pthread_mutex_lock(&arena->mutex);
+
+    void* address = NULL;
+    if (arena->current) {
+        address = vkc_arena_chunk_bump(arena->current, size, alignment);
+    }
+
+    if (!address) {
+        // The full chunk is abandoned here and recycled by its last release.
+        VkcArenaChunk* next = arena->free;
+        if (next) {
+            arena->free = next->next;
+            arena->free_count--;
+            next->next = NULL;
+        } else {
+            next = vkc_arena_chunk_create(arena);
+        }
+
+        if (next) {
+            if (arena->current && 0 == arena->current->live) {
+                page_free(arena->pager, arena->current);
+            }
+            arena->current = next;
+            address = vkc_arena_chunk_bump(next, size, alignment);
+        }
+    }
+
+    if (address) {
+        *chunk = arena->current;
+    }
+
+    pthread_mutex_unlock(&arena->mutex);
+    return address;
+}
+
+bool vkc_arena_resize(
+    VkcArena* arena, VkcArenaChunk* chunk, void* address, size_t size, size_t new_size
+) {
+    if (!arena || !chunk || !address) {
+        return false;
+    }
+
+    pthread_mutex_lock(&arena->mutex);
+
+    uintptr_t data = (uintptr_t) vkc_arena_chunk_data(chunk);
+    uintptr_t end = (uintptr_t) address + size;
+    bool resized = new_size <= size;
+
+    // Only the tail allocation can move the bump cursor.
+    if (end == data + chunk->offset) {
+        if ((uintptr_t) address + new_size <= data + chunk->capacity) {
+            chunk->offset = ((uintptr_t) address + new_size) - data;
+            resized = true;
+        }
+    }
+
+    pthread_mutex_unlock(&arena->mutex);
+    return resized;
+}
+
+void vkc_arena_release(VkcArena* arena, VkcArenaChunk* chunk) {
+    if (!arena || !chunk) {
+        return;
+    }
+
+    pthread_mutex_lock(&arena->mutex);
+
+    if (0 == chunk->live) {
+        LOG_ERROR("[VkcArena] Released chunk %p with no live allocations.", (void*) chunk);
+        pthread_mutex_unlock(&arena->mutex);
+        return;
+    }
+
+    if (0 == --chunk->live) {
+        // Bulk reset: every allocation in this chunk is dead.
+        chunk->offset = 0;
+
+        if (chunk != arena->current) {
+            if (arena->free_count < VKC_ARENA_FREE_LIMIT) {
+                chunk->next = arena->free;
+                arena->free = chunk;
+                arena->free_count++;
+            } else {
+                page_free(arena->pager, chunk);
+            }
+        }
+    }
+
+    pthread_mutex_unlock(&arena->mutex);
+}
+
+/** @} */
@@ -0,0 +1,491 @@
+/**
+ * @file src/vk/batcher.c
+ * @brief Coalesce many small dispatches into one queue submission.
+ */
+
+#include "core/posix.h"
+#include "core/memory.h"
+#include "core/logger.h"
+#include "allocator/page.h"
+#include "vk/sync.h"
+#include "vk/queue.h"
+#include "vk/batcher.h"
+
+#include <time.h>
+
+/**
+ * @section Private
+ * {@
+ */
+
+static uint64_t vkc_batcher_now(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t) ts.tv_sec * 1000000000ull + (uint64_t) ts.tv_nsec;
+}
+
+static VkcBatch* vkc_batcher_slot(VkcBatcher* self, uint64_t ticket) {
+    return &self->batches[(ticket - 1) % self->depth];
+}
+
+// The batch accepting dispatches, or NULL. Caller holds the mutex.
+static VkcBatch* vkc_batcher_current(VkcBatcher* self) {
+    if (0 == self->serial) {
+        return NULL;
+    }
+
+    VkcBatch* batch = vkc_batcher_slot(self, self->serial);
+    return VKC_BATCH_RECORDING == batch->state ? batch : NULL;
+}
+
+// Start recording the next batch, or join one another caller opened first.
+// Caller holds the mutex, which is released while the slot drains so that a
+// slow batch does not stall every other dispatcher and the flusher.
+static VkcBatch* vkc_batcher_open(VkcBatcher* self) {
+    uint64_t serial;
+    VkcBatch* batch;
+
+    for (;;) {
+        VkcBatch* current = vkc_batcher_current(self);
+        if (current) {
+            return current;
+        }
+
+        serial = self->serial + 1;
+        batch = vkc_batcher_slot(self, serial);
+        if (VKC_BATCH_SUBMITTED != batch->state) {
+            break;
+        }
+
+        // The command buffer may not be re-recorded while it executes.
+        uint64_t busy = batch->serial;
+        uint64_t ticket = batch->ticket;
+        pthread_mutex_unlock(&self->mutex);
+        bool ok = vkc_queue_wait(self->queue, ticket, UINT64_MAX);
+        pthread_mutex_lock(&self->mutex);
+
+        if (!ok) {
+            LOG_ERROR("[VkcBatcher] Failed to retire batch %llu.", (unsigned long long) busy);
+            return NULL;
+        }
+
+        // Another waiter may have retired and reopened the slot meanwhile.
+        if (busy == batch->serial && VKC_BATCH_SUBMITTED == batch->state) {
+            batch->state = VKC_BATCH_FREE;
+        }
+    }
+
+    // The pool allows individual resets, so beginning resets the buffer.
+    VkCommandBufferBeginInfo begin = {
+        .sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO,
+        .flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT,
+    };
+    VkResult result = vkBeginCommandBuffer(batch->command, &begin);
+    if (VK_SUCCESS != result) {
+        LOG_ERROR("[VkcBatcher] Failed to begin recording (VkResult=%d).", result);
+        return NULL;
+    }
+
+    *batch = (VkcBatch) {
+        .command = batch->command,
+        .state = VKC_BATCH_RECORDING,
+        .pipeline = VK_NULL_HANDLE,
+        .serial = serial,
+        .failed = batch->failed,
+        .opened = vkc_batcher_now(),
+    };
+    self->serial = serial;
+
+    pthread_cond_signal(&self->opened);
+    return batch;
+}
+
+static void vkc_batcher_record(
+    const VkcBatcher* self, VkcBatch* batch, const VkcBatchDispatch* dispatch
+) {
+    VkCommandBuffer command = batch->command;
+
+    if (self->serialize && batch->count) {
+        VkMemoryBarrier barrier = {
+            .sType = VK_STRUCTURE_TYPE_MEMORY_BARRIER,
+            .srcAccessMask = VK_ACCESS_SHADER_WRITE_BIT,
+            .dstAccessMask = VK_ACCESS_SHADER_READ_BIT | VK_ACCESS_SHADER_WRITE_BIT,
+        };
+        vkCmdPipelineBarrier(
+            command,
+            VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
+            VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
+            0,
+            1,
+            &barrier,
+            0,
+            NULL,
+            0,
+            NULL
+        );
+    }
+
+    if (dispatch->pipeline != batch->pipeline) {
+        vkCmdBindPipeline(command, VK_PIPELINE_BIND_POINT_COMPUTE, dispatch->pipeline);
+        batch->pipeline = dispatch->pipeline;
+    }
+
+    if (dispatch->push_size) {
+        vkCmdPushConstants(
+            command,
+            dispatch->layout,
+            VK_SHADER_STAGE_COMPUTE_BIT,
+            0,
+            dispatch->push_size,
+            dispatch->push_data
+        );
+    }
+
+    if (dispatch->set_count) {
+        vkCmdBindDescriptorSets(
+            command,
+            VK_PIPELINE_BIND_POINT_COMPUTE,
+            dispatch->layout,
+            0,
+            dispatch->set_count,
+            dispatch->sets,
+            0,
+            NULL
+        );
+    }
+
+    vkCmdDispatch(command, dispatch->x, dispatch->y, dispatch->z);
+    batch->count++;
+}
+
+// Close and submit a recording batch. Caller holds the mutex.
+static bool vkc_batcher_submit(VkcBatcher* self, VkcBatch* batch) {
+    // Callers only learn a ticket retired, so the batch publishes its writes.
+    vkc_sync_compute_barrier(batch->command);
+
+    // A failed batch is left FREE with its serial recorded, which is how
+    // waiters on it learn of the failure even after the slot is reopened.
+    batch->state = VKC_BATCH_FREE;
+
+    VkResult result = vkEndCommandBuffer(batch->command);
+    if (VK_SUCCESS != result) {
+        LOG_ERROR("[VkcBatcher] Failed to end recording (VkResult=%d).", result);
+        batch->failed = batch->serial;
+        return false;
+    }
+
+    VkcQueueSubmit submit = {
+        .commands = &batch->command,
+        .command_count = 1,
+    };
+    uint64_t ticket = vkc_queue_submit(self->queue, &submit);
+    if (0 == ticket) {
+        LOG_ERROR(
+            "[VkcBatcher] Failed to submit batch %llu of %u dispatches.",
+            (unsigned long long) batch->serial,
+            batch->count
+        );
+        batch->failed = batch->serial;
+        return false;
+    }
+
+    batch->ticket = ticket;
+    batch->state = VKC_BATCH_SUBMITTED;
+    self->submitted++;
+    return true;
+}
+
+// Submits batches once their latency window expires.
+static void* vkc_batcher_flusher(void* arg) {
+    VkcBatcher* self = arg;
+
+    pthread_mutex_lock(&self->mutex);
+    while (self->running) {
+        VkcBatch* batch = vkc_batcher_current(self);
+        if (!batch) {
+            pthread_cond_wait(&self->opened, &self->mutex);
+            continue;
+        }
+
+        uint64_t deadline = batch->opened + self->window_ns;
+        if (vkc_batcher_now() >= deadline) {
+            vkc_batcher_submit(self, batch);
+            continue;
+        }
+
+        // The batch may be submitted by its count or a waiter meanwhile; the
+        // loop re-reads the current batch after every wakeup.
+        struct timespec ts = {
+            .tv_sec = (time_t) (deadline / 1000000000ull),
+            .tv_nsec = (long) (deadline % 1000000000ull),
+        };
+        pthread_cond_timedwait(&self->opened, &self->mutex, &ts);
+    }
+    pthread_mutex_unlock(&self->mutex);
+
+    return NULL;
+}
+
+static bool vkc_batcher_sync_create(VkcBatcher* self) {
+    if (0 != pthread_mutex_init(&self->mutex, NULL)) {
+        return false;
+    }
+
+    // Deadlines come from CLOCK_MONOTONIC, so the condition must time out on it.
+    pthread_condattr_t attr;
+    bool ok = 0 == pthread_condattr_init(&attr);
+    ok = ok && 0 == pthread_condattr_setclock(&attr, CLOCK_MONOTONIC);
+    ok = ok && 0 == pthread_cond_init(&self->opened, &attr);
+    pthread_condattr_destroy(&attr);
+
+    if (!ok) {
+        pthread_mutex_destroy(&self->mutex);
+    }
+
+    return ok;
+}
+
+/** @} */
+
+/**
+ * @name Public
+ * {@
+ */
+
+VkcBatcher* vkc_batcher_create(VkcQueue* queue, const VkcBatcherInfo* info) {
+    if (!queue || !info || 0 == info->max_dispatches || 0 == info->depth
+        || info->depth > VKC_BATCHER_DEPTH_MAX) {
+        LOG_ERROR("[VkcBatcher] Invalid batcher arguments.");
+        return NULL;
+    }
+
+    VkcBatcher* self = page_malloc(queue->pager, sizeof(*self), alignof(*self));
+    if (!self) {
+        LOG_ERROR("[VkcBatcher] Failed to allocate batcher structure.");
+        return NULL;
+    }
+
+    *self = (VkcBatcher) {
+        .pager = queue->pager,
+        .queue = queue,
+        .command_pool = VK_NULL_HANDLE,
+        .depth = info->depth,
+        .max_dispatches = info->max_dispatches,
+        .window_ns = info->window_ns,
+        .serialize = info->serialize,
+    };
+
+    if (!vkc_batcher_sync_create(self)) {
+        LOG_ERROR("[VkcBatcher] Failed to initialize batcher mutex.");
+        page_free(queue->pager, self);
+        return NULL;
+    }
+
+    VkCommandPoolCreateInfo command_pool_info = {
+        .sType = VK_STRUCTURE_TYPE_COMMAND_POOL_CREATE_INFO,
+        .flags = VK_COMMAND_POOL_CREATE_TRANSIENT_BIT
+                 | VK_COMMAND_POOL_CREATE_RESET_COMMAND_BUFFER_BIT,
+        .queueFamilyIndex = queue->family,
+    };
+    VkResult result = vkCreateCommandPool(
+        queue->device, &command_pool_info, queue->callbacks, &self->command_pool
+    );
+    if (VK_SUCCESS != result) {
+        LOG_ERROR("[VkcBatcher] Failed to create command pool (VkResult=%d).", result);
+        vkc_batcher_free(self);
+        return NULL;
+    }
+
+    VkCommandBuffer commands[VKC_BATCHER_DEPTH_MAX];
+    VkCommandBufferAllocateInfo command_info = {
+        .sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO,
+        .commandPool = self->command_pool,
+        .level = VK_COMMAND_BUFFER_LEVEL_PRIMARY,
+        .commandBufferCount = info->depth,
+    };
+    result = vkAllocateCommandBuffers(queue->device, &command_info, commands);
+    if (VK_SUCCESS != result) {
+        LOG_ERROR("[VkcBatcher] Failed to allocate command buffers (VkResult=%d).", result);
+        vkc_batcher_free(self);
+        return NULL;
+    }
+
+    for (uint32_t i = 0; i < info->depth; i++) {
+        self->batches[i].command = commands[i];
+    }
+
+    if (info->window_ns) {
+        self->running = true;
+        if (0 != pthread_create(&self->flusher, NULL, vkc_batcher_flusher, self)) {
+            LOG_ERROR("[VkcBatcher] Failed to start flusher thread.");
+            self->running = false;
+            vkc_batcher_free(self);
+            return NULL;
+        }
+    }
+
+    return self;
+}
+
+void vkc_batcher_free(VkcBatcher* batcher) {
+    if (!batcher) {
+        return;
+    }
+
+    pthread_mutex_lock(&batcher->mutex);
+    bool flusher = batcher->running;
+    batcher->running = false;
+
+    VkcBatch* batch = vkc_batcher_current(batcher);
+    if (batch) {
+        vkc_batcher_submit(batcher, batch);
+    }
+
+    pthread_cond_broadcast(&batcher->opened);
+    pthread_mutex_unlock(&batcher->mutex);
+
+    if (flusher) {
+        pthread_join(batcher->flusher, NULL);
+    }
+
+    for (uint32_t i = 0; i < batcher->depth; i++) {
+        if (VKC_BATCH_SUBMITTED == batcher->batches[i].state) {
+            vkc_queue_wait(batcher->queue, batcher->batches[i].ticket, UINT64_MAX);
+        }
+    }
+
+    // Command buffers go with their pool.
+    if (VK_NULL_HANDLE != batcher->command_pool) {
+        vkDestroyCommandPool(
+            batcher->queue->device, batcher->command_pool, batcher->queue->callbacks
+        );
+    }
+
+#if defined(VKC_DEBUG) && (1 == VKC_DEBUG)
+    LOG_DEBUG(
+        "[VkcBatcher] Coalesced %llu dispatches into %llu submissions.",
+        (unsigned long long) batcher->dispatched,
+        (unsigned long long) batcher->submitted
+    );
+#endif
+
+    pthread_cond_destroy(&batcher->opened);
+    pthread_mutex_destroy(&batcher->mutex);
+    page_free(batcher->pager, batcher);
+}
+
+uint64_t vkc_batcher_dispatch(VkcBatcher* batcher, const VkcBatchDispatch* dispatch) {
+    if (!batcher || !dispatch || VK_NULL_HANDLE == dispatch->pipeline
+        || VK_NULL_HANDLE == dispatch->layout || (dispatch->set_count && !dispatch->sets)
+        || dispatch->set_count > VKC_BATCHER_SETS_MAX
+        || (dispatch->push_size && !dispatch->push_data) || 0 == dispatch->x || 0 == dispatch->y
+        || 0 == dispatch->z) {
+        LOG_ERROR("[VkcBatcher] Invalid dispatch arguments.");
+        return 0;
+    }
+
+    pthread_mutex_lock(&batcher->mutex);
+
+    VkcBatch* batch = vkc_batcher_current(batcher);
+    if (!batch) {
+        batch = vkc_batcher_open(batcher);
+    }
+    if (!batch) {
+        pthread_mutex_unlock(&batcher->mutex);
+        return 0;
+    }
+
+    vkc_batcher_record(batcher, batch, dispatch);
+    batcher->dispatched++;
+
+    uint64_t ticket = batch->serial;
+    if (batch->count >= batcher->max_dispatches && !vkc_batcher_submit(batcher, batch)) {
+        ticket = 0;
+    }
+
+    pthread_mutex_unlock(&batcher->mutex);
+    return ticket;
+}
+
+bool vkc_batcher_flush(VkcBatcher* batcher) {
+    if (!batcher) {
+        return false;
+    }
+
+    pthread_mutex_lock(&batcher->mutex);
+    VkcBatch* batch = vkc_batcher_current(batcher);
+    bool ok = !batch || vkc_batcher_submit(batcher, batch);
+    pthread_mutex_unlock(&batcher->mutex);
+
+    return ok;
+}
+
+bool vkc_batcher_poll(VkcBatcher* batcher, uint64_t ticket) {
+    if (!batcher) {
+        return false;
+    }
+
+    if (0 == ticket) {
+        return true;
+    }
+
+    pthread_mutex_lock(&batcher->mutex);
+    bool retired = false;
+    uint64_t queue_ticket = 0;
+    if (ticket <= batcher->serial) {
+        // A slot is reopened only after its previous batch completed or failed.
+        VkcBatch* batch = vkc_batcher_slot(batcher, ticket);
+        if (batch->failed != ticket) {
+            retired = batch->serial > ticket || VKC_BATCH_FREE == batch->state;
+            if (batch->serial == ticket && VKC_BATCH_SUBMITTED == batch->state) {
+                queue_ticket = batch->ticket;
+            }
+        }
+    }
+    pthread_mutex_unlock(&batcher->mutex);
+
+    return retired || (queue_ticket && vkc_queue_poll(batcher->queue, queue_ticket));
+}
+
+bool vkc_batcher_wait(VkcBatcher* batcher, uint64_t ticket, uint64_t timeout) {
+    if (!batcher) {
+        return false;
+    }
+
+    if (0 == ticket) {
+        return true;
+    }
+
+    pthread_mutex_lock(&batcher->mutex);
+
+    if (ticket > batcher->serial) {
+        pthread_mutex_unlock(&batcher->mutex);
+        LOG_ERROR("[VkcBatcher] Ticket %llu was never issued.", (unsigned long long) ticket);
+        return false;
+    }
+
+    VkcBatch* batch = vkc_batcher_slot(batcher, ticket);
+
+    // Nobody else will submit the batch sooner than the caller needs it.
+    if (batch->serial == ticket && VKC_BATCH_RECORDING == batch->state) {
+        vkc_batcher_submit(batcher, batch);
+    }
+
+    bool failed = batch->failed == ticket;
+    bool retired = !failed && (batch->serial > ticket || VKC_BATCH_FREE == batch->state);
+    uint64_t queue_ticket = failed || retired ? 0 : batch->ticket;
+    pthread_mutex_unlock(&batcher->mutex);
+
+    if (failed) {
+        LOG_ERROR("[VkcBatcher] Batch %llu failed.", (unsigned long long) ticket);
+        return false;
+    }
+
+    if (retired) {
+        return true;
+    }
+
+    return vkc_queue_wait(batcher->queue, queue_ticket, timeout);
+}
+
+/** @} */
@@ -0,0 +1,489 @@
+/**
+ * @file src/vk/buffer.c
+ * @brief Vulkan buffers bound to pooled device memory.
+ */
+
+#include "core/posix.h"
+#include "core/memory.h"
+#include "core/logger.h"
+#include "allocator/page.h"
+#include "vk/memory.h"
+#include "vk/buffer.h"
+
+/**
+ * @section Private
+ * {@
+ */
+
+static bool vkc_buffer_bind(VkcMemoryPool* pool, VkcBuffer* buffer) {
+    VkMemoryRequirements requirements = {0};
+    vkGetBufferMemoryRequirements(pool->device, buffer->object, &requirements);
+
+    uint32_t type_bits = requirements.memoryTypeBits;
+    uint32_t type = vkc_memory_type_select(pool, type_bits, buffer->intent);
+    if (VKC_MEMORY_TYPE_NONE == type) {
+        LOG_ERROR("[VkcBuffer] No memory type for intent %d.", buffer->intent);
+        return false;
+    }
+
+    while (!vkc_memory_malloc(pool, &requirements, type, VKC_MEMORY_LINEAR, &buffer->allocation)) {
+        // Device-only data still works from another heap, just more slowly, so
+        // spill it to host memory rather than fail when VRAM is over budget.
+        type_bits &= ~vkc_memory_heap_types(pool, type);
+        uint32_t spill = vkc_memory_type_select(pool, type_bits, buffer->intent);
+        if (VKC_MEMORY_GPU_ONLY != buffer->intent || VKC_MEMORY_TYPE_NONE == spill) {
+            LOG_ERROR(
+                "[VkcBuffer] Failed to allocate %llu bytes.", (unsigned long long) buffer->size
+            );
+            return false;
+        }
+
+        LOG_WARN(
+            "[VkcBuffer] Spilling %llu bytes from memory type %u to %u.",
+            (unsigned long long) buffer->size,
+            type,
+            spill
+        );
+        type = spill;
+    }
+
+    VkResult result = vkBindBufferMemory(
+        pool->device, buffer->object, buffer->allocation.memory, buffer->allocation.offset
+    );
+    if (VK_SUCCESS != result) {
+        LOG_ERROR("[VkcBuffer] Failed to bind buffer memory (VkResult=%d).", result);
+        vkc_memory_free(pool, &buffer->allocation);
+        return false;
+    }
+
+    if (buffer->flags & VKC_BUFFER_MAPPED_BIT) {
+        buffer->mapped = vkc_memory_map(pool, &buffer->allocation);
+        if (!buffer->mapped) {
+            LOG_ERROR("[VkcBuffer] Failed to map buffer memory.");
+            vkc_memory_free(pool, &buffer->allocation);
+            return false;
+        }
+    }
+
+    return true;
+}
+
+static uint32_t vkc_buffer_pool_class(VkDeviceSize size) {
+    if (size <= (1ull << VKC_BUFFER_POOL_MIN_ORDER)) {
+        return 0;
+    }
+
+    return 64u - (uint32_t) __builtin_clzll(size - 1) - VKC_BUFFER_POOL_MIN_ORDER;
+}
+
+// Take an entry out of its class list; the entry keeps its buffer.
+static void vkc_buffer_pool_detach(
+    VkcBufferPool* pool, uint32_t bucket, VkcBufferPoolEntry* entry
+) {
+    if (entry->prev) {
+        entry->prev->next = entry->next;
+    } else {
+        pool->head[bucket] = entry->next;
+    }
+
+    if (entry->next) {
+        entry->next->prev = entry->prev;
+    } else {
+        pool->tail[bucket] = entry->prev;
+    }
+
+    pool->cached -= entry->buffer->size;
+}
+
+static void vkc_buffer_pool_unlink(
+    VkcBufferPool* pool, uint32_t bucket, VkcBufferPoolEntry* entry
+) {
+    vkc_buffer_pool_detach(pool, bucket, entry);
+
+    entry->buffer = NULL;
+    entry->prev = NULL;
+    entry->next = pool->spare;
+    pool->spare = entry;
+}
+
+// Detach the oldest entries until at most keep bytes stay cached. Returns them
+// chained through next, still holding their buffers, for
+// vkc_buffer_pool_drop(). Caller holds the pool mutex.
+static VkcBufferPoolEntry* vkc_buffer_pool_evict(VkcBufferPool* pool, VkDeviceSize keep) {
+    VkcBufferPoolEntry* evicted = NULL;
+
+    while (pool->cached > keep) {
+        uint32_t oldest = VKC_BUFFER_POOL_CLASSES;
+        for (uint32_t bucket = 0; bucket < VKC_BUFFER_POOL_CLASSES; bucket++) {
+            if (pool->tail[bucket]
+                && (VKC_BUFFER_POOL_CLASSES == oldest
+                    || pool->tail[bucket]->tick < pool->tail[oldest]->tick)) {
+                oldest = bucket;
+            }
+        }
+
+        VkcBufferPoolEntry* entry = pool->tail[oldest];
+        vkc_buffer_pool_detach(pool, oldest, entry);
+        entry->prev = NULL;
+        entry->next = evicted;
+        evicted = entry;
+    }
+
+    return evicted;
+}
+
+// Free evicted buffers outside the mutex, so Vulkan destroy and free calls do
+// not stall acquisitions, then return the entries to the spare list.
+static void vkc_buffer_pool_drop(VkcBufferPool* pool, VkcBufferPoolEntry* evicted) {
+    if (!evicted) {
+        return;
+    }
+
+    VkcBufferPoolEntry* last = evicted;
+    for (VkcBufferPoolEntry* entry = evicted; entry; entry = entry->next) {
+        vkc_buffer_free(entry->buffer);
+        entry->buffer = NULL;
+        last = entry;
+    }
+
+    pthread_mutex_lock(&pool->mutex);
+    last->next = pool->spare;
+    pool->spare = evicted;
+    pthread_mutex_unlock(&pool->mutex);
+}
+
+/** @} */
+
+/**
+ * @name Public
+ * {@
+ */
+
+VkcBuffer* vkc_buffer_create(
+    VkcMemoryPool* pool,
+    VkDeviceSize size,
+    VkBufferUsageFlags usage,
+    VkcMemoryIntent intent,
+    VkcBufferFlags flags
+) {
+    if (!pool || 0 == size || intent >= VKC_MEMORY_INTENT_COUNT) {
+        LOG_ERROR("[VkcBuffer] Invalid buffer arguments.");
+        return NULL;
+    }
+
+    VkcBuffer* buffer = page_malloc(pool->pager, sizeof(*buffer), alignof(*buffer));
+    if (!buffer) {
+        LOG_ERROR("[VkcBuffer] Failed to allocate buffer structure.");
+        return NULL;
+    }
+
+    *buffer = (VkcBuffer) {
+        .object = VK_NULL_HANDLE,
+        .pool = pool,
+        .size = size,
+        .usage = usage,
+        .intent = intent,
+        .flags = flags,
+    };
+
+    VkBufferCreateInfo info = {
+        .sType = VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO,
+        .size = size,
+        .usage = usage,
+        .sharingMode = VK_SHARING_MODE_EXCLUSIVE,
+    };
+
+    VkResult result = vkCreateBuffer(pool->device, &info, pool->callbacks, &buffer->object);
+    if (VK_SUCCESS != result) {
+        LOG_ERROR("[VkcBuffer] Failed to create buffer (VkResult=%d).", result);
+        page_free(pool->pager, buffer);
+        return NULL;
+    }
+
+    if (!vkc_buffer_bind(pool, buffer)) {
+        vkDestroyBuffer(pool->device, buffer->object, pool->callbacks);
+        page_free(pool->pager, buffer);
+        return NULL;
+    }
+
+    return buffer;
+}
+
+VkcBuffer* vkc_buffer_import(
+    VkcMemoryPool* pool,
+    void* host,
+    VkDeviceSize size,
+    VkBufferUsageFlags usage,
+    VkcMemoryIntent intent
+) {
+    if (!pool || !host || 0 == size || VKC_MEMORY_GPU_ONLY == intent
+        || intent >= VKC_MEMORY_INTENT_COUNT) {
+        LOG_ERROR("[VkcBuffer] Invalid import arguments.");
+        return NULL;
+    }
+
+    if (pool->flags & VKC_MEMORY_POOL_HOST_IMPORT_BIT) {
+        VkcBuffer* buffer = page_malloc(pool->pager, sizeof(*buffer), alignof(*buffer));
+        if (!buffer) {
+            LOG_ERROR("[VkcBuffer] Failed to allocate buffer structure.");
+            return NULL;
+        }
+
+        *buffer = (VkcBuffer) {
+            .object = VK_NULL_HANDLE,
+            .pool = pool,
+            .mapped = host,
+            .size = size,
+            .usage = usage,
+            .intent = intent,
+            .flags = VKC_BUFFER_MAPPED_BIT | VKC_BUFFER_IMPORTED_BIT,
+        };
+
+        VkExternalMemoryBufferCreateInfo external = {
+            .sType = VK_STRUCTURE_TYPE_EXTERNAL_MEMORY_BUFFER_CREATE_INFO,
+            .handleTypes = VK_EXTERNAL_MEMORY_HANDLE_TYPE_HOST_ALLOCATION_BIT_EXT,
+        };
+        VkBufferCreateInfo info = {
+            .sType = VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO,
+            .pNext = &external,
+            .size = size,
+            .usage = usage,
+            .sharingMode = VK_SHARING_MODE_EXCLUSIVE,
+        };
+
+        VkResult result = vkCreateBuffer(pool->device, &info, pool->callbacks, &buffer->object);
+        if (VK_SUCCESS == result) {
+            VkMemoryRequirements requirements = {0};
+            vkGetBufferMemoryRequirements(pool->device, buffer->object, &requirements);
+
+            if (vkc_memory_import(pool, host, size, &requirements, intent, &buffer->allocation)) {
+                result = vkBindBufferMemory(
+                    pool->device, buffer->object, buffer->allocation.memory, 0
+                );
+                if (VK_SUCCESS == result) {
+                    return buffer;
+                }
+                LOG_WARN("[VkcBuffer] Failed to bind imported memory (VkResult=%d).", result);
+                vkc_memory_free(pool, &buffer->allocation);
+            }
+
+            vkDestroyBuffer(pool->device, buffer->object, pool->callbacks);
+        }
+
+        page_free(pool->pager, buffer);
+    }
+
+    // No import: a mapped buffer holding a copy behaves the same from here on.
+    VkcBuffer* buffer = vkc_buffer_create(pool, size, usage, intent, VKC_BUFFER_MAPPED_BIT);
+    if (!buffer) {
+        return NULL;
+    }
+
+    memcpy(buffer->mapped, host, size);
+
+    VkcMemoryBatch batch = {.op = VKC_MEMORY_FLUSH};
+    if (!vkc_buffer_flush(buffer, &batch, 0, size) || !vkc_memory_batch_submit(pool, &batch)) {
+        vkc_buffer_free(buffer);
+        return NULL;
+    }
+
+#if defined(VKC_DEBUG) && (1 == VKC_DEBUG)
+    LOG_DEBUG("[VkcBuffer] Copied %llu bytes instead of importing.", (unsigned long long) size);
+#endif
+
+    return buffer;
+}
+
+void vkc_buffer_free(VkcBuffer* buffer) {
+    if (!buffer) {
+        return;
+    }
+
+    VkcMemoryPool* pool = buffer->pool;
+
+    vkDestroyBuffer(pool->device, buffer->object, pool->callbacks);
+    vkc_memory_free(pool, &buffer->allocation);
+    page_free(pool->pager, buffer);
+}
+
+bool vkc_buffer_flush(
+    VkcBuffer* buffer, VkcMemoryBatch* batch, VkDeviceSize offset, VkDeviceSize size
+) {
+    if (!buffer || !batch || VKC_MEMORY_FLUSH != batch->op) {
+        LOG_ERROR("[VkcBuffer] Invalid flush arguments.");
+        return false;
+    }
+
+    return vkc_memory_batch_add(buffer->pool, batch, &buffer->allocation, offset, size);
+}
+
+bool vkc_buffer_invalidate(
+    VkcBuffer* buffer, VkcMemoryBatch* batch, VkDeviceSize offset, VkDeviceSize size
+) {
+    if (!buffer || !batch || VKC_MEMORY_INVALIDATE != batch->op) {
+        LOG_ERROR("[VkcBuffer] Invalid invalidate arguments.");
+        return false;
+    }
+
+    return vkc_memory_batch_add(buffer->pool, batch, &buffer->allocation, offset, size);
+}
+
+VkcBufferPool* vkc_buffer_pool_create(VkcMemoryPool* memory, VkDeviceSize limit) {
+    if (!memory) {
+        LOG_ERROR("[VkcBufferPool] Missing memory pool.");
+        return NULL;
+    }
+
+    VkcBufferPool* pool = page_malloc(memory->pager, sizeof(*pool), alignof(*pool));
+    if (!pool) {
+        LOG_ERROR("[VkcBufferPool] Failed to allocate pool structure.");
+        return NULL;
+    }
+
+    *pool = (VkcBufferPool) {
+        .pager = memory->pager,
+        .memory = memory,
+        .limit = 0 == limit ? UINT64_MAX : limit,
+    };
+
+    if (0 != pthread_mutex_init(&pool->mutex, NULL)) {
+        LOG_ERROR("[VkcBufferPool] Failed to initialize pool mutex.");
+        page_free(memory->pager, pool);
+        return NULL;
+    }
+
+    return pool;
+}
+
+void vkc_buffer_pool_free(VkcBufferPool* pool) {
+    if (!pool) {
+        return;
+    }
+
+#if defined(VKC_DEBUG) && (1 == VKC_DEBUG)
+    LOG_DEBUG(
+        "[VkcBufferPool] %llu hits, %llu misses.",
+        (unsigned long long) pool->hits,
+        (unsigned long long) pool->misses
+    );
+#endif
+
+    vkc_buffer_pool_trim(pool, 0);
+
+    while (pool->spare) {
+        VkcBufferPoolEntry* next = pool->spare->next;
+        page_free(pool->pager, pool->spare);
+        pool->spare = next;
+    }
+
+    pthread_mutex_destroy(&pool->mutex);
+    page_free(pool->pager, pool);
+}
+
+VkcBuffer* vkc_buffer_pool_acquire(
+    VkcBufferPool* pool,
+    VkDeviceSize size,
+    VkBufferUsageFlags usage,
+    VkcMemoryIntent intent,
+    VkcBufferFlags flags
+) {
+    if (!pool || 0 == size) {
+        LOG_ERROR("[VkcBufferPool] Invalid acquire arguments.");
+        return NULL;
+    }
+
+    uint32_t bucket = vkc_buffer_pool_class(size);
+    if (bucket >= VKC_BUFFER_POOL_CLASSES) {
+        LOG_ERROR("[VkcBufferPool] Size %llu exceeds every size class.", (unsigned long long) size);
+        return NULL;
+    }
+
+    pthread_mutex_lock(&pool->mutex);
+
+    // Newest first: recently released buffers are the likeliest to be warm.
+    for (VkcBufferPoolEntry* entry = pool->head[bucket]; entry; entry = entry->next) {
+        VkcBuffer* buffer = entry->buffer;
+        if (buffer->usage == usage && buffer->intent == intent && buffer->flags == flags) {
+            vkc_buffer_pool_unlink(pool, bucket, entry);
+            pool->hits++;
+            pthread_mutex_unlock(&pool->mutex);
+            return buffer;
+        }
+    }
+
+    pool->misses++;
+    pthread_mutex_unlock(&pool->mutex);
+
+    VkDeviceSize bucket_size = 1ull << (bucket + VKC_BUFFER_POOL_MIN_ORDER);
+    VkcBuffer* buffer = vkc_buffer_create(pool->memory, bucket_size, usage, intent, flags);
+    if (!buffer) {
+        LOG_WARN("[VkcBufferPool] Allocation failed; trimming cache and retrying.");
+        vkc_buffer_pool_trim(pool, 0);
+        buffer = vkc_buffer_create(pool->memory, bucket_size, usage, intent, flags);
+    }
+
+    return buffer;
+}
+
+void vkc_buffer_pool_release(VkcBufferPool* pool, VkcBuffer* buffer) {
+    if (!pool || !buffer) {
+        return;
+    }
+
+    uint32_t bucket = vkc_buffer_pool_class(buffer->size);
+    if (buffer->pool != pool->memory || (buffer->flags & VKC_BUFFER_IMPORTED_BIT)
+        || bucket >= VKC_BUFFER_POOL_CLASSES
+        || buffer->size != 1ull << (bucket + VKC_BUFFER_POOL_MIN_ORDER)) {
+        vkc_buffer_free(buffer);
+        return;
+    }
+
+    pthread_mutex_lock(&pool->mutex);
+
+    VkcBufferPoolEntry* entry = pool->spare;
+    if (entry) {
+        pool->spare = entry->next;
+    } else {
+        entry = page_malloc(pool->pager, sizeof(*entry), alignof(*entry));
+        if (!entry) {
+            pthread_mutex_unlock(&pool->mutex);
+            LOG_ERROR("[VkcBufferPool] Failed to allocate entry; freeing buffer.");
+            vkc_buffer_free(buffer);
+            return;
+        }
+    }
+
+    *entry = (VkcBufferPoolEntry) {
+        .next = pool->head[bucket],
+        .prev = NULL,
+        .buffer = buffer,
+        .tick = ++pool->tick,
+    };
+
+    if (entry->next) {
+        entry->next->prev = entry;
+    } else {
+        pool->tail[bucket] = entry;
+    }
+    pool->head[bucket] = entry;
+    pool->cached += buffer->size;
+
+    VkcBufferPoolEntry* evicted = vkc_buffer_pool_evict(pool, pool->limit);
+
+    pthread_mutex_unlock(&pool->mutex);
+    vkc_buffer_pool_drop(pool, evicted);
+}
+
+void vkc_buffer_pool_trim(VkcBufferPool* pool, VkDeviceSize keep) {
+    if (!pool) {
+        return;
+    }
+
+    pthread_mutex_lock(&pool->mutex);
+    VkcBufferPoolEntry* evicted = vkc_buffer_pool_evict(pool, keep);
+    pthread_mutex_unlock(&pool->mutex);
+
+    vkc_buffer_pool_drop(pool, evicted);
+}
+
+/** @} */
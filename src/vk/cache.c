@@ -0,0 +1,126 @@
+/**
+ * @file src/vk/cache.c
+ * @brief Per-thread allocation caches for the Vulkan host allocator.
+ */
+
+#include "core/posix.h"
+#include "core/memory.h"
+#include "core/logger.h"
+#include "allocator/page.h"
+#include "vk/arena.h"
+#include "vk/cache.h"
+
+/**
+ * @name Size Classes
+ * {@
+ */
+
+uint32_t vkc_thread_cache_class(size_t size, size_t alignment) {
+    // Cached blocks are 16 byte aligned; stricter requests take the slow path.
+    if (alignment > VKC_CACHE_CLASS_MIN) {
+        return VKC_CACHE_CLASS_NONE;
+    }
+
+    size_t class_size = VKC_CACHE_CLASS_MIN;
+    for (uint32_t i = 0; i < VKC_CACHE_CLASS_COUNT; i++, class_size <<= 1) {
+        if (size <= class_size) {
+            return i;
+        }
+    }
+
+    return VKC_CACHE_CLASS_NONE;
+}
+
+size_t vkc_thread_cache_class_size(uint32_t size_class) {
+    return (size_t) VKC_CACHE_CLASS_MIN << size_class;
+}
+
+/** @} */
+
+/**
+ * @name Thread Cache
+ * {@
+ */
+
+VkcThreadCache* vkc_thread_cache_create(PageAllocator* pager) {
+    if (!pager) {
+        LOG_ERROR("[VkcThreadCache] Missing allocation context (PageAllocator).");
+        return NULL;
+    }
+
+    VkcThreadCache* cache = page_malloc(pager, sizeof(*cache), alignof(*cache));
+    if (!cache) {
+        LOG_ERROR("[VkcThreadCache] Failed to allocate thread cache.");
+        return NULL;
+    }
+
+    memset(cache, 0, sizeof(*cache));
+    atomic_init(&cache->remote, NULL);
+    atomic_init(&cache->active, true);
+
+    for (uint32_t i = 0; i < 2; i++) {
+        cache->arenas[i] = vkc_arena_create(pager, VKC_ARENA_CHUNK_SIZE);
+        if (!cache->arenas[i]) {
+            LOG_ERROR("[VkcThreadCache] Failed to create scope arena %u.", i);
+            vkc_arena_free(cache->arenas[0]);
+            page_free(pager, cache);
+            return NULL;
+        }
+    }
+
+    return cache;
+}
+
+void vkc_thread_cache_free(VkcThreadCache* cache, PageAllocator* pager) {
+    if (!cache) {
+        return;
+    }
+
+    for (uint32_t i = 0; i < 2; i++) {
+        vkc_arena_free(cache->arenas[i]);
+    }
+
+    page_free(pager, cache);
+}
+
+void* vkc_thread_cache_pop(VkcThreadCache* cache, uint32_t size_class) {
+    VkcCacheMagazine* magazine = &cache->magazines[size_class];
+    VkcCacheNode* node = magazine->head;
+    if (node) {
+        magazine->head = node->next;
+        magazine->count--;
+    }
+    return node;
+}
+
+bool vkc_thread_cache_push(VkcThreadCache* cache, uint32_t size_class, void* pointer) {
+    VkcCacheMagazine* magazine = &cache->magazines[size_class];
+    if (magazine->count >= VKC_CACHE_MAGAZINE_SIZE) {
+        return false;
+    }
+
+    VkcCacheNode* node = (VkcCacheNode*) pointer;
+    node->next = magazine->head;
+    magazine->head = node;
+    magazine->count++;
+    return true;
+}
+
+void vkc_thread_cache_push_remote(VkcThreadCache* owner, void* pointer) {
+    VkcCacheNode* node = (VkcCacheNode*) pointer;
+    VkcCacheNode* head = atomic_load_explicit(&owner->remote, memory_order_relaxed);
+    do {
+        node->next = head;
+    } while (!atomic_compare_exchange_weak_explicit(
+        &owner->remote, &head, node, memory_order_release, memory_order_relaxed
+    ));
+}
+
+VkcCacheNode* vkc_thread_cache_collect(VkcThreadCache* cache) {
+    if (!atomic_load_explicit(&cache->remote, memory_order_relaxed)) {
+        return NULL;
+    }
+    return atomic_exchange_explicit(&cache->remote, NULL, memory_order_acquire);
+}
+
+/** @} */
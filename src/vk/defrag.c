@@ -0,0 +1,369 @@
+/**
+ * @file src/vk/defrag.c
+ * @brief Incremental defragmentation of pooled buffer memory.
+ */
+
+#include "core/posix.h"
+#include "core/memory.h"
+#include "core/logger.h"
+#include "allocator/page.h"
+#include "vk/memory.h"
+#include "vk/buffer.h"
+#include "vk/sync.h"
+#include "vk/defrag.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+/**
+ * @section Private
+ * {@
+ */
+
+static bool vkc_defrag_host_visible(const VkcBuffer* buffer) {
+    return buffer->allocation.flags & VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT;
+}
+
+static bool vkc_defrag_movable(const VkcBuffer* buffer) {
+    const VkBufferUsageFlags copy = VK_BUFFER_USAGE_TRANSFER_SRC_BIT
+                                    | VK_BUFFER_USAGE_TRANSFER_DST_BIT;
+
+    if (!buffer->allocation.block || buffer->allocation.block->dedicated) {
+        return false;
+    }
+
+    return vkc_defrag_host_visible(buffer) || copy == (buffer->usage & copy);
+}
+
+// Emptiest block first; buffers of one block stay together.
+static int vkc_defrag_compare(const void* a, const void* b) {
+    const VkcMemoryBlock* x = (*(VkcBuffer* const*) a)->allocation.block;
+    const VkcMemoryBlock* y = (*(VkcBuffer* const*) b)->allocation.block;
+
+    if (x->used != y->used) {
+        return x->used < y->used ? -1 : 1;
+    }
+    if (x != y) {
+        return (uintptr_t) x < (uintptr_t) y ? -1 : 1;
+    }
+    return 0;
+}
+
+static bool vkc_defrag_reserve(VkcDefrag* defrag) {
+    if (defrag->retired_count < defrag->retired_capacity) {
+        return true;
+    }
+
+    size_t capacity = defrag->retired_capacity * 2;
+    VkcDefragRetired* retired = page_realloc(
+        defrag->pager, defrag->retired, capacity * sizeof(*retired), alignof(VkcDefragRetired)
+    );
+    if (!retired) {
+        LOG_ERROR("[VkcDefrag] Failed to grow retired array to %zu entries.", capacity);
+        return false;
+    }
+
+    defrag->retired = retired;
+    defrag->retired_capacity = capacity;
+    return true;
+}
+
+static void vkc_defrag_release(
+    VkcDefrag* defrag, VkBuffer object, VkcMemoryAllocation* allocation
+) {
+    vkDestroyBuffer(defrag->pool->device, object, defrag->pool->callbacks);
+    vkc_memory_free(defrag->pool, allocation);
+}
+
+static bool vkc_defrag_copy_host(
+    VkcDefrag* defrag, VkcBuffer* buffer, VkcMemoryAllocation* target
+) {
+    VkcMemoryPool* pool = defrag->pool;
+
+    void* src = vkc_memory_map(pool, &buffer->allocation);
+    void* dst = vkc_memory_map(pool, target);
+    if (!src || !dst) {
+        return false;
+    }
+
+    VkcMemoryBatch invalidate = {.op = VKC_MEMORY_INVALIDATE};
+    if (!vkc_memory_batch_add(pool, &invalidate, &buffer->allocation, 0, buffer->size)
+        || !vkc_memory_batch_submit(pool, &invalidate)) {
+        return false;
+    }
+
+    memcpy(dst, src, buffer->size);
+
+    VkcMemoryBatch flush = {.op = VKC_MEMORY_FLUSH};
+    return vkc_memory_batch_add(pool, &flush, target, 0, buffer->size)
+           && vkc_memory_batch_submit(pool, &flush);
+}
+
+static bool vkc_defrag_move(VkcDefrag* defrag, VkcBuffer* buffer, VkCommandBuffer command) {
+    VkcMemoryPool* pool = defrag->pool;
+    bool host = vkc_defrag_host_visible(buffer);
+
+    if (!host && (!command || !vkc_defrag_reserve(defrag))) {
+        return false;
+    }
+
+    VkBufferCreateInfo info = {
+        .sType = VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO,
+        .size = buffer->size,
+        .usage = buffer->usage,
+        .sharingMode = VK_SHARING_MODE_EXCLUSIVE,
+    };
+
+    VkBuffer object = VK_NULL_HANDLE;
+    VkResult result = vkCreateBuffer(pool->device, &info, pool->callbacks, &object);
+    if (VK_SUCCESS != result) {
+        LOG_ERROR("[VkcDefrag] Failed to create buffer (VkResult=%d).", result);
+        return false;
+    }
+
+    VkMemoryRequirements requirements = {0};
+    vkGetBufferMemoryRequirements(pool->device, object, &requirements);
+
+    VkcMemoryAllocation target = {0};
+    if (!vkc_memory_relocate(pool, &buffer->allocation, &requirements, &target)) {
+        vkDestroyBuffer(pool->device, object, pool->callbacks);
+        return false; // Already in the densest block that fits.
+    }
+
+    result = vkBindBufferMemory(pool->device, object, target.memory, target.offset);
+    if (VK_SUCCESS != result || (host && !vkc_defrag_copy_host(defrag, buffer, &target))) {
+        LOG_ERROR("[VkcDefrag] Failed to move buffer (VkResult=%d).", result);
+        vkc_defrag_release(defrag, object, &target);
+        return false;
+    }
+
+    VkBuffer previous = buffer->object;
+    if (host) {
+        vkc_defrag_release(defrag, previous, &buffer->allocation);
+    } else {
+        VkBufferCopy region = {.srcOffset = 0, .dstOffset = 0, .size = buffer->size};
+        vkCmdCopyBuffer(command, previous, object, 1, &region);
+
+        defrag->retired[defrag->retired_count++] = (VkcDefragRetired) {
+            .object = previous,
+            .allocation = buffer->allocation,
+            .committed = false,
+        };
+    }
+
+    buffer->object = object;
+    buffer->allocation = target;
+    if (buffer->flags & VKC_BUFFER_MAPPED_BIT) {
+        buffer->mapped = vkc_memory_map(pool, &buffer->allocation);
+    }
+
+    if (defrag->moved) {
+        defrag->moved(buffer, previous, defrag->user);
+    }
+
+    return true;
+}
+
+/** @} */
+
+/**
+ * @name Public
+ * {@
+ */
+
+VkcDefrag* vkc_defrag_create(VkcMemoryPool* pool, VkcDefragMoved moved, void* user) {
+    if (!pool) {
+        LOG_ERROR("[VkcDefrag] Missing memory pool.");
+        return NULL;
+    }
+
+    PageAllocator* pager = pool->pager;
+
+    VkcDefrag* defrag = page_malloc(pager, sizeof(*defrag), alignof(*defrag));
+    if (!defrag) {
+        LOG_ERROR("[VkcDefrag] Failed to allocate defragmenter structure.");
+        return NULL;
+    }
+
+    VkcBuffer** buffers = page_malloc(
+        pager, VKC_DEFRAG_CAPACITY * sizeof(*buffers), alignof(VkcBuffer*)
+    );
+    VkcDefragRetired* retired = page_malloc(
+        pager, VKC_DEFRAG_CAPACITY * sizeof(*retired), alignof(VkcDefragRetired)
+    );
+    if (!buffers || !retired) {
+        LOG_ERROR("[VkcDefrag] Failed to allocate %d entries.", VKC_DEFRAG_CAPACITY);
+        if (buffers) {
+            page_free(pager, buffers);
+        }
+        if (retired) {
+            page_free(pager, retired);
+        }
+        page_free(pager, defrag);
+        return NULL;
+    }
+
+    *defrag = (VkcDefrag) {
+        .pager = pager,
+        .pool = pool,
+        .buffers = buffers,
+        .capacity = VKC_DEFRAG_CAPACITY,
+        .retired = retired,
+        .retired_capacity = VKC_DEFRAG_CAPACITY,
+        .moved = moved,
+        .user = user,
+    };
+
+    return defrag;
+}
+
+void vkc_defrag_free(VkcDefrag* defrag) {
+    if (!defrag) {
+        return;
+    }
+
+    for (size_t i = 0; i < defrag->retired_count; i++) {
+        VkcDefragRetired* retired = &defrag->retired[i];
+        if (retired->committed) {
+            vkc_sync_point_wait(defrag->pool->device, &retired->point, UINT64_MAX);
+        }
+        vkc_defrag_release(defrag, retired->object, &retired->allocation);
+    }
+
+    page_free(defrag->pager, defrag->retired);
+    page_free(defrag->pager, defrag->buffers);
+    page_free(defrag->pager, defrag);
+}
+
+bool vkc_defrag_add(VkcDefrag* defrag, VkcBuffer* buffer) {
+    if (!defrag || !buffer || buffer->pool != defrag->pool) {
+        LOG_ERROR("[VkcDefrag] Invalid buffer arguments.");
+        return false;
+    }
+
+    if (!vkc_defrag_movable(buffer)) {
+        LOG_ERROR("[VkcDefrag] Buffer is dedicated or lacks TRANSFER_SRC and TRANSFER_DST usage.");
+        return false;
+    }
+
+    if (defrag->count == defrag->capacity) {
+        size_t capacity = defrag->capacity * 2;
+        VkcBuffer** buffers = page_realloc(
+            defrag->pager, defrag->buffers, capacity * sizeof(*buffers), alignof(VkcBuffer*)
+        );
+        if (!buffers) {
+            LOG_ERROR("[VkcDefrag] Failed to grow buffer array to %zu entries.", capacity);
+            return false;
+        }
+        defrag->buffers = buffers;
+        defrag->capacity = capacity;
+    }
+
+    defrag->buffers[defrag->count++] = buffer;
+    return true;
+}
+
+void vkc_defrag_remove(VkcDefrag* defrag, VkcBuffer* buffer) {
+    if (!defrag) {
+        return;
+    }
+
+    for (size_t i = 0; i < defrag->count; i++) {
+        if (defrag->buffers[i] == buffer) {
+            defrag->buffers[i] = defrag->buffers[--defrag->count];
+            return;
+        }
+    }
+}
+
+uint32_t vkc_defrag_step(VkcDefrag* defrag, VkCommandBuffer command, VkDeviceSize max_bytes) {
+    if (!defrag || 0 == defrag->count) {
+        return 0;
+    }
+
+    qsort(defrag->buffers, defrag->count, sizeof(*defrag->buffers), vkc_defrag_compare);
+
+    uint32_t moves = 0;
+    bool recorded = false;
+    VkDeviceSize bytes = 0;
+
+    for (size_t i = 0; i < defrag->count && bytes < max_bytes; i++) {
+        VkcBuffer* buffer = defrag->buffers[i];
+        VkDeviceSize size = VKC_MEMORY_MIN_SIZE << buffer->allocation.order;
+        if (bytes + size > max_bytes) {
+            continue;
+        }
+
+        bool host = vkc_defrag_host_visible(buffer);
+        if (vkc_defrag_move(defrag, buffer, command)) {
+            recorded |= !host;
+            bytes += size;
+            moves++;
+        }
+    }
+
+    if (recorded) {
+        VkMemoryBarrier barrier = {
+            .sType = VK_STRUCTURE_TYPE_MEMORY_BARRIER,
+            .srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT,
+            .dstAccessMask = VK_ACCESS_MEMORY_READ_BIT | VK_ACCESS_MEMORY_WRITE_BIT,
+        };
+        vkCmdPipelineBarrier(
+            command,
+            VK_PIPELINE_STAGE_TRANSFER_BIT,
+            VK_PIPELINE_STAGE_ALL_COMMANDS_BIT,
+            0,
+            1,
+            &barrier,
+            0,
+            NULL,
+            0,
+            NULL
+        );
+    }
+
+    defrag->bytes_moved += bytes;
+
+#if defined(VKC_DEBUG) && (1 == VKC_DEBUG)
+    if (moves) {
+        LOG_DEBUG("[VkcDefrag] Moved %u buffers (%llu bytes).", moves, (unsigned long long) bytes);
+    }
+#endif
+
+    return moves;
+}
+
+void vkc_defrag_commit(VkcDefrag* defrag, VkcSyncPoint point) {
+    if (!defrag) {
+        return;
+    }
+
+    for (size_t i = 0; i < defrag->retired_count; i++) {
+        VkcDefragRetired* retired = &defrag->retired[i];
+        if (!retired->committed) {
+            retired->point = point;
+            retired->committed = true;
+        }
+    }
+}
+
+size_t vkc_defrag_reclaim(VkcDefrag* defrag) {
+    if (!defrag) {
+        return 0;
+    }
+
+    size_t kept = 0;
+    for (size_t i = 0; i < defrag->retired_count; i++) {
+        VkcDefragRetired* retired = &defrag->retired[i];
+        if (retired->committed && vkc_sync_point_poll(defrag->pool->device, &retired->point)) {
+            vkc_defrag_release(defrag, retired->object, &retired->allocation);
+        } else {
+            defrag->retired[kept++] = *retired;
+        }
+    }
+
+    defrag->retired_count = kept;
+    return kept;
+}
+
+/** @} */
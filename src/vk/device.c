@@ -157,6 +157,190 @@ void vkc_device_queue_family_free(VkcDeviceQueueFamily* family) {
     }
 }
 
+uint32_t vkc_device_queue_family_transfer(const VkcDeviceQueueFamily* family) {
+    if (!family) {
+        return UINT32_MAX;
+    }
+
+    // Graphics and compute families can copy too, but only a family that can
+    // do nothing else is backed by a separate DMA engine.
+    for (uint32_t i = 0; i < family->count; i++) {
+        VkQueueFlags flags = family->properties[i].queueFlags;
+        if ((flags & VK_QUEUE_TRANSFER_BIT)
+            && !(flags & (VK_QUEUE_GRAPHICS_BIT | VK_QUEUE_COMPUTE_BIT))
+            && family->properties[i].queueCount) {
+            return i;
+        }
+    }
+
+    return UINT32_MAX;
+}
+
+/** @} */
+
+/**
+ * @name DeviceQueueRequest Device Queue Requests
+ * @{
+ */
+
+VkcDeviceQueueRequest* vkc_device_queue_request_create(
+    VkPhysicalDevice device, VkQueueFlags flags
+) {
+    if (!device || 0 == flags) {
+        LOG_ERROR("[VkcDeviceQueueRequest] Invalid parameters given.");
+        return NULL;
+    }
+
+    PageAllocator* allocator = vkc_allocator_get();
+    if (!allocator) {
+        LOG_ERROR("[VkcDeviceQueueRequest] Failed to get global allocator.");
+        return NULL;
+    }
+
+    VkcDeviceQueueFamily* family = vkc_device_queue_family_create(device);
+    if (!family) {
+        return NULL;
+    }
+
+    VkcDeviceQueueRequest* request = page_malloc(allocator, sizeof(*request), alignof(*request));
+    if (!request) {
+        LOG_ERROR("[VkcDeviceQueueRequest] Failed to allocate request structure.");
+        vkc_device_queue_family_free(family);
+        return NULL;
+    }
+
+    *request = (VkcDeviceQueueRequest) {
+        .infos = NULL,
+        .priorities = NULL,
+        .count = 0,
+        .queue_count = 0,
+        .transfer_family = UINT32_MAX,
+    };
+
+    // Every family shares one priority array, so size it for the largest.
+    uint32_t max_queue_count = 0;
+    for (uint32_t i = 0; i < family->count; i++) {
+        if (family->properties[i].queueCount > max_queue_count) {
+            max_queue_count = family->properties[i].queueCount;
+        }
+    }
+
+    request->infos = page_malloc(
+        allocator,
+        family->count * sizeof(VkDeviceQueueCreateInfo),
+        alignof(VkDeviceQueueCreateInfo)
+    );
+    request->priorities = page_malloc(allocator, max_queue_count * sizeof(float), alignof(float));
+
+    if (!request->infos || !request->priorities) {
+        LOG_ERROR("[VkcDeviceQueueRequest] Failed to allocate %u queue infos.", family->count);
+        vkc_device_queue_family_free(family);
+        vkc_device_queue_request_free(request);
+        return NULL;
+    }
+
+    for (uint32_t i = 0; i < max_queue_count; i++) {
+        request->priorities[i] = 1.0f;
+    }
+
+    // First pass: families without graphics, second pass: the rest
+    for (uint32_t pass = 0; pass < 2; pass++) {
+        for (uint32_t i = 0; i < family->count; i++) {
+            VkQueueFamilyProperties* properties = &family->properties[i];
+            bool graphics = properties->queueFlags & VK_QUEUE_GRAPHICS_BIT;
+            if ((properties->queueFlags & flags) != flags || graphics != (1 == pass)
+                || 0 == properties->queueCount) {
+                continue;
+            }
+
+            request->infos[request->count++] = (VkDeviceQueueCreateInfo) {
+                .sType = VK_STRUCTURE_TYPE_DEVICE_QUEUE_CREATE_INFO,
+                .queueFamilyIndex = i,
+                .queueCount = properties->queueCount,
+                .pQueuePriorities = request->priorities,
+            };
+            request->queue_count += properties->queueCount;
+
+#if defined(VKC_DEBUG) && (1 == VKC_DEBUG)
+            LOG_DEBUG(
+                "[VkcDeviceQueueRequest] family=%u, queues=%u, flags=0x%x",
+                i,
+                properties->queueCount,
+                (unsigned) properties->queueFlags
+            );
+#endif
+        }
+    }
+
+    vkc_device_queue_family_free(family);
+
+    if (0 == request->count) {
+        LOG_ERROR("[VkcDeviceQueueRequest] No queue family supports flags 0x%x.", (unsigned) flags);
+        vkc_device_queue_request_free(request);
+        return NULL;
+    }
+
+    return request;
+}
+
+uint32_t vkc_device_queue_request_add_transfer(
+    VkcDeviceQueueRequest* request, VkPhysicalDevice device
+) {
+    if (!request || !device) {
+        LOG_ERROR("[VkcDeviceQueueRequest] Invalid parameters given.");
+        return UINT32_MAX;
+    }
+
+    if (UINT32_MAX != request->transfer_family) {
+        return request->transfer_family;
+    }
+
+    VkcDeviceQueueFamily* family = vkc_device_queue_family_create(device);
+    if (!family) {
+        return UINT32_MAX;
+    }
+
+    uint32_t index = vkc_device_queue_family_transfer(family);
+    vkc_device_queue_family_free(family);
+
+    // Each family appears in infos at most once, so there is always room.
+    for (uint32_t i = 0; UINT32_MAX != index && i < request->count; i++) {
+        if (request->infos[i].queueFamilyIndex == index) {
+            index = UINT32_MAX; // Already requested for its other flags
+        }
+    }
+
+    if (UINT32_MAX == index) {
+#if defined(VKC_DEBUG) && (1 == VKC_DEBUG)
+        LOG_DEBUG("[VkcDeviceQueueRequest] No dedicated transfer family.");
+#endif
+        return UINT32_MAX;
+    }
+
+    request->infos[request->count++] = (VkDeviceQueueCreateInfo) {
+        .sType = VK_STRUCTURE_TYPE_DEVICE_QUEUE_CREATE_INFO,
+        .queueFamilyIndex = index,
+        .queueCount = 1,
+        .pQueuePriorities = request->priorities,
+    };
+    request->transfer_family = index;
+
+#if defined(VKC_DEBUG) && (1 == VKC_DEBUG)
+    LOG_DEBUG("[VkcDeviceQueueRequest] Dedicated transfer family=%u.", index);
+#endif
+
+    return index;
+}
+
+void vkc_device_queue_request_free(VkcDeviceQueueRequest* request) {
+    if (request) {
+        PageAllocator* allocator = vkc_allocator_get();
+        page_free(allocator, request->priorities);
+        page_free(allocator, request->infos);
+        page_free(allocator, request);
+    }
+}
+
 /** @} */
 
 /**
@@ -185,6 +369,7 @@ VkcPhysicalDevice* vkc_device_physical_create(VkcDeviceList* list) {
     *device = (VkcPhysicalDevice) {
         .object = VK_NULL_HANDLE,
         .queue_family_index = 0,
+        .transfer_family_index = 0,
     };
 
     static const VkPhysicalDeviceType types[] = {
@@ -224,8 +409,10 @@ VkcPhysicalDevice* vkc_device_physical_create(VkcDeviceList* list) {
                             VK_VERSION_PATCH(properties.driverVersion)
                         );
 #endif
+                        uint32_t transfer = vkc_device_queue_family_transfer(family);
                         vkc_device_queue_family_free(family);
                         device->queue_family_index = k;
+                        device->transfer_family_index = UINT32_MAX == transfer ? k : transfer;
                         device->object = candidate;
                         return device;
                     }
@@ -601,86 +788,112 @@ void vkc_device_extension_match_free(VkcDeviceExtensionMatch* match) {
  * @{
  */
 
-// VkcDevice* vkc_device_create(VkcInstance* instance) {
-//     PageAllocator* pager = vkc_allocator_get();
-//     if (!pager) {
-//         LOG_ERROR("Failed to create device pager.");
-//         return NULL;
-//     }
-
-//     VkcDevice* device = page_malloc(pager, sizeof(VkcDevice), alignof(VkcDevice));
-//     if (!device) {
-//         page_allocator_free(pager);
-//         return NULL;
-//     }
-
-//     device->queue_family_index = UINT32_MAX;
-//     device->physical = VK_NULL_HANDLE;
-//     device->logical = VK_NULL_HANDLE;
-//     device->queue = VK_NULL_HANDLE;
-//     device->pager = pager;
-//     device->allocator = vkc_page_callbacks(pager);
-
-//     uint32_t device_count = vkc_physical_device_count(instance);
-//     if (0 == device_count) {
-//         page_allocator_free(pager);
-//         return NULL;
-//     }
-
-// #if defined(DEBUG) && (1 == DEBUG)
-//     LOG_DEBUG("[VK_DEVICE] count=%u", device_count);
-// #endif
-
-//     VkPhysicalDevice* device_list = vkc_physical_device_list(pager, instance, device_count);
-//     if (!device_list) {
-//         page_allocator_free(pager);
-//         return NULL;
-//     }
-
-// #if defined(DEBUG) && (1 == DEBUG)
-//     for (size_t i = 0; i < device_count; i++) {
-//         VkPhysicalDevice tmp = device_list[i];
-//         VkPhysicalDeviceProperties props = {0};
-//         vkGetPhysicalDeviceProperties(tmp, &props);
-//         LOG_DEBUG("[VK_DEVICE] Option %u: %s, type=%d", i, props.deviceName, props.deviceType);
-//     }
-// #endif
-
-//     if (!vkc_physical_device_select(device, device_list, device_count)) {
-//         LOG_ERROR("No suitable Vulkan device found.");
-//         page_allocator_free(pager);
-//         return NULL;
-//     }
-
-//     page_free(pager, device_list); // Prevent silent leaks
-
-//     VkDeviceQueueCreateInfo queue_info = vkc_physical_device_queue_create_info(device);
-//     VkDeviceCreateInfo logical_info = vkc_logical_device_create_info(device, queue_info);
-
-//     VkResult result
-//         = vkCreateDevice(device->physical, &logical_info, &device->allocator, &device->logical);
-//     if (result != VK_SUCCESS) {
-//         LOG_ERROR("Failed to create logical device: %d", result);
-//         page_allocator_free(device->pager);
-//         return NULL;
-//     }
-
-//     vkGetDeviceQueue(device->logical, device->queue_family_index, 0, &device->queue);
-
-// #if defined(DEBUG) && (1 == DEBUG)
-//     LOG_DEBUG("[VK_DEVICE] Vulkan physical device created successfully @ %p", device->physical);
-//     LOG_DEBUG("[VK_DEVICE] Vulkan logical device created successfully @ %p", device->logical);
-//     LOG_DEBUG("[VK_DEVICE] Vulkan device queue created successfully @ %p", device->queue);
-// #endif
-
-//     return device;
-// }
-
-// void vkc_device_destroy(VkcDevice* device) {
-//     if (device && device->pager) {
-//         if (device->logical) {
-//             vkDestroyDevice(device->logical, &device->allocator);
-//         }
-//         page_allocator_free(device->pager);
-//     }
-// }
+VkcDevice* vkc_device_create(
+    VkcAllocatorContext* context,
+    const VkcPhysicalDevice* physical,
+    const VkcDeviceQueueRequest* request,
+    const VkcDeviceLayerMatch* layer_match,
+    const VkcDeviceExtensionMatch* extension_match,
+    const void* features
+) {
+    if (!physical || !request || 0 == request->count) {
+        LOG_ERROR("[VkcDevice] Invalid device arguments.");
+        return NULL;
+    }
+
+    if (!context) {
+        context = vkc_allocator_context();
+    }
+
+    if (!context) {
+        LOG_ERROR("[VkcDevice] Missing allocation context.");
+        return NULL;
+    }
+
+    PageAllocator* allocator = vkc_allocator_context_pager(context);
+    VkcDevice* device = page_malloc(allocator, sizeof(*device), alignof(*device));
+    if (!device) {
+        LOG_ERROR("[VkcDevice] Failed to allocate device wrapper.");
+        return NULL;
+    }
+
+    *device = (VkcDevice) {
+        .object = VK_NULL_HANDLE,
+        .physical = physical->object,
+        .context = context,
+        .callbacks = vkc_allocator_context_callbacks(context),
+    };
+
+    // Without a caller chain, enable what VkcQueue and its users depend on.
+    VkPhysicalDeviceVulkan12Features vulkan12 = {
+        .sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_VULKAN_1_2_FEATURES,
+    };
+    VkPhysicalDeviceFeatures2 features2 = {
+        .sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_FEATURES_2,
+        .pNext = &vulkan12,
+    };
+
+    if (!features) {
+        VkPhysicalDeviceProperties properties;
+        vkGetPhysicalDeviceProperties(device->physical, &properties);
+
+        // The 1.2 feature struct may only be chained on a 1.2 device.
+        if (properties.apiVersion >= VK_API_VERSION_1_2) {
+            vkGetPhysicalDeviceFeatures2(device->physical, &features2);
+        }
+
+        // Enable only the timeline feature, not everything the device offers.
+        VkBool32 timeline = vulkan12.timelineSemaphore;
+        vulkan12 = (VkPhysicalDeviceVulkan12Features) {
+            .sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_VULKAN_1_2_FEATURES,
+            .timelineSemaphore = timeline,
+        };
+        features2.features = (VkPhysicalDeviceFeatures) {0};
+        features = timeline ? &features2 : NULL;
+
+        if (!timeline) {
+            LOG_WARN("[VkcDevice] timelineSemaphore is unsupported; VkcQueue will not work.");
+        }
+    }
+
+    VkDeviceCreateInfo create_info = {
+        .sType = VK_STRUCTURE_TYPE_DEVICE_CREATE_INFO,
+        .pNext = features,
+        .queueCreateInfoCount = request->count,
+        .pQueueCreateInfos = request->infos,
+    };
+
+    if (layer_match && layer_match->names) {
+        create_info.enabledLayerCount = layer_match->count;
+        create_info.ppEnabledLayerNames = (const char* const*) layer_match->names;
+    }
+
+    if (extension_match && extension_match->names) {
+        create_info.enabledExtensionCount = extension_match->count;
+        create_info.ppEnabledExtensionNames = (const char* const*) extension_match->names;
+    }
+
+    VkResult result = vkCreateDevice(
+        device->physical, &create_info, device->callbacks, &device->object
+    );
+    if (VK_SUCCESS != result) {
+        LOG_ERROR("[VkcDevice] Failed to create logical device (VkResult=%d).", result);
+        page_free(allocator, device);
+        return NULL;
+    }
+
+#if defined(VKC_DEBUG) && (1 == VKC_DEBUG)
+    LOG_DEBUG("[VkcDevice] Successfully created logical device @ %p.", (void*) device->object);
+#endif
+
+    return device;
+}
+
+void vkc_device_destroy(VkcDevice* device) {
+    if (device && device->object) {
+        vkDestroyDevice(device->object, device->callbacks);
+        page_free(vkc_allocator_context_pager(device->context), device);
+    }
+}
+
+/** @} */
@@ -344,9 +344,19 @@ void vkc_instance_extension_match_free(VkcInstanceExtensionMatch* match) {
  */
 
 VkcInstance* vkc_instance_create(
+    VkcAllocatorContext* context,
     VkcInstanceLayerMatch* layer_match,
     VkcInstanceExtensionMatch* extension_match
 ) {
+    if (!context) {
+        context = vkc_allocator_context();
+    }
+
+    if (!context) {
+        LOG_ERROR("[VkcInstance] Missing allocation context.");
+        return NULL;
+    }
+
     uint32_t version;
     VkResult result = vkEnumerateInstanceVersion(&version);
     if (VK_SUCCESS != result) {
@@ -401,12 +411,7 @@ VkcInstance* vkc_instance_create(
         create_info.ppEnabledExtensionNames = (const char* const*) extension_match->names;
     }
 
-    PageAllocator* allocator = vkc_allocator_get();
-    if (!allocator) {
-        LOG_ERROR("[VkcInstance] Failed to get global allocator.");
-        return NULL;
-    }
-
+    PageAllocator* allocator = vkc_allocator_context_pager(context);
     VkcInstance* instance = page_malloc(allocator, sizeof(*instance), alignof(*instance));
     if (!instance) {
         LOG_ERROR("[VkcInstance] Failed to allocate instance wrapper.");
@@ -415,7 +420,8 @@ VkcInstance* vkc_instance_create(
 
     *instance = (VkcInstance){
         .object = VK_NULL_HANDLE,
-        .callbacks = vkc_allocator_callbacks(),
+        .context = context,
+        .callbacks = vkc_allocator_context_callbacks(context),
     };
 
     result = vkCreateInstance(&create_info, instance->callbacks, &instance->object);
@@ -435,7 +441,7 @@ VkcInstance* vkc_instance_create(
 void vkc_instance_free(VkcInstance* instance) {
     if (instance && instance->object) {
         vkDestroyInstance(instance->object, instance->callbacks);
-        page_free(vkc_allocator_get(), instance);
+        page_free(vkc_allocator_context_pager(instance->context), instance);
     }
 }
 
@@ -0,0 +1,359 @@
+/**
+ * @file src/vk/job.c
+ * @brief Compute dispatches recorded once and submitted many times.
+ */
+
+#include "core/posix.h"
+#include "core/memory.h"
+#include "core/logger.h"
+#include "allocator/page.h"
+#include "vk/buffer.h"
+#include "vk/sync.h"
+#include "vk/queue.h"
+#include "vk/job.h"
+
+/**
+ * @section Private
+ * {@
+ */
+
+static bool vkc_recorded_job_frame_create(
+    VkcRecordedJob* job, const VkcJobInfo* info, VkcJobFrame* frame
+) {
+    VkcMemoryPool* pool = job->pool;
+
+    frame->args = vkc_buffer_create(
+        pool,
+        sizeof(VkDispatchIndirectCommand),
+        VK_BUFFER_USAGE_INDIRECT_BUFFER_BIT,
+        VKC_MEMORY_STREAMING,
+        VKC_BUFFER_MAPPED_BIT
+    );
+    if (!frame->args) {
+        LOG_ERROR("[VkcRecordedJob] Failed to create indirect buffer.");
+        return false;
+    }
+
+    if (0 == job->params_size) {
+        return true;
+    }
+
+    VkBufferUsageFlags usage = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER == info->params_type
+                                   ? VK_BUFFER_USAGE_UNIFORM_BUFFER_BIT
+                                   : VK_BUFFER_USAGE_STORAGE_BUFFER_BIT;
+    frame->params = vkc_buffer_create(
+        pool, job->params_size, usage, VKC_MEMORY_STREAMING, VKC_BUFFER_MAPPED_BIT
+    );
+    if (!frame->params) {
+        LOG_ERROR("[VkcRecordedJob] Failed to create parameter buffer.");
+        return false;
+    }
+
+    VkDescriptorSetAllocateInfo set_info = {
+        .sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO,
+        .descriptorPool = job->descriptor_pool,
+        .descriptorSetCount = 1,
+        .pSetLayouts = &info->params_layout,
+    };
+    VkResult result = vkAllocateDescriptorSets(pool->device, &set_info, &frame->set);
+    if (VK_SUCCESS != result) {
+        LOG_ERROR("[VkcRecordedJob] Failed to allocate descriptor set (VkResult=%d).", result);
+        return false;
+    }
+
+    VkDescriptorBufferInfo buffer_info = {
+        .buffer = frame->params->object,
+        .offset = 0,
+        .range = job->params_size,
+    };
+    VkWriteDescriptorSet write = {
+        .sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET,
+        .dstSet = frame->set,
+        .dstBinding = 0,
+        .descriptorCount = 1,
+        .descriptorType = info->params_type,
+        .pBufferInfo = &buffer_info,
+    };
+    vkUpdateDescriptorSets(pool->device, 1, &write, 0, NULL);
+
+    return true;
+}
+
+static bool vkc_recorded_job_record(const VkcJobInfo* info, VkcJobFrame* frame) {
+    VkCommandBuffer command = frame->command;
+
+    // No ONE_TIME_SUBMIT: the whole point is to submit this buffer again.
+    VkCommandBufferBeginInfo begin = {
+        .sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO,
+    };
+    VkResult result = vkBeginCommandBuffer(command, &begin);
+    if (VK_SUCCESS != result) {
+        LOG_ERROR("[VkcRecordedJob] Failed to begin recording (VkResult=%d).", result);
+        return false;
+    }
+
+    vkCmdBindPipeline(command, VK_PIPELINE_BIND_POINT_COMPUTE, info->pipeline);
+
+    if (info->push_size) {
+        vkCmdPushConstants(
+            command, info->layout, VK_SHADER_STAGE_COMPUTE_BIT, 0, info->push_size, info->push_data
+        );
+    }
+
+    VkDescriptorSet sets[VKC_JOB_SETS_MAX + 1];
+    uint32_t set_count = 0;
+    for (; set_count < info->set_count; set_count++) {
+        sets[set_count] = info->sets[set_count];
+    }
+    if (VK_NULL_HANDLE != frame->set) {
+        sets[set_count++] = frame->set;
+    }
+
+    if (set_count) {
+        vkCmdBindDescriptorSets(
+            command, VK_PIPELINE_BIND_POINT_COMPUTE, info->layout, 0, set_count, sets, 0, NULL
+        );
+    }
+
+    vkCmdDispatchIndirect(command, frame->args->object, 0);
+
+    // Callers read the results once the ticket retires, with no barrier of their own.
+    vkc_sync_compute_barrier(command);
+
+    result = vkEndCommandBuffer(command);
+    if (VK_SUCCESS != result) {
+        LOG_ERROR("[VkcRecordedJob] Failed to end recording (VkResult=%d).", result);
+        return false;
+    }
+
+    return true;
+}
+
+// Block until the next frame is free to be written.
+static VkcJobFrame* vkc_recorded_job_acquire(VkcRecordedJob* job) {
+    VkcJobFrame* frame = &job->frames[job->next];
+    if (!vkc_queue_wait(job->queue, frame->ticket, UINT64_MAX)) {
+        LOG_ERROR("[VkcRecordedJob] Failed to retire frame %u.", job->next);
+        return NULL;
+    }
+
+    return frame;
+}
+
+/** @} */
+
+/**
+ * @name Public
+ * {@
+ */
+
+VkcRecordedJob* vkc_recorded_job_create(
+    VkcMemoryPool* pool, VkcQueue* queue, const VkcJobInfo* info
+) {
+    if (!pool || !queue || !info || VK_NULL_HANDLE == info->pipeline
+        || VK_NULL_HANDLE == info->layout || (info->set_count && !info->sets)
+        || info->set_count > VKC_JOB_SETS_MAX || (info->push_size && !info->push_data)
+        || 0 == info->frames || info->frames > VKC_JOB_FRAMES_MAX
+        || (info->params_size && VK_NULL_HANDLE == info->params_layout)
+        || (info->params_size && VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER != info->params_type
+            && VK_DESCRIPTOR_TYPE_STORAGE_BUFFER != info->params_type)) {
+        LOG_ERROR("[VkcRecordedJob] Invalid job arguments.");
+        return NULL;
+    }
+
+    VkcRecordedJob* job = page_malloc(pool->pager, sizeof(*job), alignof(*job));
+    if (!job) {
+        LOG_ERROR("[VkcRecordedJob] Failed to allocate job structure.");
+        return NULL;
+    }
+
+    *job = (VkcRecordedJob) {
+        .pool = pool,
+        .queue = queue,
+        .frame_count = info->frames,
+        .params_size = info->params_size,
+    };
+
+    VkPhysicalDeviceProperties properties = {0};
+    vkGetPhysicalDeviceProperties(pool->physical, &properties);
+    for (uint32_t i = 0; i < 3; i++) {
+        job->max_groups[i] = properties.limits.maxComputeWorkGroupCount[i];
+    }
+
+    VkCommandPoolCreateInfo command_pool_info = {
+        .sType = VK_STRUCTURE_TYPE_COMMAND_POOL_CREATE_INFO,
+        .queueFamilyIndex = queue->family,
+    };
+    VkResult result = vkCreateCommandPool(
+        pool->device, &command_pool_info, pool->callbacks, &job->command_pool
+    );
+    if (VK_SUCCESS != result) {
+        LOG_ERROR("[VkcRecordedJob] Failed to create command pool (VkResult=%d).", result);
+        vkc_recorded_job_free(job);
+        return NULL;
+    }
+
+    if (info->params_size) {
+        VkDescriptorPoolSize pool_size = {
+            .type = info->params_type,
+            .descriptorCount = info->frames,
+        };
+        VkDescriptorPoolCreateInfo descriptor_pool_info = {
+            .sType = VK_STRUCTURE_TYPE_DESCRIPTOR_POOL_CREATE_INFO,
+            .maxSets = info->frames,
+            .poolSizeCount = 1,
+            .pPoolSizes = &pool_size,
+        };
+        result = vkCreateDescriptorPool(
+            pool->device, &descriptor_pool_info, pool->callbacks, &job->descriptor_pool
+        );
+        if (VK_SUCCESS != result) {
+            LOG_ERROR("[VkcRecordedJob] Failed to create descriptor pool (VkResult=%d).", result);
+            vkc_recorded_job_free(job);
+            return NULL;
+        }
+    }
+
+    VkCommandBuffer commands[VKC_JOB_FRAMES_MAX];
+    VkCommandBufferAllocateInfo command_info = {
+        .sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO,
+        .commandPool = job->command_pool,
+        .level = VK_COMMAND_BUFFER_LEVEL_PRIMARY,
+        .commandBufferCount = info->frames,
+    };
+    result = vkAllocateCommandBuffers(pool->device, &command_info, commands);
+    if (VK_SUCCESS != result) {
+        LOG_ERROR("[VkcRecordedJob] Failed to allocate command buffers (VkResult=%d).", result);
+        vkc_recorded_job_free(job);
+        return NULL;
+    }
+
+    for (uint32_t i = 0; i < info->frames; i++) {
+        VkcJobFrame* frame = &job->frames[i];
+        frame->command = commands[i];
+        if (!vkc_recorded_job_frame_create(job, info, frame)
+            || !vkc_recorded_job_record(info, frame)) {
+            vkc_recorded_job_free(job);
+            return NULL;
+        }
+    }
+
+#if defined(VKC_DEBUG) && (1 == VKC_DEBUG)
+    LOG_DEBUG(
+        "[VkcRecordedJob] Recorded %u frames with %llu bytes of parameters.",
+        info->frames,
+        (unsigned long long) info->params_size
+    );
+#endif
+
+    return job;
+}
+
+void vkc_recorded_job_free(VkcRecordedJob* job) {
+    if (!job) {
+        return;
+    }
+
+    VkcMemoryPool* pool = job->pool;
+
+    for (uint32_t i = 0; i < job->frame_count; i++) {
+        VkcJobFrame* frame = &job->frames[i];
+        vkc_queue_wait(job->queue, frame->ticket, UINT64_MAX);
+        vkc_buffer_free(frame->params);
+        vkc_buffer_free(frame->args);
+    }
+
+    // Command buffers and descriptor sets go with their pools.
+    if (VK_NULL_HANDLE != job->descriptor_pool) {
+        vkDestroyDescriptorPool(pool->device, job->descriptor_pool, pool->callbacks);
+    }
+    if (VK_NULL_HANDLE != job->command_pool) {
+        vkDestroyCommandPool(pool->device, job->command_pool, pool->callbacks);
+    }
+
+#if defined(VKC_DEBUG) && (1 == VKC_DEBUG)
+    LOG_DEBUG(
+        "[VkcRecordedJob] Replayed %llu calls without re-recording.",
+        (unsigned long long) job->submissions
+    );
+#endif
+
+    page_free(pool->pager, job);
+}
+
+void* vkc_recorded_job_map(VkcRecordedJob* job) {
+    if (!job || 0 == job->params_size) {
+        return NULL;
+    }
+
+    VkcJobFrame* frame = vkc_recorded_job_acquire(job);
+    return frame ? frame->params->mapped : NULL;
+}
+
+VkcJobFrame* vkc_recorded_job_stage(
+    VkcRecordedJob* job, const void* params, const VkDispatchIndirectCommand* groups
+) {
+    if (!job || !groups || 0 == groups->x || 0 == groups->y || 0 == groups->z) {
+        LOG_ERROR("[VkcRecordedJob] Invalid stage arguments.");
+        return NULL;
+    }
+
+    if (groups->x > job->max_groups[0] || groups->y > job->max_groups[1]
+        || groups->z > job->max_groups[2]) {
+        LOG_ERROR(
+            "[VkcRecordedJob] Dispatch of %ux%ux%u groups exceeds the device limit.",
+            groups->x,
+            groups->y,
+            groups->z
+        );
+        return NULL;
+    }
+
+    VkcJobFrame* frame = vkc_recorded_job_acquire(job);
+    if (!frame) {
+        return NULL;
+    }
+
+    VkcMemoryBatch batch = {.op = VKC_MEMORY_FLUSH};
+
+    memcpy(frame->args->mapped, groups, sizeof(*groups));
+    if (!vkc_buffer_flush(frame->args, &batch, 0, sizeof(*groups))) {
+        return NULL;
+    }
+
+    if (frame->params) {
+        if (params) {
+            memcpy(frame->params->mapped, params, job->params_size);
+        }
+        if (!vkc_buffer_flush(frame->params, &batch, 0, job->params_size)) {
+            return NULL;
+        }
+    }
+
+    if (!vkc_memory_batch_submit(job->pool, &batch)) {
+        return NULL;
+    }
+
+    job->next = (job->next + 1) % job->frame_count;
+    job->submissions++;
+    return frame;
+}
+
+uint64_t vkc_recorded_job_submit(
+    VkcRecordedJob* job, const void* params, const VkDispatchIndirectCommand* groups
+) {
+    VkcJobFrame* frame = vkc_recorded_job_stage(job, params, groups);
+    if (!frame) {
+        return 0;
+    }
+
+    VkcQueueSubmit submit = {
+        .commands = &frame->command,
+        .command_count = 1,
+    };
+
+    frame->ticket = vkc_queue_submit(job->queue, &submit);
+    return frame->ticket;
+}
+
+/** @} */
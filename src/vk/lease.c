@@ -0,0 +1,291 @@
+/**
+ * @file src/vk/lease.c
+ * @brief Bulk ownership of Vulkan handles.
+ */
+
+#include "core/posix.h"
+#include "core/memory.h"
+#include "core/logger.h"
+#include "allocator/page.h"
+#include "vk/lease.h"
+
+/**
+ * @section Private
+ * {@
+ */
+
+#if defined(VK_USE_64_BIT_PTR_DEFINES) && (1 == VK_USE_64_BIT_PTR_DEFINES)
+    #define VKC_LEASE_CAST(type, handle) ((type) (uintptr_t) (handle))
+#else
+    #define VKC_LEASE_CAST(type, handle) ((type) (handle))
+#endif
+
+static bool vkc_lease_supported(VkObjectType type) {
+    switch (type) {
+        case VK_OBJECT_TYPE_INSTANCE:
+        case VK_OBJECT_TYPE_DEVICE:
+        case VK_OBJECT_TYPE_SEMAPHORE:
+        case VK_OBJECT_TYPE_FENCE:
+        case VK_OBJECT_TYPE_DEVICE_MEMORY:
+        case VK_OBJECT_TYPE_BUFFER:
+        case VK_OBJECT_TYPE_IMAGE:
+        case VK_OBJECT_TYPE_EVENT:
+        case VK_OBJECT_TYPE_QUERY_POOL:
+        case VK_OBJECT_TYPE_BUFFER_VIEW:
+        case VK_OBJECT_TYPE_IMAGE_VIEW:
+        case VK_OBJECT_TYPE_SHADER_MODULE:
+        case VK_OBJECT_TYPE_PIPELINE_CACHE:
+        case VK_OBJECT_TYPE_PIPELINE_LAYOUT:
+        case VK_OBJECT_TYPE_PIPELINE:
+        case VK_OBJECT_TYPE_DESCRIPTOR_SET_LAYOUT:
+        case VK_OBJECT_TYPE_SAMPLER:
+        case VK_OBJECT_TYPE_DESCRIPTOR_POOL:
+        case VK_OBJECT_TYPE_COMMAND_POOL:
+            return true;
+        default:
+            return false;
+    }
+}
+
+static void vkc_lease_destroy(VkcLease* lease, VkcLeaseTenant* tenant) {
+    if (VKC_LEASE_BORROWED == tenant->policy) {
+        return;
+    }
+
+    if (tenant->destroy) {
+        tenant->destroy(tenant->user);
+        return;
+    }
+
+    const VkAllocationCallbacks* callbacks = lease->callbacks;
+    VkDevice device = (VkDevice) tenant->parent;
+    uint64_t handle = tenant->handle;
+
+    switch (tenant->type) {
+        case VK_OBJECT_TYPE_INSTANCE:
+            vkDestroyInstance((VkInstance) (uintptr_t) handle, callbacks);
+            break;
+        case VK_OBJECT_TYPE_DEVICE:
+            vkDestroyDevice((VkDevice) (uintptr_t) handle, callbacks);
+            break;
+        case VK_OBJECT_TYPE_SEMAPHORE:
+            vkDestroySemaphore(device, VKC_LEASE_CAST(VkSemaphore, handle), callbacks);
+            break;
+        case VK_OBJECT_TYPE_FENCE:
+            vkDestroyFence(device, VKC_LEASE_CAST(VkFence, handle), callbacks);
+            break;
+        case VK_OBJECT_TYPE_DEVICE_MEMORY:
+            vkFreeMemory(device, VKC_LEASE_CAST(VkDeviceMemory, handle), callbacks);
+            break;
+        case VK_OBJECT_TYPE_BUFFER:
+            vkDestroyBuffer(device, VKC_LEASE_CAST(VkBuffer, handle), callbacks);
+            break;
+        case VK_OBJECT_TYPE_IMAGE:
+            vkDestroyImage(device, VKC_LEASE_CAST(VkImage, handle), callbacks);
+            break;
+        case VK_OBJECT_TYPE_EVENT:
+            vkDestroyEvent(device, VKC_LEASE_CAST(VkEvent, handle), callbacks);
+            break;
+        case VK_OBJECT_TYPE_QUERY_POOL:
+            vkDestroyQueryPool(device, VKC_LEASE_CAST(VkQueryPool, handle), callbacks);
+            break;
+        case VK_OBJECT_TYPE_BUFFER_VIEW:
+            vkDestroyBufferView(device, VKC_LEASE_CAST(VkBufferView, handle), callbacks);
+            break;
+        case VK_OBJECT_TYPE_IMAGE_VIEW:
+            vkDestroyImageView(device, VKC_LEASE_CAST(VkImageView, handle), callbacks);
+            break;
+        case VK_OBJECT_TYPE_SHADER_MODULE:
+            vkDestroyShaderModule(device, VKC_LEASE_CAST(VkShaderModule, handle), callbacks);
+            break;
+        case VK_OBJECT_TYPE_PIPELINE_CACHE:
+            vkDestroyPipelineCache(device, VKC_LEASE_CAST(VkPipelineCache, handle), callbacks);
+            break;
+        case VK_OBJECT_TYPE_PIPELINE_LAYOUT:
+            vkDestroyPipelineLayout(device, VKC_LEASE_CAST(VkPipelineLayout, handle), callbacks);
+            break;
+        case VK_OBJECT_TYPE_PIPELINE:
+            vkDestroyPipeline(device, VKC_LEASE_CAST(VkPipeline, handle), callbacks);
+            break;
+        case VK_OBJECT_TYPE_DESCRIPTOR_SET_LAYOUT:
+            vkDestroyDescriptorSetLayout(
+                device, VKC_LEASE_CAST(VkDescriptorSetLayout, handle), callbacks
+            );
+            break;
+        case VK_OBJECT_TYPE_SAMPLER:
+            vkDestroySampler(device, VKC_LEASE_CAST(VkSampler, handle), callbacks);
+            break;
+        case VK_OBJECT_TYPE_DESCRIPTOR_POOL:
+            vkDestroyDescriptorPool(device, VKC_LEASE_CAST(VkDescriptorPool, handle), callbacks);
+            break;
+        case VK_OBJECT_TYPE_COMMAND_POOL:
+            vkDestroyCommandPool(device, VKC_LEASE_CAST(VkCommandPool, handle), callbacks);
+            break;
+        default:
+            break;
+    }
+}
+
+static bool vkc_lease_push(VkcLease* lease, VkcLeaseTenant tenant) {
+    if (lease->count == lease->capacity) {
+        size_t capacity = lease->capacity * 2;
+        VkcLeaseTenant* tenants = page_realloc(
+            lease->pager, lease->tenants, capacity * sizeof(*tenants), alignof(VkcLeaseTenant)
+        );
+        if (!tenants) {
+            LOG_ERROR("[VkcLease] Failed to grow tenant array to %zu entries.", capacity);
+            return false;
+        }
+        lease->tenants = tenants;
+        lease->capacity = capacity;
+    }
+
+    lease->tenants[lease->count++] = tenant;
+    return true;
+}
+
+static bool vkc_lease_track(
+    VkcLease* lease, VkObjectType type, uint64_t handle, void* parent, VkcLeasePolicy policy
+) {
+    if (!lease) {
+        LOG_ERROR("[VkcLease] Invalid lease.");
+        return false;
+    }
+
+    // Argument errors leave the handle with the caller; see vkc_lease_add().
+    if (!vkc_lease_supported(type)) {
+        LOG_ERROR("[VkcLease] Unsupported object type %d.", (int) type);
+        return false;
+    }
+
+    if (0 == handle) {
+        return true;
+    }
+
+    if (!parent && VK_OBJECT_TYPE_INSTANCE != type && VK_OBJECT_TYPE_DEVICE != type) {
+        LOG_ERROR("[VkcLease] Object type %d requires a parent device.", (int) type);
+        return false;
+    }
+
+    VkcLeaseTenant tenant = {
+        .type = type,
+        .policy = policy,
+        .handle = handle,
+        .parent = parent,
+    };
+
+    if (!vkc_lease_push(lease, tenant)) {
+        // Past the argument checks ownership has transferred, so destroy on failure.
+        vkc_lease_destroy(lease, &tenant);
+        return false;
+    }
+
+    return true;
+}
+
+/** @} */
+
+/**
+ * @name Public
+ * {@
+ */
+
+VkcLease* vkc_lease_create(PageAllocator* pager, const VkAllocationCallbacks* callbacks) {
+    if (!pager) {
+        LOG_ERROR("[VkcLease] Missing allocation context (PageAllocator).");
+        return NULL;
+    }
+
+    VkcLease* lease = page_malloc(pager, sizeof(*lease), alignof(*lease));
+    if (!lease) {
+        LOG_ERROR("[VkcLease] Failed to allocate lease structure.");
+        return NULL;
+    }
+
+    VkcLeaseTenant* tenants = page_malloc(
+        pager, VKC_LEASE_CAPACITY * sizeof(*tenants), alignof(VkcLeaseTenant)
+    );
+    if (!tenants) {
+        LOG_ERROR("[VkcLease] Failed to allocate %d tenants.", VKC_LEASE_CAPACITY);
+        page_free(pager, lease);
+        return NULL;
+    }
+
+    *lease = (VkcLease) {
+        .pager = pager,
+        .callbacks = callbacks,
+        .tenants = tenants,
+        .count = 0,
+        .capacity = VKC_LEASE_CAPACITY,
+    };
+
+    return lease;
+}
+
+void vkc_lease_free(VkcLease* lease) {
+    if (!lease) {
+        return;
+    }
+
+    PageAllocator* pager = lease->pager;
+
+    vkc_lease_release(lease);
+    page_free(pager, lease->tenants);
+    page_free(pager, lease);
+}
+
+bool vkc_lease_add(VkcLease* lease, VkObjectType type, uint64_t handle, void* parent) {
+    return vkc_lease_track(lease, type, handle, parent, VKC_LEASE_OWNED);
+}
+
+bool vkc_lease_borrow(VkcLease* lease, VkObjectType type, uint64_t handle, void* parent) {
+    return vkc_lease_track(lease, type, handle, parent, VKC_LEASE_BORROWED);
+}
+
+bool vkc_lease_add_custom(VkcLease* lease, VkcLeaseDestroy destroy, void* user) {
+    if (!lease || !destroy) {
+        LOG_ERROR("[VkcLease] Invalid custom tenant arguments.");
+        return false;
+    }
+
+    VkcLeaseTenant tenant = {
+        .type = VK_OBJECT_TYPE_UNKNOWN,
+        .policy = VKC_LEASE_OWNED,
+        .destroy = destroy,
+        .user = user,
+    };
+
+    if (!vkc_lease_push(lease, tenant)) {
+        vkc_lease_destroy(lease, &tenant);
+        return false;
+    }
+
+    return true;
+}
+
+size_t vkc_lease_mark(const VkcLease* lease) {
+    return lease ? lease->count : 0;
+}
+
+void vkc_lease_release_to(VkcLease* lease, size_t mark) {
+    if (!lease) {
+        return;
+    }
+
+#if defined(VKC_DEBUG) && (1 == VKC_DEBUG)
+    if (lease->count > mark) {
+        LOG_DEBUG("[VkcLease] Releasing %zu tenants.", lease->count - mark);
+    }
+#endif
+
+    // Newest first, so children always go before the objects they were created from.
+    while (lease->count > mark) {
+        vkc_lease_destroy(lease, &lease->tenants[--lease->count]);
+    }
+}
+
+void vkc_lease_release(VkcLease* lease) {
+    vkc_lease_release_to(lease, 0);
+}
+
+/** @} */
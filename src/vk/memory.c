@@ -0,0 +1,1056 @@
+/**
+ * @file src/vk/memory.c
+ * @brief Device memory sub-allocation for Vulkan resources.
+ */
+
+#include "core/posix.h"
+#include "core/memory.h"
+#include "core/logger.h"
+#include "allocator/page.h"
+#include "vk/memory.h"
+
+/**
+ * @section Private
+ * {@
+ */
+
+#define VKC_MEMORY_SMALL_HEAP (1024ull * 1024 * 1024)
+
+static inline uint32_t vkc_memory_log2(VkDeviceSize value) {
+    return 63u - (uint32_t) __builtin_clzll(value);
+}
+
+static inline VkDeviceSize vkc_memory_floor2(VkDeviceSize value) {
+    return 1ull << vkc_memory_log2(value);
+}
+
+static inline VkDeviceSize vkc_memory_ceil2(VkDeviceSize value) {
+    return value <= 1 ? 1 : 1ull << (vkc_memory_log2(value - 1) + 1);
+}
+
+/**
+ * @name Memory Type Scores
+ * @{
+ */
+
+static int32_t vkc_memory_score(VkMemoryPropertyFlags flags, VkcMemoryIntent intent) {
+    const VkMemoryPropertyFlags excluded = VK_MEMORY_PROPERTY_PROTECTED_BIT
+                                           | VK_MEMORY_PROPERTY_LAZILY_ALLOCATED_BIT;
+    if (flags & excluded) {
+        return -1;
+    }
+
+    bool local = flags & VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT;
+    bool visible = flags & VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT;
+    bool coherent = flags & VK_MEMORY_PROPERTY_HOST_COHERENT_BIT;
+    bool cached = flags & VK_MEMORY_PROPERTY_HOST_CACHED_BIT;
+
+    // Base score keeps every eligible type above -1.
+    int32_t score = 200;
+
+    // Device coherent or uncached AMD types bypass caches and are slow.
+    if (flags & (VK_MEMORY_PROPERTY_DEVICE_COHERENT_BIT_AMD
+                 | VK_MEMORY_PROPERTY_DEVICE_UNCACHED_BIT_AMD)) {
+        score -= 50;
+    }
+
+    switch (intent) {
+        case VKC_MEMORY_GPU_ONLY:
+            // Leave host visible device memory (BAR) to the host intents.
+            score += local ? 100 : 0;
+            score -= visible ? 20 : 0;
+            return score;
+        case VKC_MEMORY_UPLOAD:
+            if (!visible) {
+                return -1;
+            }
+            // Sequential writes favour write-combined system memory.
+            score += coherent ? 100 : 0;
+            score -= local ? 20 : 0;
+            score -= cached ? 10 : 0;
+            return score;
+        case VKC_MEMORY_READBACK:
+            if (!visible) {
+                return -1;
+            }
+            // Uncached reads are an order of magnitude slower; non-coherent
+            // ranges are handled with a VKC_MEMORY_INVALIDATE batch.
+            score += cached ? 100 : 0;
+            score += coherent ? 50 : 0;
+            score -= local ? 20 : 0;
+            return score;
+        case VKC_MEMORY_STREAMING:
+            if (!visible) {
+                return -1;
+            }
+            // Host visible device local memory (ReBAR or UMA) is read by the
+            // device at full speed and written by the host without a copy.
+            score += coherent ? 100 : 0;
+            score += local ? 50 : 0;
+            score -= cached ? 10 : 0;
+            return score;
+        default:
+            return -1;
+    }
+}
+
+/** @} */
+
+static inline VkDeviceSize vkc_memory_node_size(uint32_t order) {
+    return VKC_MEMORY_MIN_SIZE << order;
+}
+
+static inline size_t vkc_memory_node_count(const VkcMemoryBlock* block, uint32_t order) {
+    return (size_t) 1 << (block->orders - 1 - order);
+}
+
+/**
+ * @name Buddy Bitmaps
+ * @{
+ */
+
+static inline bool vkc_memory_bit_test(const VkcMemoryBlock* block, uint32_t order, size_t index) {
+    return block->bitmap[block->words[order] + index / 64] & (1ull << (index % 64));
+}
+
+static inline void vkc_memory_bit_set(VkcMemoryBlock* block, uint32_t order, size_t index) {
+    size_t word = index / 64;
+    block->bitmap[block->words[order] + word] |= 1ull << (index % 64);
+    block->free[order]++;
+    if (word < block->hint[order]) {
+        block->hint[order] = word;
+    }
+}
+
+static inline void vkc_memory_bit_clear(VkcMemoryBlock* block, uint32_t order, size_t index) {
+    block->bitmap[block->words[order] + index / 64] &= ~(1ull << (index % 64));
+    block->free[order]--;
+}
+
+static size_t vkc_memory_bit_pop(VkcMemoryBlock* block, uint32_t order) {
+    size_t words = (vkc_memory_node_count(block, order) + 63) / 64;
+    uint64_t* bitmap = block->bitmap + block->words[order];
+
+    // Every word below the hint is known to be empty.
+    for (size_t word = block->hint[order]; word < words; word++) {
+        if (bitmap[word]) {
+            size_t index = word * 64 + (size_t) __builtin_ctzll(bitmap[word]);
+            block->hint[order] = word;
+            vkc_memory_bit_clear(block, order, index);
+            return index;
+        }
+    }
+
+    return SIZE_MAX; // unreachable while free[order] is accurate
+}
+
+/** @} */
+
+/**
+ * @name Buddy Nodes
+ * @{
+ */
+
+static bool vkc_memory_node_take(VkcMemoryBlock* block, uint32_t order, VkDeviceSize* offset) {
+    uint32_t k = order;
+    while (k < block->orders && 0 == block->free[k]) {
+        k++;
+    }
+    if (k == block->orders) {
+        return false;
+    }
+
+    size_t index = vkc_memory_bit_pop(block, k);
+
+    // Split down to the requested order, keeping the right halves free.
+    while (k > order) {
+        k--;
+        index <<= 1;
+        vkc_memory_bit_set(block, k, index + 1);
+    }
+
+    *offset = (VkDeviceSize) index << (vkc_memory_log2(VKC_MEMORY_MIN_SIZE) + order);
+    block->used += vkc_memory_node_size(order);
+    return true;
+}
+
+static bool vkc_memory_node_available(const VkcMemoryBlock* block, uint32_t order) {
+    for (uint32_t k = order; k < block->orders; k++) {
+        if (block->free[k]) {
+            return true;
+        }
+    }
+    return false;
+}
+
+static void vkc_memory_node_give(VkcMemoryBlock* block, uint32_t order, VkDeviceSize offset) {
+    size_t index = (size_t) (offset >> (vkc_memory_log2(VKC_MEMORY_MIN_SIZE) + order));
+    block->used -= vkc_memory_node_size(order);
+
+    uint32_t k = order;
+    while (k + 1 < block->orders && vkc_memory_bit_test(block, k, index ^ 1)) {
+        vkc_memory_bit_clear(block, k, index ^ 1);
+        index >>= 1;
+        k++;
+    }
+
+    vkc_memory_bit_set(block, k, index);
+}
+
+/** @} */
+
+/**
+ * @name Blocks
+ * @{
+ */
+
+static VkDeviceSize vkc_memory_node_need(const VkMemoryRequirements* requirements) {
+    VkDeviceSize need = requirements->size;
+    if (need < requirements->alignment) {
+        need = requirements->alignment;
+    }
+    return vkc_memory_ceil2(need < VKC_MEMORY_MIN_SIZE ? VKC_MEMORY_MIN_SIZE : need);
+}
+
+static VkcMemoryResource vkc_memory_resource(
+    const VkcMemoryPool* pool, VkcMemoryResource resource
+) {
+    // Nodes never straddle a granularity page when the page is no larger than
+    // the smallest node, so both classes can share blocks.
+    return pool->granularity > VKC_MEMORY_MIN_SIZE ? resource : VKC_MEMORY_LINEAR;
+}
+
+static VkDeviceSize vkc_memory_block_size(const VkcMemoryPool* pool, uint32_t type) {
+    uint32_t heap = pool->properties.memoryTypes[type].heapIndex;
+    VkDeviceSize heap_size = pool->properties.memoryHeaps[heap].size;
+
+    VkDeviceSize size = VKC_MEMORY_BLOCK_SIZE;
+    if (heap_size <= VKC_MEMORY_SMALL_HEAP && heap_size / 8 < size) {
+        size = vkc_memory_floor2(heap_size / 8);
+    }
+
+    VkDeviceSize max_size = vkc_memory_node_size(VKC_MEMORY_ORDER_MAX - 1);
+    if (size > max_size) {
+        size = max_size;
+    }
+
+    return size < VKC_MEMORY_MIN_SIZE ? VKC_MEMORY_MIN_SIZE : size;
+}
+
+static void vkc_memory_block_link(VkcMemoryBlock** head, VkcMemoryBlock* block) {
+    block->prev = NULL;
+    block->next = *head;
+    if (*head) {
+        (*head)->prev = block;
+    }
+    *head = block;
+}
+
+static void vkc_memory_block_unlink(VkcMemoryBlock** head, VkcMemoryBlock* block) {
+    if (block->prev) {
+        block->prev->next = block->next;
+    } else {
+        *head = block->next;
+    }
+    if (block->next) {
+        block->next->prev = block->prev;
+    }
+    block->next = block->prev = NULL;
+}
+
+static bool vkc_memory_block_spare(const VkcMemoryBlock* head, const VkcMemoryBlock* block) {
+    for (const VkcMemoryBlock* other = head; other; other = other->next) {
+        if (other != block && !other->dedicated) {
+            return true;
+        }
+    }
+    return false;
+}
+
+// Caller holds the pool mutex.
+static void vkc_memory_budget_refresh(VkcMemoryPool* pool) {
+    uint32_t heaps = pool->properties.memoryHeapCount;
+
+    VkPhysicalDeviceMemoryBudgetPropertiesEXT driver = {
+        .sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_MEMORY_BUDGET_PROPERTIES_EXT,
+    };
+
+    if (pool->flags & VKC_MEMORY_POOL_BUDGET_BIT) {
+        VkPhysicalDeviceMemoryProperties2 properties = {
+            .sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_MEMORY_PROPERTIES_2,
+            .pNext = &driver,
+        };
+        vkGetPhysicalDeviceMemoryProperties2(pool->physical, &properties);
+    }
+
+    for (uint32_t heap = 0; heap < heaps; heap++) {
+        VkcMemoryBudget* budget = &pool->budgets[heap];
+        if (0 != driver.heapBudget[heap]) {
+            budget->budget = driver.heapBudget[heap];
+            budget->usage = driver.heapUsage[heap];
+        } else {
+            budget->budget = budget->size / 100 * VKC_MEMORY_BUDGET_PERCENT;
+            budget->usage = budget->pool_usage;
+        }
+    }
+}
+
+static VkcMemoryBlock* vkc_memory_block_create(
+    VkcMemoryPool* pool,
+    VkDeviceSize size,
+    uint32_t type,
+    VkcMemoryResource resource,
+    bool dedicated
+) {
+    if (pool->allocation_count >= pool->allocation_limit) {
+        LOG_ERROR(
+            "[VkcMemoryPool] maxMemoryAllocationCount (%u) reached.", pool->allocation_limit
+        );
+        return NULL;
+    }
+
+    uint32_t heap = pool->properties.memoryTypes[type].heapIndex;
+    VkcMemoryBudget* budget = &pool->budgets[heap];
+
+    vkc_memory_budget_refresh(pool);
+    if (budget->usage + size > budget->budget) {
+        LOG_ERROR(
+            "[VkcMemoryPool] Heap %u over budget: %llu bytes requested, %llu of %llu in use.",
+            heap,
+            (unsigned long long) size,
+            (unsigned long long) budget->usage,
+            (unsigned long long) budget->budget
+        );
+        return NULL;
+    }
+
+    VkcMemoryBlock* block = page_malloc(pool->pager, sizeof(*block), alignof(*block));
+    if (!block) {
+        LOG_ERROR("[VkcMemoryPool] Failed to allocate block structure.");
+        return NULL;
+    }
+
+    *block = (VkcMemoryBlock) {
+        .size = size,
+        .type = type,
+        .resource = resource,
+        .dedicated = dedicated,
+    };
+
+    if (!dedicated) {
+        block->orders = vkc_memory_log2(size / VKC_MEMORY_MIN_SIZE) + 1;
+
+        size_t words = 0;
+        for (uint32_t k = 0; k < block->orders; k++) {
+            block->words[k] = words;
+            words += (vkc_memory_node_count(block, k) + 63) / 64;
+        }
+
+        block->bitmap = page_malloc(pool->pager, words * sizeof(uint64_t), alignof(uint64_t));
+        if (!block->bitmap) {
+            LOG_ERROR("[VkcMemoryPool] Failed to allocate %zu bitmap words.", words);
+            page_free(pool->pager, block);
+            return NULL;
+        }
+        memset(block->bitmap, 0, words * sizeof(uint64_t));
+
+        // The whole block starts out as a single free node of the top order.
+        vkc_memory_bit_set(block, block->orders - 1, 0);
+    }
+
+    VkMemoryAllocateInfo info = {
+        .sType = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO,
+        .allocationSize = size,
+        .memoryTypeIndex = type,
+    };
+
+    VkResult result = vkAllocateMemory(pool->device, &info, pool->callbacks, &block->memory);
+    if (VK_SUCCESS != result) {
+        LOG_ERROR(
+            "[VkcMemoryPool] Failed to allocate %llu bytes of type %u (VkResult=%d).",
+            (unsigned long long) size,
+            type,
+            result
+        );
+        if (block->bitmap) {
+            page_free(pool->pager, block->bitmap);
+        }
+        page_free(pool->pager, block);
+        return NULL;
+    }
+
+    pool->allocation_count++;
+    budget->pool_usage += size;
+    budget->usage += size; // Until the next refresh.
+
+#if defined(VKC_DEBUG) && (1 == VKC_DEBUG)
+    LOG_DEBUG(
+        "[VkcMemoryPool] Allocated %s block: type=%u, size=%llu, count=%u, heap=%u (%llu/%llu)",
+        dedicated ? "dedicated" : "shared",
+        type,
+        (unsigned long long) size,
+        pool->allocation_count,
+        heap,
+        (unsigned long long) budget->usage,
+        (unsigned long long) budget->budget
+    );
+#endif
+
+    return block;
+}
+
+static void vkc_memory_block_free(VkcMemoryPool* pool, VkcMemoryBlock* block) {
+    // Imported memory is never mapped through Vulkan; the pointer is the host's.
+    if (block->mapped && !block->imported) {
+        vkUnmapMemory(pool->device, block->memory);
+    }
+    vkFreeMemory(pool->device, block->memory, pool->callbacks);
+    pool->allocation_count--;
+    pool->budgets[pool->properties.memoryTypes[block->type].heapIndex].pool_usage -= block->size;
+
+    if (block->bitmap) {
+        page_free(pool->pager, block->bitmap);
+    }
+    page_free(pool->pager, block);
+}
+
+/** @} */
+
+/**
+ * @name Mapped Ranges
+ * @{
+ */
+
+static bool vkc_memory_batch_merge(VkcMemoryBatch* batch, const VkMappedMemoryRange* range) {
+    if (0 == batch->count) {
+        return false;
+    }
+
+    VkMappedMemoryRange* last = &batch->ranges[batch->count - 1];
+    if (last->memory != range->memory || VK_WHOLE_SIZE == last->size) {
+        return false;
+    }
+
+    VkDeviceSize end = last->offset + last->size;
+    if (range->offset < last->offset || range->offset > end) {
+        return false;
+    }
+
+    if (VK_WHOLE_SIZE == range->size) {
+        last->size = VK_WHOLE_SIZE;
+    } else if (range->offset + range->size > end) {
+        last->size = range->offset + range->size - last->offset;
+    }
+
+    return true;
+}
+
+/** @} */
+
+/** @} */
+
+/**
+ * @name Public
+ * {@
+ */
+
+VkcMemoryPool* vkc_memory_pool_create(
+    PageAllocator* pager,
+    VkPhysicalDevice physical,
+    VkDevice device,
+    const VkAllocationCallbacks* callbacks,
+    VkcMemoryPoolFlags flags
+) {
+    if (!pager) {
+        LOG_ERROR("[VkcMemoryPool] Missing allocation context (PageAllocator).");
+        return NULL;
+    }
+
+    if (VK_NULL_HANDLE == physical || VK_NULL_HANDLE == device) {
+        LOG_ERROR("[VkcMemoryPool] Invalid device handles.");
+        return NULL;
+    }
+
+    VkcMemoryPool* pool = page_malloc(pager, sizeof(*pool), alignof(*pool));
+    if (!pool) {
+        LOG_ERROR("[VkcMemoryPool] Failed to allocate pool structure.");
+        return NULL;
+    }
+
+    VkPhysicalDeviceProperties properties = {0};
+    vkGetPhysicalDeviceProperties(physical, &properties);
+
+    *pool = (VkcMemoryPool) {
+        .pager = pager,
+        .physical = physical,
+        .device = device,
+        .callbacks = callbacks,
+        .granularity = properties.limits.bufferImageGranularity,
+        .atom = properties.limits.nonCoherentAtomSize,
+        .allocation_count = 0,
+        .allocation_limit = properties.limits.maxMemoryAllocationCount,
+        .flags = flags,
+    };
+
+    if (0 == pool->allocation_limit) {
+        pool->allocation_limit = UINT32_MAX;
+    }
+
+    if (0 == pool->atom) {
+        pool->atom = 1;
+    }
+
+    vkGetPhysicalDeviceMemoryProperties(physical, &pool->properties);
+
+    if (flags & VKC_MEMORY_POOL_HOST_IMPORT_BIT) {
+        VkPhysicalDeviceExternalMemoryHostPropertiesEXT host = {
+            .sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_EXTERNAL_MEMORY_HOST_PROPERTIES_EXT,
+        };
+        VkPhysicalDeviceProperties2 properties2 = {
+            .sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_PROPERTIES_2,
+            .pNext = &host,
+        };
+        vkGetPhysicalDeviceProperties2(physical, &properties2);
+
+        pool->import_alignment = host.minImportedHostPointerAlignment;
+        pool->host_pointer_properties = (PFN_vkGetMemoryHostPointerPropertiesEXT)
+            vkGetDeviceProcAddr(device, "vkGetMemoryHostPointerPropertiesEXT");
+
+        if (0 == pool->import_alignment || !pool->host_pointer_properties) {
+            LOG_WARN("[VkcMemoryPool] Host pointer import unavailable; disabling it.");
+            pool->flags &= ~VKC_MEMORY_POOL_HOST_IMPORT_BIT;
+            pool->import_alignment = 0;
+            pool->host_pointer_properties = NULL;
+        }
+    }
+
+    for (uint32_t heap = 0; heap < pool->properties.memoryHeapCount; heap++) {
+        pool->budgets[heap].size = pool->properties.memoryHeaps[heap].size;
+    }
+    vkc_memory_budget_refresh(pool);
+
+    if (0 != pthread_mutex_init(&pool->mutex, NULL)) {
+        LOG_ERROR("[VkcMemoryPool] Failed to initialize pool mutex.");
+        page_free(pager, pool);
+        return NULL;
+    }
+
+    return pool;
+}
+
+void vkc_memory_pool_free(VkcMemoryPool* pool) {
+    if (!pool) {
+        return;
+    }
+
+    for (uint32_t type = 0; type < VK_MAX_MEMORY_TYPES; type++) {
+        for (uint32_t resource = 0; resource < VKC_MEMORY_RESOURCE_COUNT; resource++) {
+            VkcMemoryBlock* block = pool->blocks[type][resource];
+            while (block) {
+                VkcMemoryBlock* next = block->next;
+#if defined(VKC_DEBUG) && (1 == VKC_DEBUG)
+                if (block->used) {
+                    LOG_DEBUG(
+                        "[VkcMemoryPool] Releasing block with %llu live bytes (type=%u).",
+                        (unsigned long long) block->used,
+                        type
+                    );
+                }
+#endif
+                vkc_memory_block_free(pool, block);
+                block = next;
+            }
+        }
+    }
+
+    pthread_mutex_destroy(&pool->mutex);
+    page_free(pool->pager, pool);
+}
+
+uint32_t vkc_memory_type_find(
+    const VkcMemoryPool* pool, uint32_t type_bits, VkMemoryPropertyFlags required
+) {
+    if (!pool) {
+        return VKC_MEMORY_TYPE_NONE;
+    }
+
+    for (uint32_t i = 0; i < pool->properties.memoryTypeCount; i++) {
+        VkMemoryPropertyFlags flags = pool->properties.memoryTypes[i].propertyFlags;
+        if ((type_bits & (1u << i)) && (flags & required) == required) {
+            return i;
+        }
+    }
+
+    return VKC_MEMORY_TYPE_NONE;
+}
+
+uint32_t vkc_memory_type_select(
+    const VkcMemoryPool* pool, uint32_t type_bits, VkcMemoryIntent intent
+) {
+    if (!pool || intent >= VKC_MEMORY_INTENT_COUNT) {
+        return VKC_MEMORY_TYPE_NONE;
+    }
+
+    uint32_t best = VKC_MEMORY_TYPE_NONE;
+    int32_t best_score = -1;
+    for (uint32_t i = 0; i < pool->properties.memoryTypeCount; i++) {
+        if (!(type_bits & (1u << i))) {
+            continue;
+        }
+
+        int32_t score = vkc_memory_score(pool->properties.memoryTypes[i].propertyFlags, intent);
+        if (score > best_score) {
+            best = i;
+            best_score = score;
+        }
+    }
+
+#if defined(VKC_DEBUG) && (1 == VKC_DEBUG)
+    if (VKC_MEMORY_TYPE_NONE == best) {
+        LOG_DEBUG("[VkcMemoryPool] No memory type for intent %d (bits=0x%x).", intent, type_bits);
+    }
+#endif
+
+    return best;
+}
+
+uint32_t vkc_memory_heap_types(const VkcMemoryPool* pool, uint32_t type) {
+    if (!pool || type >= pool->properties.memoryTypeCount) {
+        return 0;
+    }
+
+    uint32_t heap = pool->properties.memoryTypes[type].heapIndex;
+    uint32_t bits = 0;
+    for (uint32_t i = 0; i < pool->properties.memoryTypeCount; i++) {
+        if (heap == pool->properties.memoryTypes[i].heapIndex) {
+            bits |= 1u << i;
+        }
+    }
+
+    return bits;
+}
+
+uint32_t vkc_memory_budget_query(VkcMemoryPool* pool, VkcMemoryBudget* budgets) {
+    if (!pool || !budgets) {
+        return 0;
+    }
+
+    pthread_mutex_lock(&pool->mutex);
+
+    vkc_memory_budget_refresh(pool);
+
+    uint32_t heaps = pool->properties.memoryHeapCount;
+    memcpy(budgets, pool->budgets, heaps * sizeof(*budgets));
+
+    pthread_mutex_unlock(&pool->mutex);
+
+    return heaps;
+}
+
+bool vkc_memory_malloc(
+    VkcMemoryPool* pool,
+    const VkMemoryRequirements* requirements,
+    uint32_t type,
+    VkcMemoryResource resource,
+    VkcMemoryAllocation* allocation
+) {
+    if (!pool || !requirements || !allocation || resource >= VKC_MEMORY_RESOURCE_COUNT) {
+        LOG_ERROR("[VkcMemoryPool] Invalid allocation arguments.");
+        return false;
+    }
+
+    if (type >= pool->properties.memoryTypeCount
+        || !(requirements->memoryTypeBits & (1u << type))) {
+        LOG_ERROR("[VkcMemoryPool] Memory type %u is not allowed for this resource.", type);
+        return false;
+    }
+
+    if (0 == requirements->size) {
+        LOG_ERROR("[VkcMemoryPool] Zero-sized allocation.");
+        return false;
+    }
+
+    VkDeviceSize need = vkc_memory_node_need(requirements);
+
+    resource = vkc_memory_resource(pool, resource);
+    VkcMemoryBlock** head = &pool->blocks[type][resource];
+
+    pthread_mutex_lock(&pool->mutex);
+
+    VkDeviceSize block_size = vkc_memory_block_size(pool, type);
+    if (need > block_size) {
+        // Oversized requests get their own memory object. It starts at offset
+        // zero, so any alignment the implementation reports is satisfied.
+        VkcMemoryBlock* block = vkc_memory_block_create(
+            pool, requirements->size, type, resource, true
+        );
+        if (!block) {
+            pthread_mutex_unlock(&pool->mutex);
+            return false;
+        }
+
+        block->used = requirements->size;
+        vkc_memory_block_link(head, block);
+        pthread_mutex_unlock(&pool->mutex);
+
+        *allocation = (VkcMemoryAllocation) {
+            .memory = block->memory,
+            .offset = 0,
+            .size = requirements->size,
+            .block = block,
+            .order = 0,
+            .type = type,
+            .flags = pool->properties.memoryTypes[type].propertyFlags,
+        };
+        return true;
+    }
+
+    uint32_t order = vkc_memory_log2(need / VKC_MEMORY_MIN_SIZE);
+    VkDeviceSize offset = 0;
+
+    VkcMemoryBlock* block = *head;
+    while (block) {
+        if (!block->dedicated && order < block->orders
+            && vkc_memory_node_take(block, order, &offset)) {
+            break;
+        }
+        block = block->next;
+    }
+
+    if (!block) {
+        block = vkc_memory_block_create(pool, block_size, type, resource, false);
+        if (!block) {
+            pthread_mutex_unlock(&pool->mutex);
+            return false;
+        }
+
+        vkc_memory_node_take(block, order, &offset);
+        vkc_memory_block_link(head, block);
+    }
+
+    pthread_mutex_unlock(&pool->mutex);
+
+    *allocation = (VkcMemoryAllocation) {
+        .memory = block->memory,
+        .offset = offset,
+        .size = requirements->size,
+        .block = block,
+        .order = order,
+        .type = type,
+        .flags = pool->properties.memoryTypes[type].propertyFlags,
+    };
+    return true;
+}
+
+bool vkc_memory_relocate(
+    VkcMemoryPool* pool,
+    const VkcMemoryAllocation* source,
+    const VkMemoryRequirements* requirements,
+    VkcMemoryAllocation* allocation
+) {
+    if (!pool || !source || !source->block || !requirements || !allocation) {
+        LOG_ERROR("[VkcMemoryPool] Invalid relocation arguments.");
+        return false;
+    }
+
+    VkcMemoryBlock* from = source->block;
+    if (from->dedicated || !(requirements->memoryTypeBits & (1u << from->type))) {
+        return false;
+    }
+
+    VkDeviceSize need = vkc_memory_node_need(requirements);
+    if (need > vkc_memory_node_size(from->orders - 1)) {
+        return false;
+    }
+
+    uint32_t order = vkc_memory_log2(need / VKC_MEMORY_MIN_SIZE);
+    VkDeviceSize offset = 0;
+
+    pthread_mutex_lock(&pool->mutex);
+
+    // Pack into the fullest block that is strictly denser than the source;
+    // address order breaks ties so two equal blocks never trade places.
+    VkcMemoryBlock* best = NULL;
+    for (VkcMemoryBlock* block = pool->blocks[from->type][from->resource]; block;
+         block = block->next) {
+        if (block == from || block->dedicated || order >= block->orders
+            || !vkc_memory_node_available(block, order)) {
+            continue;
+        }
+
+        bool denser = block->used > from->used
+                      || (block->used == from->used && (uintptr_t) block < (uintptr_t) from);
+        if (denser && (!best || block->used > best->used)) {
+            best = block;
+        }
+    }
+
+    if (best) {
+        vkc_memory_node_take(best, order, &offset);
+    }
+
+    pthread_mutex_unlock(&pool->mutex);
+
+    if (!best) {
+        return false;
+    }
+
+    *allocation = (VkcMemoryAllocation) {
+        .memory = best->memory,
+        .offset = offset,
+        .size = requirements->size,
+        .block = best,
+        .order = order,
+        .type = from->type,
+        .flags = pool->properties.memoryTypes[from->type].propertyFlags,
+    };
+    return true;
+}
+
+bool vkc_memory_import(
+    VkcMemoryPool* pool,
+    void* host,
+    VkDeviceSize size,
+    const VkMemoryRequirements* requirements,
+    VkcMemoryIntent intent,
+    VkcMemoryAllocation* allocation
+) {
+    if (!pool || !host || 0 == size || !requirements || !allocation) {
+        LOG_ERROR("[VkcMemoryPool] Invalid import arguments.");
+        return false;
+    }
+
+    // Everything below is an expected miss that the caller handles with a copy.
+    if (!(pool->flags & VKC_MEMORY_POOL_HOST_IMPORT_BIT)
+        || 0 != (uintptr_t) host % pool->import_alignment || 0 != size % pool->import_alignment
+        || requirements->size > size) {
+        return false;
+    }
+
+    VkMemoryHostPointerPropertiesEXT properties = {
+        .sType = VK_STRUCTURE_TYPE_MEMORY_HOST_POINTER_PROPERTIES_EXT,
+    };
+    VkResult result = pool->host_pointer_properties(
+        pool->device, VK_EXTERNAL_MEMORY_HANDLE_TYPE_HOST_ALLOCATION_BIT_EXT, host, &properties
+    );
+    if (VK_SUCCESS != result) {
+        return false;
+    }
+
+    uint32_t type = vkc_memory_type_select(
+        pool, requirements->memoryTypeBits & properties.memoryTypeBits, intent
+    );
+    if (VKC_MEMORY_TYPE_NONE == type) {
+        return false;
+    }
+
+    VkcMemoryBlock* block = page_malloc(pool->pager, sizeof(*block), alignof(*block));
+    if (!block) {
+        LOG_ERROR("[VkcMemoryPool] Failed to allocate block structure.");
+        return false;
+    }
+
+    *block = (VkcMemoryBlock) {
+        .size = size,
+        .used = size,
+        .mapped = host,
+        .type = type,
+        .resource = VKC_MEMORY_LINEAR,
+        .dedicated = true,
+        .imported = true,
+    };
+
+    VkImportMemoryHostPointerInfoEXT import = {
+        .sType = VK_STRUCTURE_TYPE_IMPORT_MEMORY_HOST_POINTER_INFO_EXT,
+        .handleType = VK_EXTERNAL_MEMORY_HANDLE_TYPE_HOST_ALLOCATION_BIT_EXT,
+        .pHostPointer = host,
+    };
+    VkMemoryAllocateInfo info = {
+        .sType = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO,
+        .pNext = &import,
+        .allocationSize = size,
+        .memoryTypeIndex = type,
+    };
+
+    pthread_mutex_lock(&pool->mutex);
+
+    if (pool->allocation_count >= pool->allocation_limit) {
+        pthread_mutex_unlock(&pool->mutex);
+        page_free(pool->pager, block);
+        return false;
+    }
+
+    result = vkAllocateMemory(pool->device, &info, pool->callbacks, &block->memory);
+    if (VK_SUCCESS != result) {
+        pthread_mutex_unlock(&pool->mutex);
+        LOG_WARN("[VkcMemoryPool] Failed to import host pointer (VkResult=%d).", result);
+        page_free(pool->pager, block);
+        return false;
+    }
+
+    // The pages already exist, so the import is accounted but never refused.
+    pool->allocation_count++;
+    pool->budgets[pool->properties.memoryTypes[type].heapIndex].pool_usage += size;
+    vkc_memory_block_link(&pool->blocks[type][VKC_MEMORY_LINEAR], block);
+
+    pthread_mutex_unlock(&pool->mutex);
+
+    *allocation = (VkcMemoryAllocation) {
+        .memory = block->memory,
+        .offset = 0,
+        .size = requirements->size,
+        .block = block,
+        .mapped = host,
+        .order = 0,
+        .type = type,
+        .flags = pool->properties.memoryTypes[type].propertyFlags,
+    };
+    return true;
+}
+
+void vkc_memory_free(VkcMemoryPool* pool, VkcMemoryAllocation* allocation) {
+    if (!pool || !allocation || !allocation->block) {
+        return;
+    }
+
+    VkcMemoryBlock* block = allocation->block;
+    VkcMemoryBlock** head = &pool->blocks[block->type][block->resource];
+
+    pthread_mutex_lock(&pool->mutex);
+
+    if (block->dedicated) {
+        block->used = 0;
+    } else {
+        vkc_memory_node_give(block, allocation->order, allocation->offset);
+    }
+
+    // Keep the last shared block of a list so a create/destroy loop does not
+    // turn every buffer back into a vkAllocateMemory call.
+    if (0 == block->used && (block->dedicated || vkc_memory_block_spare(*head, block))) {
+        vkc_memory_block_unlink(head, block);
+        vkc_memory_block_free(pool, block);
+    }
+
+    pthread_mutex_unlock(&pool->mutex);
+
+    *allocation = (VkcMemoryAllocation) {0};
+}
+
+void* vkc_memory_map(VkcMemoryPool* pool, VkcMemoryAllocation* allocation) {
+    if (!pool || !allocation || !allocation->block) {
+        LOG_ERROR("[VkcMemoryPool] Invalid map arguments.");
+        return NULL;
+    }
+
+    if (allocation->mapped) {
+        return allocation->mapped;
+    }
+
+    if (!(allocation->flags & VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT)) {
+        LOG_ERROR("[VkcMemoryPool] Memory type %u is not host visible.", allocation->type);
+        return NULL;
+    }
+
+    VkcMemoryBlock* block = allocation->block;
+
+    // A VkDeviceMemory may only be mapped once, so the whole block is mapped
+    // and shared by every allocation carved from it.
+    pthread_mutex_lock(&pool->mutex);
+    if (!block->mapped) {
+        VkResult result = vkMapMemory(
+            pool->device, block->memory, 0, VK_WHOLE_SIZE, 0, &block->mapped
+        );
+        if (VK_SUCCESS != result) {
+            LOG_ERROR("[VkcMemoryPool] Failed to map block (VkResult=%d).", result);
+            block->mapped = NULL;
+            pthread_mutex_unlock(&pool->mutex);
+            return NULL;
+        }
+    }
+    pthread_mutex_unlock(&pool->mutex);
+
+    allocation->mapped = (unsigned char*) block->mapped + allocation->offset;
+    return allocation->mapped;
+}
+
+bool vkc_memory_batch_add(
+    VkcMemoryPool* pool,
+    VkcMemoryBatch* batch,
+    const VkcMemoryAllocation* allocation,
+    VkDeviceSize offset,
+    VkDeviceSize size
+) {
+    if (!pool || !batch || !allocation || !allocation->block) {
+        LOG_ERROR("[VkcMemoryPool] Invalid batch arguments.");
+        return false;
+    }
+
+    if (allocation->flags & VK_MEMORY_PROPERTY_HOST_COHERENT_BIT) {
+        return true;
+    }
+
+    if (VK_WHOLE_SIZE == size || offset + size > allocation->size) {
+        size = offset < allocation->size ? allocation->size - offset : 0;
+    }
+    if (0 == size) {
+        return true;
+    }
+
+    VkDeviceSize start = allocation->offset + offset;
+    VkDeviceSize end = start + size;
+    start -= start % pool->atom;
+    end = (end + pool->atom - 1) / pool->atom * pool->atom;
+
+    VkMappedMemoryRange range = {
+        .sType = VK_STRUCTURE_TYPE_MAPPED_MEMORY_RANGE,
+        .memory = allocation->memory,
+        .offset = start,
+        // Only a dedicated block can end off the atom grid.
+        .size = end > allocation->block->size ? VK_WHOLE_SIZE : end - start,
+    };
+
+    if (vkc_memory_batch_merge(batch, &range)) {
+        return true;
+    }
+
+    if (VKC_MEMORY_BATCH_SIZE == batch->count && !vkc_memory_batch_submit(pool, batch)) {
+        return false;
+    }
+
+    batch->ranges[batch->count++] = range;
+    return true;
+}
+
+bool vkc_memory_batch_submit(VkcMemoryPool* pool, VkcMemoryBatch* batch) {
+    if (!pool || !batch) {
+        return false;
+    }
+
+    if (0 == batch->count) {
+        return true;
+    }
+
+    VkResult result;
+    if (VKC_MEMORY_FLUSH == batch->op) {
+        result = vkFlushMappedMemoryRanges(pool->device, batch->count, batch->ranges);
+    } else {
+        result = vkInvalidateMappedMemoryRanges(pool->device, batch->count, batch->ranges);
+    }
+
+    uint32_t count = batch->count;
+    batch->count = 0;
+
+    if (VK_SUCCESS != result) {
+        LOG_ERROR(
+            "[VkcMemoryPool] Failed to %s %u ranges (VkResult=%d).",
+            VKC_MEMORY_FLUSH == batch->op ? "flush" : "invalidate",
+            count,
+            result
+        );
+        return false;
+    }
+
+    return true;
+}
+
+/** @} */
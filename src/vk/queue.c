@@ -0,0 +1,258 @@
+/**
+ * @file src/vk/queue.c
+ * @brief Ticketed submission on a timeline semaphore.
+ */
+
+#include "core/posix.h"
+#include "core/memory.h"
+#include "core/logger.h"
+#include "allocator/page.h"
+#include "vk/sync.h"
+#include "vk/queue.h"
+
+/**
+ * @section Private
+ * {@
+ */
+
+static void vkc_queue_observe(VkcQueue* queue, uint64_t value) {
+    pthread_mutex_lock(&queue->mutex);
+    if (value > queue->completed) {
+        queue->completed = value;
+    }
+    pthread_mutex_unlock(&queue->mutex);
+}
+
+/** @} */
+
+/**
+ * @name Public
+ * {@
+ */
+
+VkcQueue* vkc_queue_create(
+    PageAllocator* pager,
+    VkDevice device,
+    VkQueue queue,
+    uint32_t family,
+    const VkAllocationCallbacks* callbacks
+) {
+    if (!pager || VK_NULL_HANDLE == device || VK_NULL_HANDLE == queue) {
+        LOG_ERROR("[VkcQueue] Invalid queue arguments.");
+        return NULL;
+    }
+
+    VkcQueue* self = page_malloc(pager, sizeof(*self), alignof(*self));
+    if (!self) {
+        LOG_ERROR("[VkcQueue] Failed to allocate queue structure.");
+        return NULL;
+    }
+
+    *self = (VkcQueue) {
+        .pager = pager,
+        .device = device,
+        .callbacks = callbacks,
+        .queue = queue,
+        .family = family,
+        .timeline = VK_NULL_HANDLE,
+    };
+
+    VkSemaphoreTypeCreateInfo type_info = {
+        .sType = VK_STRUCTURE_TYPE_SEMAPHORE_TYPE_CREATE_INFO,
+        .semaphoreType = VK_SEMAPHORE_TYPE_TIMELINE,
+        .initialValue = 0,
+    };
+    VkSemaphoreCreateInfo info = {
+        .sType = VK_STRUCTURE_TYPE_SEMAPHORE_CREATE_INFO,
+        .pNext = &type_info,
+    };
+
+    VkResult result = vkCreateSemaphore(device, &info, callbacks, &self->timeline);
+    if (VK_SUCCESS != result) {
+        LOG_ERROR("[VkcQueue] Failed to create timeline semaphore (VkResult=%d).", result);
+        page_free(pager, self);
+        return NULL;
+    }
+
+    if (0 != pthread_mutex_init(&self->mutex, NULL)) {
+        LOG_ERROR("[VkcQueue] Failed to initialize queue mutex.");
+        vkDestroySemaphore(device, self->timeline, callbacks);
+        page_free(pager, self);
+        return NULL;
+    }
+
+    return self;
+}
+
+void vkc_queue_free(VkcQueue* queue) {
+    if (!queue) {
+        return;
+    }
+
+    // The semaphore may not be destroyed while a submission still signals it.
+    vkc_queue_wait(queue, queue->submitted, UINT64_MAX);
+
+#if defined(VKC_DEBUG) && (1 == VKC_DEBUG)
+    LOG_DEBUG("[VkcQueue] Retired %llu submissions.", (unsigned long long) queue->submitted);
+#endif
+
+    vkDestroySemaphore(queue->device, queue->timeline, queue->callbacks);
+    pthread_mutex_destroy(&queue->mutex);
+    page_free(queue->pager, queue);
+}
+
+uint64_t vkc_queue_submit(VkcQueue* queue, const VkcQueueSubmit* submit) {
+    if (!queue || !submit || (submit->command_count && !submit->commands)
+        || (submit->wait_count && !submit->waits) || submit->wait_count > VKC_QUEUE_WAITS_MAX) {
+        LOG_ERROR("[VkcQueue] Invalid submit arguments.");
+        return 0;
+    }
+
+    VkSemaphore wait_semaphores[VKC_QUEUE_WAITS_MAX];
+    uint64_t wait_values[VKC_QUEUE_WAITS_MAX];
+    VkPipelineStageFlags wait_stages[VKC_QUEUE_WAITS_MAX];
+    uint32_t wait_count = 0;
+
+    for (uint32_t i = 0; i < submit->wait_count; i++) {
+        const VkcSyncPoint* point = &submit->waits[i];
+        if (VK_NULL_HANDLE == point->semaphore) {
+            if (VK_NULL_HANDLE != point->fence) {
+                LOG_ERROR("[VkcQueue] The device cannot wait on a fence.");
+                return 0;
+            }
+            continue;
+        }
+
+        wait_semaphores[wait_count] = point->semaphore;
+        wait_values[wait_count] = point->value;
+        wait_stages[wait_count] = submit->wait_stage ? submit->wait_stage
+                                                     : VK_PIPELINE_STAGE_ALL_COMMANDS_BIT;
+        wait_count++;
+    }
+
+    pthread_mutex_lock(&queue->mutex);
+
+    // Values are taken and signaled under one lock, so the timeline only ever
+    // sees them in increasing order.
+    uint64_t ticket = queue->submitted + 1;
+
+    if (submit->prepare && !submit->prepare(vkc_queue_point(queue, ticket), submit->user)) {
+        pthread_mutex_unlock(&queue->mutex);
+        LOG_ERROR("[VkcQueue] Submission %llu aborted by prepare.", (unsigned long long) ticket);
+        return 0;
+    }
+
+    VkTimelineSemaphoreSubmitInfo timeline_info = {
+        .sType = VK_STRUCTURE_TYPE_TIMELINE_SEMAPHORE_SUBMIT_INFO,
+        .waitSemaphoreValueCount = wait_count,
+        .pWaitSemaphoreValues = wait_values,
+        .signalSemaphoreValueCount = 1,
+        .pSignalSemaphoreValues = &ticket,
+    };
+    VkSubmitInfo info = {
+        .sType = VK_STRUCTURE_TYPE_SUBMIT_INFO,
+        .pNext = &timeline_info,
+        .waitSemaphoreCount = wait_count,
+        .pWaitSemaphores = wait_semaphores,
+        .pWaitDstStageMask = wait_stages,
+        .commandBufferCount = submit->command_count,
+        .pCommandBuffers = submit->commands,
+        .signalSemaphoreCount = 1,
+        .pSignalSemaphores = &queue->timeline,
+    };
+
+    VkResult result = vkQueueSubmit(queue->queue, 1, &info, VK_NULL_HANDLE);
+    if (VK_SUCCESS != result) {
+        pthread_mutex_unlock(&queue->mutex);
+        LOG_ERROR("[VkcQueue] Failed to submit (VkResult=%d).", result);
+        return 0;
+    }
+
+    queue->submitted = ticket;
+    pthread_mutex_unlock(&queue->mutex);
+
+    return ticket;
+}
+
+VkcSyncPoint vkc_queue_point(const VkcQueue* queue, uint64_t ticket) {
+    if (!queue || 0 == ticket) {
+        return (VkcSyncPoint) {0};
+    }
+
+    return vkc_sync_timeline(queue->timeline, ticket);
+}
+
+uint64_t vkc_queue_completed(VkcQueue* queue) {
+    if (!queue) {
+        return 0;
+    }
+
+    uint64_t value = 0;
+    VkResult result = vkGetSemaphoreCounterValue(queue->device, queue->timeline, &value);
+    if (VK_SUCCESS != result) {
+        LOG_ERROR("[VkcQueue] Failed to read timeline value (VkResult=%d).", result);
+        return 0;
+    }
+
+    vkc_queue_observe(queue, value);
+    return value;
+}
+
+uint64_t vkc_queue_pending(VkcQueue* queue) {
+    if (!queue) {
+        return 0;
+    }
+
+    uint64_t completed = vkc_queue_completed(queue);
+
+    pthread_mutex_lock(&queue->mutex);
+    if (completed < queue->completed) {
+        completed = queue->completed;
+    }
+    uint64_t pending = queue->submitted - completed;
+    pthread_mutex_unlock(&queue->mutex);
+
+    return pending;
+}
+
+bool vkc_queue_poll(VkcQueue* queue, uint64_t ticket) {
+    if (!queue) {
+        return false;
+    }
+
+    pthread_mutex_lock(&queue->mutex);
+    bool done = ticket <= queue->completed;
+    pthread_mutex_unlock(&queue->mutex);
+
+    return done || ticket <= vkc_queue_completed(queue);
+}
+
+bool vkc_queue_wait(VkcQueue* queue, uint64_t ticket, uint64_t timeout) {
+    if (!queue) {
+        return false;
+    }
+
+    pthread_mutex_lock(&queue->mutex);
+    bool done = ticket <= queue->completed;
+    bool issued = ticket <= queue->submitted;
+    pthread_mutex_unlock(&queue->mutex);
+
+    if (done) {
+        return true;
+    }
+
+    if (!issued) {
+        LOG_ERROR("[VkcQueue] Ticket %llu was never issued.", (unsigned long long) ticket);
+        return false;
+    }
+
+    VkcSyncPoint point = vkc_queue_point(queue, ticket);
+    if (!vkc_sync_point_wait(queue->device, &point, timeout)) {
+        return false;
+    }
+
+    vkc_queue_observe(queue, ticket);
+    return true;
+}
+
+/** @} */
@@ -0,0 +1,266 @@
+/**
+ * @file src/vk/readback.c
+ * @brief Asynchronous readback of device results into host memory.
+ */
+
+#include "core/posix.h"
+#include "core/memory.h"
+#include "core/logger.h"
+#include "allocator/page.h"
+#include "vk/sync.h"
+#include "vk/buffer.h"
+#include "vk/readback.h"
+
+/**
+ * @section Private
+ * {@
+ */
+
+static VkcReadbackSlot* vkc_readback_slot(VkcReadback* readback, VkcReadbackTicket ticket) {
+    if (!readback || ticket.slot >= readback->count) {
+        return NULL;
+    }
+
+    VkcReadbackSlot* slot = &readback->slots[ticket.slot];
+    if (VKC_READBACK_FREE == slot->state || VKC_READBACK_RETIRING == slot->state
+        || slot->serial != ticket.serial) {
+        return NULL; // Released, or reused by a later ticket.
+    }
+
+    return slot;
+}
+
+// Whether a copy may be recorded into the slot. Never blocks.
+static bool vkc_readback_reusable(VkcReadback* readback, VkcReadbackSlot* slot) {
+    if (VKC_READBACK_RETIRING == slot->state
+        && vkc_sync_point_poll(readback->pool->device, &slot->point)) {
+        slot->state = VKC_READBACK_FREE;
+    }
+
+    return VKC_READBACK_FREE == slot->state;
+}
+
+/** @} */
+
+/**
+ * @name Public
+ * {@
+ */
+
+VkcReadback* vkc_readback_create(VkcMemoryPool* pool, VkDeviceSize capacity, uint32_t slots) {
+    if (!pool || 0 == capacity || 0 == slots || slots > VKC_READBACK_SLOTS_MAX) {
+        LOG_ERROR("[VkcReadback] Invalid readback arguments.");
+        return NULL;
+    }
+
+    VkcReadback* readback = page_malloc(pool->pager, sizeof(*readback), alignof(*readback));
+    if (!readback) {
+        LOG_ERROR("[VkcReadback] Failed to allocate readback structure.");
+        return NULL;
+    }
+
+    *readback = (VkcReadback) {
+        .pool = pool,
+        .capacity = capacity,
+        .source_stage = VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
+        .source_access = VK_ACCESS_SHADER_WRITE_BIT,
+    };
+
+    for (uint32_t i = 0; i < slots; i++) {
+        VkcBuffer* buffer = vkc_buffer_create(
+            pool,
+            capacity,
+            VK_BUFFER_USAGE_TRANSFER_DST_BIT,
+            VKC_MEMORY_READBACK,
+            VKC_BUFFER_MAPPED_BIT
+        );
+        if (!buffer) {
+            LOG_ERROR("[VkcReadback] Failed to create slot %u of %u.", i, slots);
+            vkc_readback_free(readback);
+            return NULL;
+        }
+
+        readback->slots[readback->count++] = (VkcReadbackSlot) {
+            .buffer = buffer,
+            .state = VKC_READBACK_FREE,
+        };
+    }
+
+    return readback;
+}
+
+void vkc_readback_free(VkcReadback* readback) {
+    if (!readback) {
+        return;
+    }
+
+    for (uint32_t i = 0; i < readback->count; i++) {
+        vkc_buffer_free(readback->slots[i].buffer);
+    }
+
+    page_free(readback->pool->pager, readback);
+}
+
+void vkc_readback_source(VkcReadback* readback, VkPipelineStageFlags stage, VkAccessFlags access) {
+    if (!readback || 0 == stage) {
+        LOG_ERROR("[VkcReadback] Invalid source arguments.");
+        return;
+    }
+
+    readback->source_stage = stage;
+    readback->source_access = access;
+}
+
+bool vkc_readback_copy(
+    VkcReadback* readback,
+    VkCommandBuffer command,
+    VkBuffer src,
+    VkDeviceSize src_offset,
+    VkDeviceSize size,
+    VkcReadbackTicket* ticket
+) {
+    if (!readback || !command || VK_NULL_HANDLE == src || !ticket || 0 == size
+        || size > readback->capacity) {
+        LOG_ERROR("[VkcReadback] Invalid copy arguments.");
+        return false;
+    }
+
+    // Start at next so slots rotate, but skip any still held out of order.
+    uint32_t index = readback->next;
+    VkcReadbackSlot* slot = NULL;
+    for (uint32_t i = 0; i < readback->count; i++) {
+        uint32_t candidate = (readback->next + i) % readback->count;
+        if (vkc_readback_reusable(readback, &readback->slots[candidate])) {
+            index = candidate;
+            slot = &readback->slots[candidate];
+            break;
+        }
+    }
+
+    if (!slot) {
+        LOG_ERROR(
+            "[VkcReadback] All %u slots are held by tickets or copies in flight.", readback->count
+        );
+        return false;
+    }
+
+    VkMemoryBarrier before = {
+        .sType = VK_STRUCTURE_TYPE_MEMORY_BARRIER,
+        .srcAccessMask = readback->source_access,
+        .dstAccessMask = VK_ACCESS_TRANSFER_READ_BIT,
+    };
+    vkCmdPipelineBarrier(
+        command,
+        readback->source_stage,
+        VK_PIPELINE_STAGE_TRANSFER_BIT,
+        0,
+        1,
+        &before,
+        0,
+        NULL,
+        0,
+        NULL
+    );
+
+    VkBufferCopy region = {
+        .srcOffset = src_offset,
+        .dstOffset = 0,
+        .size = size,
+    };
+    vkCmdCopyBuffer(command, src, slot->buffer->object, 1, &region);
+
+    VkMemoryBarrier after = {
+        .sType = VK_STRUCTURE_TYPE_MEMORY_BARRIER,
+        .srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT,
+        .dstAccessMask = VK_ACCESS_HOST_READ_BIT,
+    };
+    vkCmdPipelineBarrier(
+        command,
+        VK_PIPELINE_STAGE_TRANSFER_BIT,
+        VK_PIPELINE_STAGE_HOST_BIT,
+        0,
+        1,
+        &after,
+        0,
+        NULL,
+        0,
+        NULL
+    );
+
+    slot->serial = ++readback->serial;
+    slot->size = size;
+    slot->point = (VkcSyncPoint) {0};
+    slot->state = VKC_READBACK_RECORDED;
+    readback->next = (index + 1) % readback->count;
+
+    *ticket = (VkcReadbackTicket) {.serial = slot->serial, .slot = index};
+    return true;
+}
+
+void vkc_readback_commit(VkcReadback* readback, VkcSyncPoint point) {
+    if (!readback) {
+        return;
+    }
+
+    for (uint32_t i = 0; i < readback->count; i++) {
+        VkcReadbackSlot* slot = &readback->slots[i];
+        if (VKC_READBACK_RECORDED == slot->state) {
+            slot->point = point;
+            slot->state = VKC_READBACK_PENDING;
+        }
+    }
+}
+
+bool vkc_readback_poll(VkcReadback* readback, VkcReadbackTicket ticket) {
+    VkcReadbackSlot* slot = vkc_readback_slot(readback, ticket);
+    if (!slot || VKC_READBACK_RECORDED == slot->state) {
+        return false;
+    }
+
+    return VKC_READBACK_READY == slot->state
+           || vkc_sync_point_poll(readback->pool->device, &slot->point);
+}
+
+const void* vkc_readback_wait(VkcReadback* readback, VkcReadbackTicket ticket, uint64_t timeout) {
+    VkcReadbackSlot* slot = vkc_readback_slot(readback, ticket);
+    if (!slot) {
+        LOG_ERROR(
+            "[VkcReadback] Invalid or released ticket %llu.", (unsigned long long) ticket.serial
+        );
+        return NULL;
+    }
+
+    if (VKC_READBACK_RECORDED == slot->state) {
+        LOG_ERROR(
+            "[VkcReadback] Ticket %llu was never committed.", (unsigned long long) ticket.serial
+        );
+        return NULL;
+    }
+
+    if (VKC_READBACK_PENDING == slot->state) {
+        if (!vkc_sync_point_wait(readback->pool->device, &slot->point, timeout)) {
+            return NULL;
+        }
+
+        VkcMemoryBatch batch = {.op = VKC_MEMORY_INVALIDATE};
+        if (!vkc_buffer_invalidate(slot->buffer, &batch, 0, slot->size)
+            || !vkc_memory_batch_submit(readback->pool, &batch)) {
+            return NULL;
+        }
+
+        slot->state = VKC_READBACK_READY;
+    }
+
+    return slot->buffer->mapped;
+}
+
+void vkc_readback_release(VkcReadback* readback, VkcReadbackTicket ticket) {
+    VkcReadbackSlot* slot = vkc_readback_slot(readback, ticket);
+    if (slot) {
+        // The GPU may still be writing a copy that was never waited on.
+        slot->state = VKC_READBACK_PENDING == slot->state ? VKC_READBACK_RETIRING
+                                                          : VKC_READBACK_FREE;
+    }
+}
+
+/** @} */
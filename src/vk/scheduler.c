@@ -0,0 +1,213 @@
+/**
+ * @file src/vk/scheduler.c
+ * @brief Spread independent jobs over every compute queue of a device.
+ */
+
+#include "core/posix.h"
+#include "core/memory.h"
+#include "core/logger.h"
+#include "allocator/page.h"
+#include "vk/queue.h"
+#include "vk/scheduler.h"
+
+/**
+ * @section Private
+ * {@
+ */
+
+static bool vkc_scheduler_accepts(const VkcQueue* queue, uint32_t family) {
+    return VKC_SCHEDULER_ANY_FAMILY == family || queue->family == family;
+}
+
+/** @} */
+
+/**
+ * @name Public
+ * {@
+ */
+
+VkcScheduler* vkc_scheduler_create(
+    PageAllocator* pager,
+    VkDevice device,
+    const VkcDeviceQueueRequest* request,
+    const VkAllocationCallbacks* callbacks,
+    VkcSchedulerPolicy policy
+) {
+    if (!pager || VK_NULL_HANDLE == device || !request || !request->infos || 0 == request->count
+        || (VKC_SCHEDULER_ROUND_ROBIN != policy && VKC_SCHEDULER_LEAST_LOADED != policy)) {
+        LOG_ERROR("[VkcScheduler] Invalid scheduler arguments.");
+        return NULL;
+    }
+
+    VkcScheduler* self = page_malloc(pager, sizeof(*self), alignof(*self));
+    if (!self) {
+        LOG_ERROR("[VkcScheduler] Failed to allocate scheduler structure.");
+        return NULL;
+    }
+
+    *self = (VkcScheduler) {
+        .pager = pager,
+        .queue_count = 0,
+        .family_count = 0,
+        .policy = policy,
+    };
+    atomic_init(&self->cursor, 0);
+
+    for (uint32_t i = 0; i < request->count; i++) {
+        const VkDeviceQueueCreateInfo* info = &request->infos[i];
+        if (info->queueFamilyIndex == request->transfer_family) {
+            continue; // Copies only; owned by a VkcTransfer
+        }
+
+        uint32_t count = info->queueCount;
+        if (count > VKC_SCHEDULER_QUEUES_MAX - self->queue_count) {
+            count = VKC_SCHEDULER_QUEUES_MAX - self->queue_count;
+            LOG_WARN(
+                "[VkcScheduler] Using %u of %u queues in family %u.",
+                count,
+                info->queueCount,
+                info->queueFamilyIndex
+            );
+        }
+
+        if (0 == count) {
+            continue;
+        }
+
+        self->family_count++;
+        for (uint32_t j = 0; j < count; j++) {
+            VkQueue queue = VK_NULL_HANDLE;
+            vkGetDeviceQueue(device, info->queueFamilyIndex, j, &queue);
+
+            VkcQueue* wrapper = vkc_queue_create(
+                pager, device, queue, info->queueFamilyIndex, callbacks
+            );
+            if (!wrapper) {
+                LOG_ERROR(
+                    "[VkcScheduler] Failed to wrap queue %u of family %u.",
+                    j,
+                    info->queueFamilyIndex
+                );
+                vkc_scheduler_free(self);
+                return NULL;
+            }
+
+            self->queues[self->queue_count++] = wrapper;
+        }
+    }
+
+#if defined(VKC_DEBUG) && (1 == VKC_DEBUG)
+    LOG_DEBUG(
+        "[VkcScheduler] Scheduling over %u queues in %u families.",
+        self->queue_count,
+        self->family_count
+    );
+#endif
+
+    return self;
+}
+
+void vkc_scheduler_free(VkcScheduler* scheduler) {
+    if (!scheduler) {
+        return;
+    }
+
+    // Each queue waits for its own tickets before it is destroyed.
+    for (uint32_t i = 0; i < scheduler->queue_count; i++) {
+        vkc_queue_free(scheduler->queues[i]);
+    }
+
+    page_free(scheduler->pager, scheduler);
+}
+
+uint32_t vkc_scheduler_pick(VkcScheduler* scheduler, uint32_t family) {
+    if (!scheduler) {
+        return VKC_SCHEDULER_NONE;
+    }
+
+    uint32_t candidates = 0;
+    for (uint32_t i = 0; i < scheduler->queue_count; i++) {
+        candidates += vkc_scheduler_accepts(scheduler->queues[i], family);
+    }
+
+    if (0 == candidates) {
+        LOG_ERROR("[VkcScheduler] No queue of family %u.", family);
+        return VKC_SCHEDULER_NONE;
+    }
+
+    // The cursor counts picks, so round-robin is even within any family.
+    uint32_t skip = atomic_fetch_add_explicit(&scheduler->cursor, 1, memory_order_relaxed)
+                    % candidates;
+
+    uint32_t first = VKC_SCHEDULER_NONE;
+    for (uint32_t i = 0; i < scheduler->queue_count; i++) {
+        if (vkc_scheduler_accepts(scheduler->queues[i], family) && 0 == skip--) {
+            first = i;
+            break;
+        }
+    }
+
+    if (VKC_SCHEDULER_ROUND_ROBIN == scheduler->policy) {
+        return first;
+    }
+
+    // Walk the candidates from the round-robin position so ties rotate.
+    uint32_t best = first;
+    uint64_t best_load = UINT64_MAX;
+    for (uint32_t k = 0; k < scheduler->queue_count; k++) {
+        uint32_t i = (first + k) % scheduler->queue_count;
+        VkcQueue* queue = scheduler->queues[i];
+        if (!vkc_scheduler_accepts(queue, family)) {
+            continue;
+        }
+
+        uint64_t load = vkc_queue_pending(queue);
+        if (load < best_load) {
+            best = i;
+            best_load = load;
+            if (0 == load) {
+                break;
+            }
+        }
+    }
+
+    return best;
+}
+
+VkcSchedulerTicket vkc_scheduler_submit(
+    VkcScheduler* scheduler, uint32_t family, const VkcQueueSubmit* submit
+) {
+    uint32_t index = vkc_scheduler_pick(scheduler, family);
+    if (VKC_SCHEDULER_NONE == index) {
+        return (VkcSchedulerTicket) {0};
+    }
+
+    VkcQueue* queue = scheduler->queues[index];
+    uint64_t ticket = vkc_queue_submit(queue, submit);
+    if (0 == ticket) {
+        return (VkcSchedulerTicket) {0};
+    }
+
+    return (VkcSchedulerTicket) {.queue = queue, .ticket = ticket};
+}
+
+bool vkc_scheduler_wait_idle(VkcScheduler* scheduler, uint64_t timeout) {
+    if (!scheduler) {
+        return false;
+    }
+
+    bool idle = true;
+    for (uint32_t i = 0; i < scheduler->queue_count; i++) {
+        VkcQueue* queue = scheduler->queues[i];
+
+        pthread_mutex_lock(&queue->mutex);
+        uint64_t submitted = queue->submitted;
+        pthread_mutex_unlock(&queue->mutex);
+
+        idle = vkc_queue_wait(queue, submitted, timeout) && idle;
+    }
+
+    return idle;
+}
+
+/** @} */
@@ -0,0 +1,222 @@
+/**
+ * @file src/vk/slab.c
+ * @brief Fixed-size slot slabs for small Vulkan host allocations.
+ */
+
+#include "core/posix.h"
+#include "core/memory.h"
+#include "core/logger.h"
+#include "allocator/page.h"
+#include "vk/slab.h"
+
+/**
+ * @section Private
+ * {@
+ */
+
+static inline size_t vkc_slab_round(size_t size) {
+    size_t alignment = alignof(max_align_t);
+    return (size + alignment - 1) & ~(alignment - 1);
+}
+
+static inline unsigned char* vkc_slab_page_data(VkcSlab* slab, VkcSlabPage* page) {
+    return (unsigned char*) page + slab->slot_offset;
+}
+
+static void vkc_slab_link(VkcSlab* slab, VkcSlabPage* page) {
+    page->prev = NULL;
+    page->next = slab->partial;
+    if (slab->partial) {
+        slab->partial->prev = page;
+    }
+    slab->partial = page;
+    page->partial = true;
+}
+
+static void vkc_slab_unlink(VkcSlab* slab, VkcSlabPage* page) {
+    if (page->prev) {
+        page->prev->next = page->next;
+    } else {
+        slab->partial = page->next;
+    }
+    if (page->next) {
+        page->next->prev = page->prev;
+    }
+    page->next = page->prev = NULL;
+    page->partial = false;
+}
+
+static VkcSlabPage* vkc_slab_page_create(VkcSlab* slab) {
+    VkcSlabPage* page = slab->empty;
+    if (page) {
+        slab->empty = NULL;
+    } else {
+        page = page_malloc(slab->pager, VKC_SLAB_PAGE_SIZE, alignof(max_align_t));
+        if (!page) {
+            LOG_ERROR("[VkcSlab] Failed to allocate %d byte page.", VKC_SLAB_PAGE_SIZE);
+            return NULL;
+        }
+    }
+
+    // Slots are carved lazily so untouched memory stays untouched.
+    *page = (VkcSlabPage) {
+        .free = NULL,
+        .carved = 0,
+        .used = 0,
+        .capacity = (uint32_t) ((VKC_SLAB_PAGE_SIZE - slab->slot_offset) / slab->slot_size),
+    };
+
+    return page;
+}
+
+static void* vkc_slab_page_pop(VkcSlab* slab, VkcSlabPage* page) {
+    void* slot = NULL;
+    if (page->free) {
+        slot = page->free;
+        page->free = page->free->next;
+    } else if (page->carved < page->capacity) {
+        slot = vkc_slab_page_data(slab, page) + (size_t) page->carved * slab->slot_size;
+        page->carved++;
+    } else {
+        return NULL;
+    }
+
+    page->used++;
+    return slot;
+}
+
+/** @} */
+
+/**
+ * @name Public
+ * {@
+ */
+
+VkcSlab* vkc_slab_create(PageAllocator* pager, size_t slot_size) {
+    if (!pager) {
+        LOG_ERROR("[VkcSlab] Missing allocation context (PageAllocator).");
+        return NULL;
+    }
+
+    slot_size = vkc_slab_round(slot_size < sizeof(VkcSlabNode) ? sizeof(VkcSlabNode) : slot_size);
+    size_t slot_offset = vkc_slab_round(sizeof(VkcSlabPage));
+    if (slot_offset + slot_size > VKC_SLAB_PAGE_SIZE) {
+        LOG_ERROR("[VkcSlab] Slot size %zu does not fit a slab page.", slot_size);
+        return NULL;
+    }
+
+    VkcSlab* slab = page_malloc(pager, sizeof(*slab), alignof(*slab));
+    if (!slab) {
+        LOG_ERROR("[VkcSlab] Failed to allocate slab structure.");
+        return NULL;
+    }
+
+    *slab = (VkcSlab) {
+        .pager = pager,
+        .partial = NULL,
+        .empty = NULL,
+        .slot_size = slot_size,
+        .slot_offset = slot_offset,
+    };
+
+    if (0 != pthread_mutex_init(&slab->mutex, NULL)) {
+        LOG_ERROR("[VkcSlab] Failed to initialize slab mutex.");
+        page_free(pager, slab);
+        return NULL;
+    }
+
+    return slab;
+}
+
+void vkc_slab_free(VkcSlab* slab) {
+    if (!slab) {
+        return;
+    }
+
+    PageAllocator* pager = slab->pager;
+
+    // Full pages are not linked anywhere and are reclaimed with the PageAllocator.
+    while (slab->partial) {
+        VkcSlabPage* next = slab->partial->next;
+        if (0 == slab->partial->used) {
+            page_free(pager, slab->partial);
+        }
+        slab->partial = next;
+    }
+
+    if (slab->empty) {
+        page_free(pager, slab->empty);
+    }
+
+    pthread_mutex_destroy(&slab->mutex);
+    page_free(pager, slab);
+}
+
+uint32_t vkc_slab_malloc(VkcSlab* slab, void** slots, VkcSlabPage** pages, uint32_t count) {
+    if (!slab || !slots || !pages) {
+        return 0;
+    }
+
+    pthread_mutex_lock(&slab->mutex);
+
+    uint32_t n = 0;
+    while (n < count) {
+        VkcSlabPage* page = slab->partial;
+        if (!page) {
+            page = vkc_slab_page_create(slab);
+            if (!page) {
+                break;
+            }
+            vkc_slab_link(slab, page);
+        }
+
+        while (n < count) {
+            void* slot = vkc_slab_page_pop(slab, page);
+            if (!slot) {
+                break;
+            }
+            slots[n] = slot;
+            pages[n] = page;
+            n++;
+        }
+
+        if (!page->free && page->carved == page->capacity) {
+            vkc_slab_unlink(slab, page);
+        }
+    }
+
+    pthread_mutex_unlock(&slab->mutex);
+    return n;
+}
+
+void vkc_slab_release(VkcSlab* slab, VkcSlabPage* page, void* slot) {
+    if (!slab || !page || !slot) {
+        return;
+    }
+
+    pthread_mutex_lock(&slab->mutex);
+
+    VkcSlabNode* node = (VkcSlabNode*) slot;
+    node->next = page->free;
+    page->free = node;
+    page->used--;
+
+    if (0 == page->used) {
+        // Keep one empty page warm so a slot ping-ponging across a page
+        // boundary does not thrash the PageAllocator.
+        if (page->partial) {
+            vkc_slab_unlink(slab, page);
+        }
+        if (slab->empty) {
+            page_free(slab->pager, page);
+        } else {
+            slab->empty = page;
+        }
+    } else if (!page->partial) {
+        vkc_slab_link(slab, page);
+    }
+
+    pthread_mutex_unlock(&slab->mutex);
+}
+
+/** @} */
@@ -0,0 +1,245 @@
+/**
+ * @file src/vk/staging.c
+ * @brief Circular staging buffer for uploads to device-local memory.
+ */
+
+#include "core/posix.h"
+#include "core/memory.h"
+#include "core/logger.h"
+#include "allocator/page.h"
+#include "vk/sync.h"
+#include "vk/buffer.h"
+#include "vk/staging.h"
+
+#include <string.h>
+
+/**
+ * @section Private
+ * {@
+ */
+
+static bool vkc_staging_ring_retire(VkcStagingRing* ring, bool wait) {
+    if (0 == ring->count) {
+        return false;
+    }
+
+    VkDevice device = ring->buffer->pool->device;
+    VkcStagingCommit* commit = &ring->pending[ring->first];
+
+    bool reached = wait ? vkc_sync_point_wait(device, &commit->point, UINT64_MAX)
+                        : vkc_sync_point_poll(device, &commit->point);
+    if (!reached) {
+        return false;
+    }
+
+    ring->tail = commit->head;
+    ring->first = (ring->first + 1) % VKC_STAGING_PENDING;
+    ring->count--;
+    return true;
+}
+
+/** @} */
+
+/**
+ * @name Public
+ * {@
+ */
+
+VkcStagingRing* vkc_staging_ring_create(VkcMemoryPool* pool, VkDeviceSize capacity) {
+    if (!pool || 0 == capacity) {
+        LOG_ERROR("[VkcStagingRing] Invalid ring arguments.");
+        return NULL;
+    }
+
+    // nonCoherentAtomSize is a power of two, so the larger value is a multiple of both.
+    VkDeviceSize alignment = VKC_STAGING_ALIGNMENT;
+    if (pool->atom > alignment) {
+        alignment = pool->atom;
+    }
+    capacity = (capacity + alignment - 1) & ~(alignment - 1);
+
+    VkcStagingRing* ring = page_malloc(pool->pager, sizeof(*ring), alignof(*ring));
+    if (!ring) {
+        LOG_ERROR("[VkcStagingRing] Failed to allocate ring structure.");
+        return NULL;
+    }
+
+    VkcBuffer* buffer = vkc_buffer_create(
+        pool, capacity, VK_BUFFER_USAGE_TRANSFER_SRC_BIT, VKC_MEMORY_UPLOAD, VKC_BUFFER_MAPPED_BIT
+    );
+    if (!buffer) {
+        LOG_ERROR(
+            "[VkcStagingRing] Failed to create %llu byte ring.", (unsigned long long) capacity
+        );
+        page_free(pool->pager, ring);
+        return NULL;
+    }
+
+    *ring = (VkcStagingRing) {
+        .buffer = buffer,
+        .batch = {.op = VKC_MEMORY_FLUSH},
+        .capacity = capacity,
+        .alignment = alignment,
+    };
+
+    return ring;
+}
+
+void vkc_staging_ring_free(VkcStagingRing* ring) {
+    if (!ring) {
+        return;
+    }
+
+    PageAllocator* pager = ring->buffer->pool->pager;
+
+    vkc_buffer_free(ring->buffer);
+    page_free(pager, ring);
+}
+
+void* vkc_staging_ring_alloc(VkcStagingRing* ring, VkDeviceSize size, VkDeviceSize* offset) {
+    if (!ring || !offset || 0 == size || size > ring->capacity) {
+        LOG_ERROR("[VkcStagingRing] Invalid allocation arguments.");
+        return NULL;
+    }
+
+    uint64_t start = (ring->head + ring->alignment - 1) & ~(ring->alignment - 1);
+    uint64_t lap = start % ring->capacity;
+    if (lap + size > ring->capacity) {
+        start += ring->capacity - lap; // Skip to the next lap; ranges never wrap.
+    }
+
+    vkc_staging_ring_reclaim(ring);
+
+    while (start + size > ring->tail + ring->capacity) {
+        if (0 == ring->count) {
+            LOG_ERROR(
+                "[VkcStagingRing] %llu bytes do not fit beside uncommitted ranges.",
+                (unsigned long long) size
+            );
+            return NULL;
+        }
+
+#if defined(VKC_DEBUG) && (1 == VKC_DEBUG)
+        LOG_DEBUG("[VkcStagingRing] Ring full; waiting on the oldest of %u commits.", ring->count);
+#endif
+
+        if (!vkc_staging_ring_retire(ring, true)) {
+            LOG_ERROR("[VkcStagingRing] Failed to wait for a pending commit.");
+            return NULL;
+        }
+    }
+
+    ring->head = start + size;
+    *offset = start % ring->capacity;
+    return (uint8_t*) ring->buffer->mapped + *offset;
+}
+
+bool vkc_staging_ring_copy(
+    VkcStagingRing* ring,
+    VkCommandBuffer command,
+    VkDeviceSize offset,
+    VkDeviceSize size,
+    VkBuffer dst,
+    VkDeviceSize dst_offset
+) {
+    if (!ring || !command || VK_NULL_HANDLE == dst || offset + size > ring->capacity) {
+        LOG_ERROR("[VkcStagingRing] Invalid copy arguments.");
+        return false;
+    }
+
+    if (!vkc_buffer_flush(ring->buffer, &ring->batch, offset, size)) {
+        return false;
+    }
+
+    VkBufferCopy region = {
+        .srcOffset = offset,
+        .dstOffset = dst_offset,
+        .size = size,
+    };
+    vkCmdCopyBuffer(command, ring->buffer->object, dst, 1, &region);
+    return true;
+}
+
+bool vkc_staging_ring_upload(
+    VkcStagingRing* ring,
+    VkCommandBuffer command,
+    const void* data,
+    VkDeviceSize size,
+    VkBuffer dst,
+    VkDeviceSize dst_offset
+) {
+    if (!data) {
+        LOG_ERROR("[VkcStagingRing] Invalid upload data.");
+        return false;
+    }
+
+    VkDeviceSize offset = 0;
+    void* range = vkc_staging_ring_alloc(ring, size, &offset);
+    if (!range) {
+        return false;
+    }
+
+    memcpy(range, data, size);
+    return vkc_staging_ring_copy(ring, command, offset, size, dst, dst_offset);
+}
+
+void vkc_staging_ring_barrier(
+    VkCommandBuffer command, VkPipelineStageFlags stage, VkAccessFlags access
+) {
+    VkMemoryBarrier barrier = {
+        .sType = VK_STRUCTURE_TYPE_MEMORY_BARRIER,
+        .srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT,
+        .dstAccessMask = access,
+    };
+
+    vkCmdPipelineBarrier(
+        command, VK_PIPELINE_STAGE_TRANSFER_BIT, stage, 0, 1, &barrier, 0, NULL, 0, NULL
+    );
+}
+
+bool vkc_staging_ring_flush(VkcStagingRing* ring) {
+    if (!ring) {
+        LOG_ERROR("[VkcStagingRing] Invalid ring.");
+        return false;
+    }
+
+    if (!vkc_memory_batch_submit(ring->buffer->pool, &ring->batch)) {
+        return false;
+    }
+
+    // Make room now so that the commit after the submit cannot block or fail.
+    if (VKC_STAGING_PENDING == ring->count && !vkc_staging_ring_retire(ring, true)) {
+        LOG_ERROR("[VkcStagingRing] Failed to wait for a pending commit.");
+        return false;
+    }
+
+    return true;
+}
+
+bool vkc_staging_ring_commit(VkcStagingRing* ring, VkcSyncPoint point) {
+    if (!vkc_staging_ring_flush(ring)) {
+        return false;
+    }
+
+    if (ring->head == ring->committed) {
+        return true; // Nothing staged since the last commit.
+    }
+
+    uint32_t index = (ring->first + ring->count) % VKC_STAGING_PENDING;
+    ring->pending[index] = (VkcStagingCommit) {.point = point, .head = ring->head};
+    ring->committed = ring->head;
+    ring->count++;
+    return true;
+}
+
+uint32_t vkc_staging_ring_reclaim(VkcStagingRing* ring) {
+    if (!ring) {
+        return 0;
+    }
+
+    while (vkc_staging_ring_retire(ring, false)) {}
+
+    return ring->count;
+}
+
+/** @} */
@@ -0,0 +1,643 @@
+/**
+ * @file src/vk/stream.c
+ * @brief Out-of-core execution of a kernel over data larger than device memory.
+ */
+
+#include "core/posix.h"
+#include "core/memory.h"
+#include "core/logger.h"
+#include "allocator/page.h"
+#include "vk/sync.h"
+#include "vk/queue.h"
+#include "vk/buffer.h"
+#include "vk/staging.h"
+#include "vk/readback.h"
+#include "vk/transfer.h"
+#include "vk/stream.h"
+
+/**
+ * @section Private
+ * {@
+ */
+
+static VkDeviceSize vkc_stream_chunk_size(VkcMemoryPool* pool, const VkcStreamInfo* info) {
+    VkDeviceSize size = info->chunk_size;
+
+    if (0 == size) {
+        size = VKC_STREAM_CHUNK_SIZE;
+
+        // Leave three quarters of what is left of VRAM to everyone else.
+        uint32_t type = vkc_memory_type_select(pool, UINT32_MAX, VKC_MEMORY_GPU_ONLY);
+        if (VKC_MEMORY_TYPE_NONE != type) {
+            VkcMemoryBudget budgets[VK_MAX_MEMORY_HEAPS];
+            uint32_t heaps = vkc_memory_budget_query(pool, budgets);
+            uint32_t heap = pool->properties.memoryTypes[type].heapIndex;
+            if (heap < heaps && budgets[heap].budget > budgets[heap].usage) {
+                VkDeviceSize room = (budgets[heap].budget - budgets[heap].usage) / 4 / info->depth;
+                if (room < size) {
+                    size = room;
+                }
+            }
+        }
+    }
+
+    VkPhysicalDeviceProperties properties = {0};
+    vkGetPhysicalDeviceProperties(pool->physical, &properties);
+
+    VkDeviceSize range = properties.limits.maxStorageBufferRange;
+    if (range && size > range) {
+        size = range;
+    }
+
+    VkDeviceSize groups = properties.limits.maxComputeWorkGroupCount[0];
+    if (groups && size / info->group_size > groups) {
+        size = groups * info->group_size;
+    }
+
+    return size - size % info->group_size;
+}
+
+static bool vkc_stream_slot_create(VkcStream* stream, VkcStreamSlot* slot) {
+    VkcMemoryPool* pool = stream->pool;
+
+    slot->input = vkc_buffer_create(
+        pool,
+        stream->info.chunk_size,
+        VK_BUFFER_USAGE_STORAGE_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT,
+        VKC_MEMORY_GPU_ONLY,
+        0
+    );
+    slot->output = vkc_buffer_create(
+        pool,
+        stream->info.output_size,
+        VK_BUFFER_USAGE_STORAGE_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_SRC_BIT
+            | VK_BUFFER_USAGE_TRANSFER_DST_BIT,
+        VKC_MEMORY_GPU_ONLY,
+        0
+    );
+    if (!slot->input || !slot->output) {
+        LOG_ERROR("[VkcStream] Failed to create slot buffers.");
+        return false;
+    }
+
+    VkFenceCreateInfo fence_info = {.sType = VK_STRUCTURE_TYPE_FENCE_CREATE_INFO};
+    VkResult result = vkCreateFence(pool->device, &fence_info, pool->callbacks, &slot->fence);
+    if (VK_SUCCESS != result) {
+        LOG_ERROR("[VkcStream] Failed to create fence (VkResult=%d).", result);
+        return false;
+    }
+
+    VkDescriptorSetAllocateInfo set_info = {
+        .sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO,
+        .descriptorPool = stream->descriptor_pool,
+        .descriptorSetCount = 1,
+        .pSetLayouts = &stream->info.set_layout,
+    };
+    result = vkAllocateDescriptorSets(pool->device, &set_info, &slot->set);
+    if (VK_SUCCESS != result) {
+        LOG_ERROR("[VkcStream] Failed to allocate descriptor set (VkResult=%d).", result);
+        return false;
+    }
+
+    VkDescriptorBufferInfo buffers[2] = {
+        {.buffer = slot->input->object, .offset = 0, .range = VK_WHOLE_SIZE},
+        {.buffer = slot->output->object, .offset = 0, .range = VK_WHOLE_SIZE},
+    };
+
+    VkWriteDescriptorSet writes[2];
+    for (uint32_t i = 0; i < 2; i++) {
+        writes[i] = (VkWriteDescriptorSet) {
+            .sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET,
+            .dstSet = slot->set,
+            .dstBinding = i,
+            .descriptorCount = 1,
+            .descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER,
+            .pBufferInfo = &buffers[i],
+        };
+    }
+    vkUpdateDescriptorSets(pool->device, 2, writes, 0, NULL);
+
+    return true;
+}
+
+// Wait for a slot's chunk and hand its output to combine, if any.
+static bool vkc_stream_finish(
+    VkcStream* stream, VkcStreamSlot* slot, VkcStreamCombine combine, void* user
+) {
+    bool ok = true;
+
+    const void* partial = vkc_readback_wait(stream->readback, slot->ticket, UINT64_MAX);
+    if (!partial) {
+        LOG_ERROR("[VkcStream] Failed to read back chunk %llu.", (unsigned long long) slot->chunk);
+        ok = false;
+    } else if (combine) {
+        combine(partial, stream->info.output_size, slot->chunk, user);
+    }
+
+    vkc_readback_release(stream->readback, slot->ticket);
+    vkc_staging_ring_reclaim(stream->ring);
+    slot->busy = false;
+    return ok;
+}
+
+static bool vkc_stream_begin(VkCommandBuffer command, uint64_t chunk) {
+    VkCommandBufferBeginInfo begin = {
+        .sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO,
+        .flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT,
+    };
+    VkResult result = vkResetCommandBuffer(command, 0);
+    if (VK_SUCCESS == result) {
+        result = vkBeginCommandBuffer(command, &begin);
+    }
+    if (VK_SUCCESS != result) {
+        LOG_ERROR(
+            "[VkcStream] Failed to begin chunk %llu (VkResult=%d).",
+            (unsigned long long) chunk,
+            result
+        );
+        return false;
+    }
+
+    return true;
+}
+
+// Pad the input, clear the output, and run the kernel over size bytes of input.
+static void vkc_stream_dispatch(
+    const VkcStream* stream, const VkcStreamSlot* slot, VkCommandBuffer command, VkDeviceSize size
+) {
+    const VkcStreamInfo* info = &stream->info;
+
+    // A short final chunk is padded with zeros up to a whole workgroup.
+    VkDeviceSize padded = (size + info->group_size - 1) / info->group_size * info->group_size;
+    if (padded > size) {
+        vkCmdFillBuffer(command, slot->input->object, size, padded - size, 0);
+    }
+    vkCmdFillBuffer(command, slot->output->object, 0, VK_WHOLE_SIZE, 0);
+
+    vkc_staging_ring_barrier(
+        command,
+        VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
+        VK_ACCESS_SHADER_READ_BIT | VK_ACCESS_SHADER_WRITE_BIT
+    );
+
+    vkCmdBindPipeline(command, VK_PIPELINE_BIND_POINT_COMPUTE, info->pipeline);
+    vkCmdBindDescriptorSets(
+        command, VK_PIPELINE_BIND_POINT_COMPUTE, info->layout, 0, 1, &slot->set, 0, NULL
+    );
+    vkCmdDispatch(command, (uint32_t) (padded / info->group_size), 1, 1);
+}
+
+static bool vkc_stream_commit_ring(VkcSyncPoint point, void* ring) {
+    return vkc_staging_ring_commit(ring, point);
+}
+
+static bool vkc_stream_commit_readback(VkcSyncPoint point, void* readback) {
+    vkc_readback_commit(readback, point);
+    return true;
+}
+
+static bool vkc_stream_submit(
+    VkcStream* stream,
+    VkcStreamSlot* slot,
+    uint64_t chunk,
+    VkDeviceSize offset,
+    VkDeviceSize size,
+    VkcStreamRead read,
+    void* user
+) {
+    const VkcStreamInfo* info = &stream->info;
+    VkDevice device = stream->pool->device;
+    VkCommandBuffer command = slot->command;
+
+    VkDeviceSize staged = 0;
+    void* dst = vkc_staging_ring_alloc(stream->ring, size, &staged);
+    if (!dst || !read(dst, offset, size, user)) {
+        LOG_ERROR("[VkcStream] Failed to stage chunk %llu.", (unsigned long long) chunk);
+        return false;
+    }
+
+    if (!vkc_stream_begin(command, chunk)) {
+        return false;
+    }
+
+    if (!vkc_staging_ring_copy(stream->ring, command, staged, size, slot->input->object, 0)) {
+        vkEndCommandBuffer(command);
+        return false;
+    }
+
+    vkc_stream_dispatch(stream, slot, command, size);
+
+    bool copied = vkc_readback_copy(
+        stream->readback, command, slot->output->object, 0, info->output_size, &slot->ticket
+    );
+
+    VkResult result = vkEndCommandBuffer(command);
+    if (!copied || VK_SUCCESS != result) {
+        LOG_ERROR(
+            "[VkcStream] Failed to record chunk %llu (VkResult=%d).",
+            (unsigned long long) chunk,
+            result
+        );
+        if (copied) {
+            vkc_readback_release(stream->readback, slot->ticket);
+        }
+        return false;
+    }
+
+    // A plain fence is not signaled when the submit fails, so tag nothing
+    // with it before the submit succeeded.
+    if (!vkc_staging_ring_flush(stream->ring)) {
+        vkc_readback_release(stream->readback, slot->ticket);
+        return false;
+    }
+
+    VkSubmitInfo submit = {
+        .sType = VK_STRUCTURE_TYPE_SUBMIT_INFO,
+        .commandBufferCount = 1,
+        .pCommandBuffers = &command,
+    };
+
+    result = vkResetFences(device, 1, &slot->fence);
+    if (VK_SUCCESS == result) {
+        result = vkQueueSubmit(info->queue, 1, &submit, slot->fence);
+    }
+    if (VK_SUCCESS != result) {
+        LOG_ERROR(
+            "[VkcStream] Failed to submit chunk %llu (VkResult=%d).",
+            (unsigned long long) chunk,
+            result
+        );
+        vkc_readback_release(stream->readback, slot->ticket);
+        return false;
+    }
+
+    VkcSyncPoint point = vkc_sync_fence(slot->fence);
+    vkc_staging_ring_commit(stream->ring, point);
+    vkc_readback_commit(stream->readback, point);
+
+    slot->chunk = chunk;
+    slot->busy = true;
+    return true;
+}
+
+// The same chunk as three submissions: upload on the transfer queue, dispatch
+// on compute, and readback on the transfer queue, each waiting on the last.
+static bool vkc_stream_submit_transfer(
+    VkcStream* stream,
+    VkcStreamSlot* slot,
+    uint64_t chunk,
+    VkDeviceSize offset,
+    VkDeviceSize size,
+    VkcStreamRead read,
+    void* user
+) {
+    const VkcStreamInfo* info = &stream->info;
+    VkcTransfer* transfer = info->transfer;
+    VkBuffer input = slot->input->object;
+    VkBuffer output = slot->output->object;
+
+    VkDeviceSize staged = 0;
+    void* dst = vkc_staging_ring_alloc(stream->ring, size, &staged);
+    if (!dst || !read(dst, offset, size, user)) {
+        LOG_ERROR("[VkcStream] Failed to stage chunk %llu.", (unsigned long long) chunk);
+        return false;
+    }
+
+    // The input is overwritten, so the upload needs no acquire, only a release.
+    VkCommandBuffer upload = vkc_transfer_begin(transfer);
+    if (VK_NULL_HANDLE == upload) {
+        return false;
+    }
+    if (!vkc_staging_ring_copy(stream->ring, upload, staged, size, input, 0)) {
+        vkc_transfer_cancel(transfer);
+        return false;
+    }
+    vkc_transfer_release(
+        transfer,
+        upload,
+        VKC_TRANSFER_TO_COMPUTE,
+        input,
+        VK_PIPELINE_STAGE_TRANSFER_BIT,
+        VK_ACCESS_TRANSFER_WRITE_BIT
+    );
+
+    VkcQueueSubmit upload_submit = {
+        .wait_stage = VK_PIPELINE_STAGE_TRANSFER_BIT,
+        .prepare = vkc_stream_commit_ring,
+        .user = stream->ring,
+    };
+    uint64_t uploaded = vkc_transfer_submit(transfer, &upload_submit);
+    if (0 == uploaded) {
+        LOG_ERROR("[VkcStream] Failed to upload chunk %llu.", (unsigned long long) chunk);
+        return false;
+    }
+
+    // Padding writes the input too, so it is acquired for transfers as well.
+    VkCommandBuffer command = slot->command;
+    if (!vkc_stream_begin(command, chunk)) {
+        return false;
+    }
+
+    const VkPipelineStageFlags stages = VK_PIPELINE_STAGE_TRANSFER_BIT
+                                        | VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT;
+    vkc_transfer_acquire(
+        transfer,
+        command,
+        VKC_TRANSFER_TO_COMPUTE,
+        input,
+        stages,
+        VK_ACCESS_TRANSFER_WRITE_BIT | VK_ACCESS_SHADER_READ_BIT
+    );
+    vkc_stream_dispatch(stream, slot, command, size);
+    vkc_transfer_release(
+        transfer,
+        command,
+        VKC_TRANSFER_TO_HOST,
+        output,
+        VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
+        VK_ACCESS_SHADER_WRITE_BIT
+    );
+
+    VkResult result = vkEndCommandBuffer(command);
+    if (VK_SUCCESS != result) {
+        LOG_ERROR(
+            "[VkcStream] Failed to record chunk %llu (VkResult=%d).",
+            (unsigned long long) chunk,
+            result
+        );
+        return false;
+    }
+
+    VkcSyncPoint upload_point = vkc_queue_point(transfer->queue, uploaded);
+    VkcQueueSubmit dispatch_submit = {
+        .commands = &command,
+        .command_count = 1,
+        .waits = &upload_point,
+        .wait_count = 1,
+        .wait_stage = stages,
+    };
+    uint64_t dispatched = vkc_queue_submit(transfer->compute, &dispatch_submit);
+    if (0 == dispatched) {
+        LOG_ERROR("[VkcStream] Failed to submit chunk %llu.", (unsigned long long) chunk);
+        return false;
+    }
+
+    // From here on the dispatch is in flight, so failures wait it out.
+    VkCommandBuffer download = vkc_transfer_begin(transfer);
+    bool copied = VK_NULL_HANDLE != download;
+    if (copied) {
+        vkc_transfer_acquire(
+            transfer,
+            download,
+            VKC_TRANSFER_TO_HOST,
+            output,
+            VK_PIPELINE_STAGE_TRANSFER_BIT,
+            VK_ACCESS_TRANSFER_READ_BIT
+        );
+        copied = vkc_readback_copy(
+            stream->readback, download, output, 0, info->output_size, &slot->ticket
+        );
+        if (!copied) {
+            vkc_transfer_cancel(transfer);
+        }
+    }
+
+    uint64_t downloaded = 0;
+    if (copied) {
+        VkcSyncPoint dispatch_point = vkc_queue_point(transfer->compute, dispatched);
+        VkcQueueSubmit download_submit = {
+            .waits = &dispatch_point,
+            .wait_count = 1,
+            .wait_stage = VK_PIPELINE_STAGE_TRANSFER_BIT,
+            .prepare = vkc_stream_commit_readback,
+            .user = stream->readback,
+        };
+        downloaded = vkc_transfer_submit(transfer, &download_submit);
+        if (0 == downloaded) {
+            vkc_readback_release(stream->readback, slot->ticket);
+        }
+    }
+
+    if (0 == downloaded) {
+        LOG_ERROR("[VkcStream] Failed to read back chunk %llu.", (unsigned long long) chunk);
+        vkc_queue_wait(transfer->compute, dispatched, UINT64_MAX);
+        return false;
+    }
+
+    slot->copied = downloaded;
+    slot->chunk = chunk;
+    slot->busy = true;
+    return true;
+}
+
+/** @} */
+
+/**
+ * @name Public
+ * {@
+ */
+
+VkcStream* vkc_stream_create(VkcMemoryPool* pool, const VkcStreamInfo* info) {
+    if (!pool || !info || (VK_NULL_HANDLE == info->queue && !info->transfer)
+        || VK_NULL_HANDLE == info->pipeline
+        || VK_NULL_HANDLE == info->layout || VK_NULL_HANDLE == info->set_layout
+        || 0 == info->group_size || 0 != info->group_size % 4 || 0 == info->output_size
+        || 0 == info->depth || info->depth > VKC_STREAM_DEPTH_MAX) {
+        LOG_ERROR("[VkcStream] Invalid stream arguments.");
+        return NULL;
+    }
+
+    VkcStream* stream = page_malloc(pool->pager, sizeof(*stream), alignof(*stream));
+    if (!stream) {
+        LOG_ERROR("[VkcStream] Failed to allocate stream structure.");
+        return NULL;
+    }
+
+    *stream = (VkcStream) {
+        .pool = pool,
+        .info = *info,
+    };
+
+    // Dispatches go to the transfer's compute queue, whatever info names.
+    if (info->transfer) {
+        stream->info.queue = info->transfer->compute->queue;
+        stream->info.queue_family = info->transfer->compute->family;
+    }
+
+    stream->info.chunk_size = vkc_stream_chunk_size(pool, info);
+    if (0 == stream->info.chunk_size) {
+        LOG_ERROR("[VkcStream] No room for a single workgroup per chunk.");
+        page_free(pool->pager, stream);
+        return NULL;
+    }
+
+    uint32_t depth = info->depth;
+
+    // Every slot's chunk can be staged while the next one is written.
+    stream->ring = vkc_staging_ring_create(pool, (depth + 1) * stream->info.chunk_size);
+    stream->readback = vkc_readback_create(pool, info->output_size, depth);
+    if (!stream->ring || !stream->readback) {
+        vkc_stream_free(stream);
+        return NULL;
+    }
+
+    // Readbacks on the transfer queue follow the acquire, not the shader.
+    if (info->transfer) {
+        vkc_readback_source(stream->readback, VK_PIPELINE_STAGE_TRANSFER_BIT, 0);
+    }
+
+    VkCommandPoolCreateInfo command_pool_info = {
+        .sType = VK_STRUCTURE_TYPE_COMMAND_POOL_CREATE_INFO,
+        .flags = VK_COMMAND_POOL_CREATE_RESET_COMMAND_BUFFER_BIT,
+        .queueFamilyIndex = stream->info.queue_family,
+    };
+    VkResult result = vkCreateCommandPool(
+        pool->device, &command_pool_info, pool->callbacks, &stream->command_pool
+    );
+    if (VK_SUCCESS != result) {
+        LOG_ERROR("[VkcStream] Failed to create command pool (VkResult=%d).", result);
+        vkc_stream_free(stream);
+        return NULL;
+    }
+
+    VkDescriptorPoolSize pool_size = {
+        .type = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER,
+        .descriptorCount = 2 * depth,
+    };
+    VkDescriptorPoolCreateInfo descriptor_pool_info = {
+        .sType = VK_STRUCTURE_TYPE_DESCRIPTOR_POOL_CREATE_INFO,
+        .maxSets = depth,
+        .poolSizeCount = 1,
+        .pPoolSizes = &pool_size,
+    };
+    result = vkCreateDescriptorPool(
+        pool->device, &descriptor_pool_info, pool->callbacks, &stream->descriptor_pool
+    );
+    if (VK_SUCCESS != result) {
+        LOG_ERROR("[VkcStream] Failed to create descriptor pool (VkResult=%d).", result);
+        vkc_stream_free(stream);
+        return NULL;
+    }
+
+    VkCommandBuffer commands[VKC_STREAM_DEPTH_MAX];
+    VkCommandBufferAllocateInfo command_info = {
+        .sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO,
+        .commandPool = stream->command_pool,
+        .level = VK_COMMAND_BUFFER_LEVEL_PRIMARY,
+        .commandBufferCount = depth,
+    };
+    result = vkAllocateCommandBuffers(pool->device, &command_info, commands);
+    if (VK_SUCCESS != result) {
+        LOG_ERROR("[VkcStream] Failed to allocate command buffers (VkResult=%d).", result);
+        vkc_stream_free(stream);
+        return NULL;
+    }
+
+    for (uint32_t i = 0; i < depth; i++) {
+        stream->slots[i].command = commands[i];
+        if (!vkc_stream_slot_create(stream, &stream->slots[i])) {
+            vkc_stream_free(stream);
+            return NULL;
+        }
+    }
+
+#if defined(VKC_DEBUG) && (1 == VKC_DEBUG)
+    LOG_DEBUG(
+        "[VkcStream] Created stream: depth=%u, chunk=%llu bytes, output=%llu bytes.",
+        depth,
+        (unsigned long long) stream->info.chunk_size,
+        (unsigned long long) info->output_size
+    );
+#endif
+
+    return stream;
+}
+
+void vkc_stream_free(VkcStream* stream) {
+    if (!stream) {
+        return;
+    }
+
+    VkcMemoryPool* pool = stream->pool;
+
+    for (uint32_t i = 0; i < stream->info.depth; i++) {
+        VkcStreamSlot* slot = &stream->slots[i];
+        if (slot->busy && stream->info.transfer) {
+            vkc_queue_wait(stream->info.transfer->queue, slot->copied, UINT64_MAX);
+        } else if (slot->busy) {
+            vkWaitForFences(pool->device, 1, &slot->fence, VK_TRUE, UINT64_MAX);
+        }
+        if (VK_NULL_HANDLE != slot->fence) {
+            vkDestroyFence(pool->device, slot->fence, pool->callbacks);
+        }
+        vkc_buffer_free(slot->input);
+        vkc_buffer_free(slot->output);
+    }
+
+    // Command buffers and descriptor sets go with their pools.
+    if (VK_NULL_HANDLE != stream->descriptor_pool) {
+        vkDestroyDescriptorPool(pool->device, stream->descriptor_pool, pool->callbacks);
+    }
+    if (VK_NULL_HANDLE != stream->command_pool) {
+        vkDestroyCommandPool(pool->device, stream->command_pool, pool->callbacks);
+    }
+
+    vkc_readback_free(stream->readback);
+    vkc_staging_ring_free(stream->ring);
+    page_free(pool->pager, stream);
+}
+
+bool vkc_stream_run(
+    VkcStream* stream,
+    VkDeviceSize size,
+    VkcStreamRead read,
+    VkcStreamCombine combine,
+    void* user
+) {
+    if (!stream || !read || !combine || 0 == size || 0 != size % 4) {
+        LOG_ERROR("[VkcStream] Invalid run arguments.");
+        return false;
+    }
+
+    const VkDeviceSize chunk_size = stream->info.chunk_size;
+    const uint32_t depth = stream->info.depth;
+    const uint64_t chunks = (size + chunk_size - 1) / chunk_size;
+
+    bool ok = true;
+    uint64_t chunk = 0;
+    for (; ok && chunk < chunks; chunk++) {
+        VkcStreamSlot* slot = &stream->slots[chunk % depth];
+        if (slot->busy) {
+            ok = vkc_stream_finish(stream, slot, combine, user);
+        }
+
+        VkDeviceSize offset = chunk * chunk_size;
+        VkDeviceSize bytes = size - offset < chunk_size ? size - offset : chunk_size;
+        if (ok && stream->info.transfer) {
+            ok = vkc_stream_submit_transfer(stream, slot, chunk, offset, bytes, read, user);
+        } else if (ok) {
+            ok = vkc_stream_submit(stream, slot, chunk, offset, bytes, read, user);
+        }
+    }
+
+    // Drain in chunk order; after a failure only wait, so nothing is left in flight.
+    for (uint64_t i = chunk > depth ? chunk - depth : 0; i < chunk; i++) {
+        VkcStreamSlot* slot = &stream->slots[i % depth];
+        if (slot->busy) {
+            ok = vkc_stream_finish(stream, slot, ok ? combine : NULL, user) && ok;
+        }
+    }
+
+#if defined(VKC_DEBUG) && (1 == VKC_DEBUG)
+    LOG_DEBUG(
+        "[VkcStream] %s %llu chunks over %llu bytes.",
+        ok ? "Ran" : "Aborted after",
+        (unsigned long long) chunk,
+        (unsigned long long) size
+    );
+#endif
+
+    return ok;
+}
+
+/** @} */
@@ -0,0 +1,82 @@
+/**
+ * @file src/vk/sync.c
+ * @brief Retirement points for GPU work.
+ */
+
+#include "core/logger.h"
+#include "vk/sync.h"
+
+/**
+ * @name Public
+ * {@
+ */
+
+bool vkc_sync_point_poll(VkDevice device, const VkcSyncPoint* point) {
+    if (!point) {
+        return true;
+    }
+
+    if (VK_NULL_HANDLE != point->semaphore) {
+        uint64_t value = 0;
+        VkResult result = vkGetSemaphoreCounterValue(device, point->semaphore, &value);
+        if (VK_SUCCESS != result) {
+            LOG_ERROR("[VkcSyncPoint] Failed to read timeline value (VkResult=%d).", result);
+            return false;
+        }
+        return value >= point->value;
+    }
+
+    if (VK_NULL_HANDLE != point->fence) {
+        return VK_SUCCESS == vkGetFenceStatus(device, point->fence);
+    }
+
+    return true;
+}
+
+bool vkc_sync_point_wait(VkDevice device, const VkcSyncPoint* point, uint64_t timeout) {
+    if (!point) {
+        return true;
+    }
+
+    VkResult result = VK_SUCCESS;
+    if (VK_NULL_HANDLE != point->semaphore) {
+        VkSemaphoreWaitInfo info = {
+            .sType = VK_STRUCTURE_TYPE_SEMAPHORE_WAIT_INFO,
+            .semaphoreCount = 1,
+            .pSemaphores = &point->semaphore,
+            .pValues = &point->value,
+        };
+        result = vkWaitSemaphores(device, &info, timeout);
+    } else if (VK_NULL_HANDLE != point->fence) {
+        result = vkWaitForFences(device, 1, &point->fence, VK_TRUE, timeout);
+    }
+
+    if (VK_SUCCESS != result && VK_TIMEOUT != result) {
+        LOG_ERROR("[VkcSyncPoint] Failed to wait (VkResult=%d).", result);
+    }
+
+    return VK_SUCCESS == result;
+}
+
+void vkc_sync_compute_barrier(VkCommandBuffer command) {
+    VkMemoryBarrier barrier = {
+        .sType = VK_STRUCTURE_TYPE_MEMORY_BARRIER,
+        .srcAccessMask = VK_ACCESS_SHADER_WRITE_BIT,
+        .dstAccessMask = VK_ACCESS_MEMORY_READ_BIT | VK_ACCESS_MEMORY_WRITE_BIT
+                         | VK_ACCESS_HOST_READ_BIT,
+    };
+    vkCmdPipelineBarrier(
+        command,
+        VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
+        VK_PIPELINE_STAGE_ALL_COMMANDS_BIT | VK_PIPELINE_STAGE_HOST_BIT,
+        0,
+        1,
+        &barrier,
+        0,
+        NULL,
+        0,
+        NULL
+    );
+}
+
+/** @} */
@@ -0,0 +1,166 @@
+/**
+ * @file src/vk/trace.c
+ * @brief Binary allocation trace capture for the Vulkan host allocator.
+ */
+
+#include "core/posix.h"
+#include "core/memory.h"
+#include "core/logger.h"
+#include "allocator/page.h"
+#include "vk/trace.h"
+
+#include <time.h>
+
+/**
+ * @section Private
+ * {@
+ */
+
+static atomic_uint vkc_trace_threads = 0;
+static _Thread_local uint32_t vkc_trace_thread_id = 0;
+
+static uint64_t vkc_trace_now(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t) ts.tv_sec * 1000000000ull + (uint64_t) ts.tv_nsec;
+}
+
+static uint32_t vkc_trace_thread(void) {
+    // Ids start at 1 so that 0 marks a thread that has not been seen yet.
+    if (0 == vkc_trace_thread_id) {
+        vkc_trace_thread_id = atomic_fetch_add_explicit(&vkc_trace_threads, 1, memory_order_relaxed)
+                              + 1;
+    }
+    return vkc_trace_thread_id;
+}
+
+/** @} */
+
+/**
+ * @name Public
+ * {@
+ */
+
+VkcTrace* vkc_trace_create(PageAllocator* pager) {
+    if (!pager) {
+        LOG_ERROR("[VkcTrace] Missing allocation context (PageAllocator).");
+        return NULL;
+    }
+
+    VkcTrace* trace = page_malloc(pager, sizeof(*trace), alignof(*trace));
+    if (!trace) {
+        LOG_ERROR("[VkcTrace] Failed to allocate trace writer.");
+        return NULL;
+    }
+
+    trace->file = NULL;
+    trace->start = 0;
+    atomic_init(&trace->active, false);
+
+    if (0 != pthread_mutex_init(&trace->mutex, NULL)) {
+        LOG_ERROR("[VkcTrace] Failed to initialize trace mutex.");
+        page_free(pager, trace);
+        return NULL;
+    }
+
+    return trace;
+}
+
+void vkc_trace_free(VkcTrace* trace, PageAllocator* pager) {
+    if (!trace) {
+        return;
+    }
+
+    vkc_trace_close(trace);
+    pthread_mutex_destroy(&trace->mutex);
+    page_free(pager, trace);
+}
+
+bool vkc_trace_open(VkcTrace* trace, const char* path) {
+    if (!trace || !path) {
+        LOG_ERROR("[VkcTrace] Invalid trace arguments.");
+        return false;
+    }
+
+    pthread_mutex_lock(&trace->mutex);
+
+    if (trace->file) {
+        LOG_ERROR("[VkcTrace] A trace is already being recorded.");
+        pthread_mutex_unlock(&trace->mutex);
+        return false;
+    }
+
+    FILE* file = fopen(path, "wb");
+    if (!file) {
+        LOG_ERROR("[VkcTrace] Failed to open '%s' for writing.", path);
+        pthread_mutex_unlock(&trace->mutex);
+        return false;
+    }
+
+    VkcTraceHeader header = {
+        .version = VKC_TRACE_VERSION,
+        .record_size = sizeof(VkcTraceRecord),
+    };
+    memcpy(header.magic, VKC_TRACE_MAGIC, sizeof(header.magic));
+
+    if (1 != fwrite(&header, sizeof(header), 1, file)) {
+        LOG_ERROR("[VkcTrace] Failed to write trace header to '%s'.", path);
+        fclose(file);
+        pthread_mutex_unlock(&trace->mutex);
+        return false;
+    }
+
+    trace->file = file;
+    trace->start = vkc_trace_now();
+    atomic_store_explicit(&trace->active, true, memory_order_release);
+
+    pthread_mutex_unlock(&trace->mutex);
+
+#if defined(VKC_DEBUG) && (1 == VKC_DEBUG)
+    LOG_DEBUG("[VkcTrace] Recording allocations to '%s'.", path);
+#endif
+
+    return true;
+}
+
+void vkc_trace_close(VkcTrace* trace) {
+    if (!trace) {
+        return;
+    }
+
+    pthread_mutex_lock(&trace->mutex);
+
+    atomic_store_explicit(&trace->active, false, memory_order_release);
+    if (trace->file) {
+        if (0 != fclose(trace->file)) {
+            LOG_ERROR("[VkcTrace] Failed to flush trace file.");
+        }
+        trace->file = NULL;
+    }
+
+    pthread_mutex_unlock(&trace->mutex);
+}
+
+bool vkc_trace_lock(VkcTrace* trace) {
+    pthread_mutex_lock(&trace->mutex);
+    return NULL != trace->file;
+}
+
+void vkc_trace_unlock(VkcTrace* trace) {
+    pthread_mutex_unlock(&trace->mutex);
+}
+
+void vkc_trace_write(VkcTrace* trace, VkcTraceRecord record) {
+    record.timestamp = vkc_trace_now() - trace->start;
+    record.thread = vkc_trace_thread();
+
+    if (1 != fwrite(&record, sizeof(record), 1, trace->file)) {
+        // Stop recording rather than leave a trace with holes in it.
+        LOG_ERROR("[VkcTrace] Failed to write trace record; recording stopped.");
+        atomic_store_explicit(&trace->active, false, memory_order_relaxed);
+        fclose(trace->file);
+        trace->file = NULL;
+    }
+}
+
+/** @} */
@@ -0,0 +1,269 @@
+/**
+ * @file src/vk/transfer.c
+ * @brief Copies on a dedicated transfer queue, handed to and from compute.
+ */
+
+#include "core/posix.h"
+#include "core/memory.h"
+#include "core/logger.h"
+#include "allocator/page.h"
+#include "vk/queue.h"
+#include "vk/transfer.h"
+
+/**
+ * @section Private
+ * {@
+ */
+
+static void vkc_transfer_barrier(
+    VkCommandBuffer command,
+    VkBuffer buffer,
+    uint32_t src_family,
+    uint32_t dst_family,
+    VkPipelineStageFlags src_stage,
+    VkAccessFlags src_access,
+    VkPipelineStageFlags dst_stage,
+    VkAccessFlags dst_access
+) {
+    VkBufferMemoryBarrier barrier = {
+        .sType = VK_STRUCTURE_TYPE_BUFFER_MEMORY_BARRIER,
+        .srcAccessMask = src_access,
+        .dstAccessMask = dst_access,
+        .srcQueueFamilyIndex = src_family,
+        .dstQueueFamilyIndex = dst_family,
+        .buffer = buffer,
+        .offset = 0,
+        .size = VK_WHOLE_SIZE,
+    };
+
+    vkCmdPipelineBarrier(command, src_stage, dst_stage, 0, 0, NULL, 1, &barrier, 0, NULL);
+}
+
+// Families in the order the buffer moves between them.
+static void vkc_transfer_families(
+    const VkcTransfer* transfer, VkcTransferDirection direction, uint32_t* src, uint32_t* dst
+) {
+    bool to_compute = VKC_TRANSFER_TO_COMPUTE == direction;
+    *src = to_compute ? transfer->queue->family : transfer->compute->family;
+    *dst = to_compute ? transfer->compute->family : transfer->queue->family;
+}
+
+/** @} */
+
+/**
+ * @name Public
+ * {@
+ */
+
+VkcTransfer* vkc_transfer_create(VkcQueue* transfer, VkcQueue* compute, uint32_t depth) {
+    if (!compute || 0 == depth || depth > VKC_TRANSFER_DEPTH_MAX
+        || (transfer && transfer->device != compute->device)) {
+        LOG_ERROR("[VkcTransfer] Invalid transfer arguments.");
+        return NULL;
+    }
+
+    VkcTransfer* self = page_malloc(compute->pager, sizeof(*self), alignof(*self));
+    if (!self) {
+        LOG_ERROR("[VkcTransfer] Failed to allocate transfer structure.");
+        return NULL;
+    }
+
+    VkcQueue* queue = transfer ? transfer : compute;
+    *self = (VkcTransfer) {
+        .queue = queue,
+        .compute = compute,
+        .dedicated = queue->family != compute->family,
+        .command_pool = VK_NULL_HANDLE,
+        .depth = depth,
+    };
+
+    VkCommandPoolCreateInfo command_pool_info = {
+        .sType = VK_STRUCTURE_TYPE_COMMAND_POOL_CREATE_INFO,
+        .flags = VK_COMMAND_POOL_CREATE_TRANSIENT_BIT
+                 | VK_COMMAND_POOL_CREATE_RESET_COMMAND_BUFFER_BIT,
+        .queueFamilyIndex = queue->family,
+    };
+    VkResult result = vkCreateCommandPool(
+        compute->device, &command_pool_info, compute->callbacks, &self->command_pool
+    );
+    if (VK_SUCCESS != result) {
+        LOG_ERROR("[VkcTransfer] Failed to create command pool (VkResult=%d).", result);
+        vkc_transfer_free(self);
+        return NULL;
+    }
+
+    VkCommandBufferAllocateInfo command_info = {
+        .sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO,
+        .commandPool = self->command_pool,
+        .level = VK_COMMAND_BUFFER_LEVEL_PRIMARY,
+        .commandBufferCount = depth,
+    };
+    result = vkAllocateCommandBuffers(compute->device, &command_info, self->commands);
+    if (VK_SUCCESS != result) {
+        LOG_ERROR("[VkcTransfer] Failed to allocate command buffers (VkResult=%d).", result);
+        vkc_transfer_free(self);
+        return NULL;
+    }
+
+#if defined(VKC_DEBUG) && (1 == VKC_DEBUG)
+    LOG_DEBUG(
+        "[VkcTransfer] Copies on family %u, compute on family %u%s.",
+        queue->family,
+        compute->family,
+        self->dedicated ? "" : " (shared queue)"
+    );
+#endif
+
+    return self;
+}
+
+void vkc_transfer_free(VkcTransfer* transfer) {
+    if (!transfer) {
+        return;
+    }
+
+    VkcQueue* compute = transfer->compute;
+
+    for (uint32_t i = 0; i < transfer->depth; i++) {
+        vkc_queue_wait(transfer->queue, transfer->tickets[i], UINT64_MAX);
+    }
+
+    // Command buffers go with their pool.
+    if (VK_NULL_HANDLE != transfer->command_pool) {
+        vkDestroyCommandPool(compute->device, transfer->command_pool, compute->callbacks);
+    }
+
+#if defined(VKC_DEBUG) && (1 == VKC_DEBUG)
+    LOG_DEBUG(
+        "[VkcTransfer] Submitted %llu copy batches.", (unsigned long long) transfer->submissions
+    );
+#endif
+
+    page_free(compute->pager, transfer);
+}
+
+VkCommandBuffer vkc_transfer_begin(VkcTransfer* transfer) {
+    if (!transfer || transfer->recording) {
+        LOG_ERROR("[VkcTransfer] Invalid begin; a copy buffer is already open.");
+        return VK_NULL_HANDLE;
+    }
+
+    uint32_t index = transfer->next;
+    if (!vkc_queue_wait(transfer->queue, transfer->tickets[index], UINT64_MAX)) {
+        LOG_ERROR("[VkcTransfer] Failed to retire copy buffer %u.", index);
+        return VK_NULL_HANDLE;
+    }
+
+    // The pool allows individual resets, so beginning resets the buffer.
+    VkCommandBufferBeginInfo begin = {
+        .sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO,
+        .flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT,
+    };
+    VkResult result = vkBeginCommandBuffer(transfer->commands[index], &begin);
+    if (VK_SUCCESS != result) {
+        LOG_ERROR("[VkcTransfer] Failed to begin recording (VkResult=%d).", result);
+        return VK_NULL_HANDLE;
+    }
+
+    transfer->recording = true;
+    return transfer->commands[index];
+}
+
+void vkc_transfer_cancel(VkcTransfer* transfer) {
+    if (!transfer || !transfer->recording) {
+        return;
+    }
+
+    // Ending is enough; the next begin resets the buffer.
+    vkEndCommandBuffer(transfer->commands[transfer->next]);
+    transfer->recording = false;
+}
+
+uint64_t vkc_transfer_submit(VkcTransfer* transfer, const VkcQueueSubmit* deps) {
+    if (!transfer || !transfer->recording) {
+        LOG_ERROR("[VkcTransfer] Invalid submit; no copy buffer is open.");
+        return 0;
+    }
+
+    uint32_t index = transfer->next;
+    transfer->recording = false;
+
+    VkResult result = vkEndCommandBuffer(transfer->commands[index]);
+    if (VK_SUCCESS != result) {
+        LOG_ERROR("[VkcTransfer] Failed to end recording (VkResult=%d).", result);
+        return 0;
+    }
+
+    VkcQueueSubmit submit = deps ? *deps : (VkcQueueSubmit) {0};
+    submit.commands = &transfer->commands[index];
+    submit.command_count = 1;
+
+    uint64_t ticket = vkc_queue_submit(transfer->queue, &submit);
+    if (0 == ticket) {
+        return 0;
+    }
+
+    transfer->tickets[index] = ticket;
+    transfer->next = (index + 1) % transfer->depth;
+    transfer->submissions++;
+    return ticket;
+}
+
+void vkc_transfer_release(
+    const VkcTransfer* transfer,
+    VkCommandBuffer command,
+    VkcTransferDirection direction,
+    VkBuffer buffer,
+    VkPipelineStageFlags stage,
+    VkAccessFlags access
+) {
+    // On a shared queue the acquire alone orders the two uses.
+    if (!transfer || !transfer->dedicated) {
+        return;
+    }
+
+    uint32_t src = 0;
+    uint32_t dst = 0;
+    vkc_transfer_families(transfer, direction, &src, &dst);
+
+    // The destination half of a release is ignored; the semaphore orders the acquire.
+    vkc_transfer_barrier(
+        command, buffer, src, dst, stage, access, VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT, 0
+    );
+}
+
+void vkc_transfer_acquire(
+    const VkcTransfer* transfer,
+    VkCommandBuffer command,
+    VkcTransferDirection direction,
+    VkBuffer buffer,
+    VkPipelineStageFlags stage,
+    VkAccessFlags access
+) {
+    if (!transfer) {
+        return;
+    }
+
+    if (!transfer->dedicated) {
+        vkc_transfer_barrier(
+            command,
+            buffer,
+            VK_QUEUE_FAMILY_IGNORED,
+            VK_QUEUE_FAMILY_IGNORED,
+            VK_PIPELINE_STAGE_ALL_COMMANDS_BIT,
+            VK_ACCESS_MEMORY_WRITE_BIT,
+            stage,
+            access
+        );
+        return;
+    }
+
+    uint32_t src = 0;
+    uint32_t dst = 0;
+    vkc_transfer_families(transfer, direction, &src, &dst);
+
+    // Sourcing the stages the semaphore wait blocks chains the acquire after it.
+    vkc_transfer_barrier(command, buffer, src, dst, stage, 0, stage, access);
+}
+
+/** @} */
@@ -0,0 +1,506 @@
+/**
+ * @file src/vk/workers.c
+ * @brief Work-stealing host threads for parallel command recording.
+ */
+
+#include "core/posix.h"
+#include "core/memory.h"
+#include "core/logger.h"
+#include "allocator/page.h"
+#include "vk/queue.h"
+#include "vk/workers.h"
+
+#include <unistd.h>
+
+/**
+ * @section Private
+ * {@
+ */
+
+#define VKC_WORKERS_DEQUE_SIZE 256
+#define VKC_WORKERS_COMMAND_GROWTH 16
+
+typedef struct VkcWorkersRecording {
+    VkcWorkerRecord record;
+    void* user;
+    VkCommandBuffer* commands;
+    atomic_bool failed;
+} VkcWorkersRecording;
+
+static void vkc_workers_wake(VkcWorkers* self, bool all) {
+    pthread_mutex_lock(&self->mutex);
+    if (all) {
+        pthread_cond_broadcast(&self->work);
+    } else {
+        pthread_cond_signal(&self->work);
+    }
+    pthread_mutex_unlock(&self->mutex);
+}
+
+static void vkc_workers_finish(VkcWorkers* self) {
+    if (1 == atomic_fetch_sub_explicit(&self->pending, 1, memory_order_acq_rel)) {
+        pthread_mutex_lock(&self->mutex);
+        pthread_cond_broadcast(&self->done);
+        pthread_mutex_unlock(&self->mutex);
+    }
+}
+
+// Append to the back of a worker's deque, doubling it when full.
+static bool vkc_workers_push(VkcWorker* worker, const VkcWorkerJob* job) {
+    VkcWorkers* self = worker->workers;
+
+    // Counted first, so a worker never finishes a task nobody counted.
+    atomic_fetch_add_explicit(&self->pending, 1, memory_order_relaxed);
+
+    pthread_mutex_lock(&worker->mutex);
+    if (worker->tail - worker->head == worker->capacity) {
+        uint32_t capacity = worker->capacity * 2;
+        VkcWorkerJob* jobs = page_malloc(
+            self->pager, capacity * sizeof(*jobs), alignof(VkcWorkerJob)
+        );
+        if (!jobs) {
+            pthread_mutex_unlock(&worker->mutex);
+            LOG_ERROR("[VkcWorkers] Failed to grow deque to %u tasks.", capacity);
+            vkc_workers_finish(self);
+            return false;
+        }
+
+        for (uint64_t i = worker->head; i < worker->tail; i++) {
+            jobs[i & (capacity - 1)] = worker->jobs[i & (worker->capacity - 1)];
+        }
+
+        page_free(self->pager, worker->jobs);
+        worker->jobs = jobs;
+        worker->capacity = capacity;
+    }
+
+    // queued changes only under a deque lock, so a nonzero count always means a
+    // task sits in some deque and idle workers never spin on one in transit.
+    worker->jobs[worker->tail & (worker->capacity - 1)] = *job;
+    worker->tail++;
+    atomic_fetch_add_explicit(&self->queued, 1, memory_order_release);
+    pthread_mutex_unlock(&worker->mutex);
+    return true;
+}
+
+// Pop the newest task of the worker's own deque, else steal the oldest of another's.
+static bool vkc_workers_take(VkcWorker* worker, VkcWorkerJob* job) {
+    VkcWorkers* self = worker->workers;
+
+    pthread_mutex_lock(&worker->mutex);
+    if (worker->tail > worker->head) {
+        worker->tail--;
+        *job = worker->jobs[worker->tail & (worker->capacity - 1)];
+        atomic_fetch_sub_explicit(&self->queued, 1, memory_order_relaxed);
+        pthread_mutex_unlock(&worker->mutex);
+        return true;
+    }
+    pthread_mutex_unlock(&worker->mutex);
+
+    for (uint32_t k = 1; k < self->count; k++) {
+        VkcWorker* victim = &self->workers[(worker->index + k) % self->count];
+
+        pthread_mutex_lock(&victim->mutex);
+        if (victim->tail > victim->head) {
+            *job = victim->jobs[victim->head & (victim->capacity - 1)];
+            victim->head++;
+            atomic_fetch_sub_explicit(&self->queued, 1, memory_order_relaxed);
+            pthread_mutex_unlock(&victim->mutex);
+            worker->stolen++;
+            return true;
+        }
+        pthread_mutex_unlock(&victim->mutex);
+    }
+
+    return false;
+}
+
+static void* vkc_workers_thread(void* arg) {
+    VkcWorker* worker = (VkcWorker*) arg;
+    VkcWorkers* self = worker->workers;
+
+    for (;;) {
+        VkcWorkerJob job;
+        if (vkc_workers_take(worker, &job)) {
+            job.task(worker, job.index, job.user);
+            worker->executed++;
+            vkc_workers_finish(self);
+            continue;
+        }
+
+        // Posters count a task before waking, so checking under the mutex loses no wakeup.
+        pthread_mutex_lock(&self->mutex);
+        while (self->running && 0 == atomic_load_explicit(&self->queued, memory_order_acquire)) {
+            pthread_cond_wait(&self->work, &self->mutex);
+        }
+        bool stop = !self->running && 0 == atomic_load(&self->queued);
+        pthread_mutex_unlock(&self->mutex);
+
+        if (stop) {
+            break;
+        }
+    }
+
+    return NULL;
+}
+
+// Set up the deque and command pool; count covers the worker once its mutex exists.
+static bool vkc_workers_init(VkcWorkers* self, VkcWorker* worker, uint32_t index) {
+    VkcQueue* queue = self->queue;
+
+    worker->workers = self;
+    worker->index = index;
+    worker->capacity = VKC_WORKERS_DEQUE_SIZE;
+
+    if (0 != pthread_mutex_init(&worker->mutex, NULL)) {
+        LOG_ERROR("[VkcWorkers] Failed to initialize mutex of worker %u.", index);
+        return false;
+    }
+    self->count = index + 1;
+
+    worker->jobs = page_malloc(
+        self->pager, worker->capacity * sizeof(*worker->jobs), alignof(VkcWorkerJob)
+    );
+    if (!worker->jobs) {
+        LOG_ERROR("[VkcWorkers] Failed to allocate deque of worker %u.", index);
+        return false;
+    }
+
+    // Command pools are externally synchronized, hence one per thread.
+    VkCommandPoolCreateInfo command_pool_info = {
+        .sType = VK_STRUCTURE_TYPE_COMMAND_POOL_CREATE_INFO,
+        .flags = VK_COMMAND_POOL_CREATE_TRANSIENT_BIT,
+        .queueFamilyIndex = queue->family,
+    };
+    VkResult result = vkCreateCommandPool(
+        queue->device, &command_pool_info, queue->callbacks, &worker->command_pool
+    );
+    if (VK_SUCCESS != result) {
+        LOG_ERROR("[VkcWorkers] Failed to create command pool (VkResult=%d).", result);
+        return false;
+    }
+
+    return true;
+}
+
+static void vkc_workers_record_task(VkcWorker* worker, uint32_t index, void* user) {
+    VkcWorkersRecording* recording = (VkcWorkersRecording*) user;
+
+    VkCommandBuffer command = vkc_worker_command(worker);
+    if (VK_NULL_HANDLE == command) {
+        atomic_store(&recording->failed, true);
+        return;
+    }
+
+    VkCommandBufferBeginInfo begin = {
+        .sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO,
+        .flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT,
+    };
+    VkResult result = vkBeginCommandBuffer(command, &begin);
+    if (VK_SUCCESS != result) {
+        LOG_ERROR("[VkcWorkers] Failed to begin command %u (VkResult=%d).", index, result);
+        atomic_store(&recording->failed, true);
+        return;
+    }
+
+    bool recorded = recording->record(command, index, recording->user);
+    result = vkEndCommandBuffer(command);
+    if (!recorded || VK_SUCCESS != result) {
+        LOG_ERROR("[VkcWorkers] Failed to record command %u (VkResult=%d).", index, result);
+        atomic_store(&recording->failed, true);
+        return;
+    }
+
+    recording->commands[index] = command;
+}
+
+/** @} */
+
+/**
+ * @name Public
+ * {@
+ */
+
+VkcWorkers* vkc_workers_create(VkcQueue* queue, uint32_t count) {
+    if (!queue) {
+        LOG_ERROR("[VkcWorkers] Invalid workers arguments.");
+        return NULL;
+    }
+
+    if (VKC_WORKERS_AUTO == count) {
+        long online = sysconf(_SC_NPROCESSORS_ONLN);
+        count = online > 0 ? (uint32_t) online : 1;
+    }
+    if (count > VKC_WORKERS_MAX) {
+        count = VKC_WORKERS_MAX;
+    }
+
+    VkcWorkers* self = page_malloc(queue->pager, sizeof(*self), alignof(*self));
+    if (!self) {
+        LOG_ERROR("[VkcWorkers] Failed to allocate workers structure.");
+        return NULL;
+    }
+
+    *self = (VkcWorkers) {
+        .pager = queue->pager,
+        .queue = queue,
+        .count = 0,
+        .running = true,
+    };
+    atomic_init(&self->cursor, 0);
+    atomic_init(&self->queued, 0);
+    atomic_init(&self->pending, 0);
+
+    bool ok = 0 == pthread_mutex_init(&self->mutex, NULL);
+    if (ok && 0 != pthread_cond_init(&self->work, NULL)) {
+        pthread_mutex_destroy(&self->mutex);
+        ok = false;
+    }
+    if (ok && 0 != pthread_cond_init(&self->done, NULL)) {
+        pthread_cond_destroy(&self->work);
+        pthread_mutex_destroy(&self->mutex);
+        ok = false;
+    }
+    if (!ok) {
+        LOG_ERROR("[VkcWorkers] Failed to initialize synchronization.");
+        page_free(queue->pager, self);
+        return NULL;
+    }
+
+    for (uint32_t i = 0; i < count; i++) {
+        if (!vkc_workers_init(self, &self->workers[i], i)) {
+            vkc_workers_free(self);
+            return NULL;
+        }
+    }
+
+    // Threads start only once every deque exists, since thieves scan them all.
+    for (uint32_t i = 0; i < count; i++) {
+        VkcWorker* worker = &self->workers[i];
+        if (0 != pthread_create(&worker->thread, NULL, vkc_workers_thread, worker)) {
+            LOG_ERROR("[VkcWorkers] Failed to start worker %u.", i);
+            vkc_workers_free(self);
+            return NULL;
+        }
+        worker->started = true;
+    }
+
+#if defined(VKC_DEBUG) && (1 == VKC_DEBUG)
+    LOG_DEBUG("[VkcWorkers] Started %u workers on family %u.", count, queue->family);
+#endif
+
+    return self;
+}
+
+void vkc_workers_free(VkcWorkers* workers) {
+    if (!workers) {
+        return;
+    }
+
+    VkcQueue* queue = workers->queue;
+
+    pthread_mutex_lock(&workers->mutex);
+    workers->running = false;
+    pthread_cond_broadcast(&workers->work);
+    pthread_mutex_unlock(&workers->mutex);
+
+    // Threads drain the deques before they stop.
+    for (uint32_t i = 0; i < workers->count; i++) {
+        if (workers->workers[i].started) {
+            pthread_join(workers->workers[i].thread, NULL);
+        }
+    }
+
+    uint64_t executed = 0;
+    uint64_t stolen = 0;
+    for (uint32_t i = 0; i < workers->count; i++) {
+        VkcWorker* worker = &workers->workers[i];
+        executed += worker->executed;
+        stolen += worker->stolen;
+
+        // Command buffers go with their pool.
+        if (VK_NULL_HANDLE != worker->command_pool) {
+            vkDestroyCommandPool(queue->device, worker->command_pool, queue->callbacks);
+        }
+        if (worker->commands) {
+            page_free(workers->pager, worker->commands);
+        }
+        if (worker->jobs) {
+            page_free(workers->pager, worker->jobs);
+        }
+        pthread_mutex_destroy(&worker->mutex);
+    }
+
+#if defined(VKC_DEBUG) && (1 == VKC_DEBUG)
+    LOG_DEBUG(
+        "[VkcWorkers] Ran %llu tasks, %llu stolen.",
+        (unsigned long long) executed,
+        (unsigned long long) stolen
+    );
+#else
+    (void) executed;
+    (void) stolen;
+#endif
+
+    pthread_cond_destroy(&workers->done);
+    pthread_cond_destroy(&workers->work);
+    pthread_mutex_destroy(&workers->mutex);
+    page_free(workers->pager, workers);
+}
+
+bool vkc_workers_post(VkcWorkers* workers, VkcWorkerTask task, uint32_t index, void* user) {
+    if (!workers || !task) {
+        LOG_ERROR("[VkcWorkers] Invalid post arguments.");
+        return false;
+    }
+
+    uint32_t next = atomic_fetch_add_explicit(&workers->cursor, 1, memory_order_relaxed);
+    VkcWorker* worker = &workers->workers[next % workers->count];
+
+    VkcWorkerJob job = {.task = task, .user = user, .index = index};
+    if (!vkc_workers_push(worker, &job)) {
+        return false;
+    }
+
+    vkc_workers_wake(workers, false);
+    return true;
+}
+
+bool vkc_worker_post(VkcWorker* worker, VkcWorkerTask task, uint32_t index, void* user) {
+    if (!worker || !task) {
+        LOG_ERROR("[VkcWorkers] Invalid post arguments.");
+        return false;
+    }
+
+    VkcWorkerJob job = {.task = task, .user = user, .index = index};
+    if (!vkc_workers_push(worker, &job)) {
+        return false;
+    }
+
+    // The poster picks it up itself unless an idle worker steals it first.
+    vkc_workers_wake(worker->workers, false);
+    return true;
+}
+
+void vkc_workers_wait(VkcWorkers* workers) {
+    if (!workers) {
+        return;
+    }
+
+    pthread_mutex_lock(&workers->mutex);
+    while (0 != atomic_load_explicit(&workers->pending, memory_order_acquire)) {
+        pthread_cond_wait(&workers->done, &workers->mutex);
+    }
+    pthread_mutex_unlock(&workers->mutex);
+}
+
+bool vkc_workers_for(VkcWorkers* workers, uint32_t count, VkcWorkerTask task, void* user) {
+    if (!workers || !task) {
+        LOG_ERROR("[VkcWorkers] Invalid for arguments.");
+        return false;
+    }
+
+    // Contiguous blocks keep neighbouring indices on one thread until stolen.
+    bool ok = true;
+    for (uint32_t i = 0; ok && i < count; i++) {
+        VkcWorker* worker = &workers->workers[(uint64_t) i * workers->count / count];
+        VkcWorkerJob job = {.task = task, .user = user, .index = i};
+        ok = vkc_workers_push(worker, &job);
+    }
+
+    vkc_workers_wake(workers, true);
+    vkc_workers_wait(workers);
+    return ok;
+}
+
+VkCommandBuffer vkc_worker_command(VkcWorker* worker) {
+    if (!worker) {
+        return VK_NULL_HANDLE;
+    }
+
+    VkcWorkers* self = worker->workers;
+    VkcQueue* queue = self->queue;
+
+    if (worker->command_used == worker->command_count) {
+        uint32_t count = worker->command_count + VKC_WORKERS_COMMAND_GROWTH;
+        VkCommandBuffer* commands = worker->commands
+            ? page_realloc(
+                  self->pager, worker->commands, count * sizeof(*commands), alignof(VkCommandBuffer)
+              )
+            : page_malloc(self->pager, count * sizeof(*commands), alignof(VkCommandBuffer));
+        if (!commands) {
+            LOG_ERROR("[VkcWorkers] Failed to grow command array to %u entries.", count);
+            return VK_NULL_HANDLE;
+        }
+        worker->commands = commands;
+
+        VkCommandBufferAllocateInfo command_info = {
+            .sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO,
+            .commandPool = worker->command_pool,
+            .level = VK_COMMAND_BUFFER_LEVEL_PRIMARY,
+            .commandBufferCount = VKC_WORKERS_COMMAND_GROWTH,
+        };
+        VkResult result = vkAllocateCommandBuffers(
+            queue->device, &command_info, &commands[worker->command_count]
+        );
+        if (VK_SUCCESS != result) {
+            LOG_ERROR("[VkcWorkers] Failed to allocate command buffers (VkResult=%d).", result);
+            return VK_NULL_HANDLE;
+        }
+        worker->command_count = count;
+    }
+
+    return worker->commands[worker->command_used++];
+}
+
+bool vkc_workers_record(
+    VkcWorkers* workers,
+    uint32_t count,
+    VkcWorkerRecord record,
+    void* user,
+    VkCommandBuffer* commands
+) {
+    if (!workers || !record || (count && !commands)) {
+        LOG_ERROR("[VkcWorkers] Invalid record arguments.");
+        return false;
+    }
+
+    VkcWorkersRecording recording = {
+        .record = record,
+        .user = user,
+        .commands = commands,
+    };
+    atomic_init(&recording.failed, false);
+
+    bool ok = vkc_workers_for(workers, count, vkc_workers_record_task, &recording);
+    return ok && !atomic_load(&recording.failed);
+}
+
+bool vkc_workers_reset(VkcWorkers* workers) {
+    if (!workers) {
+        return false;
+    }
+
+    VkcQueue* queue = workers->queue;
+
+    bool ok = true;
+    for (uint32_t i = 0; i < workers->count; i++) {
+        VkcWorker* worker = &workers->workers[i];
+        if (0 == worker->command_used) {
+            continue;
+        }
+
+        // One reset per pool instead of one per buffer.
+        VkResult result = vkResetCommandPool(queue->device, worker->command_pool, 0);
+        if (VK_SUCCESS != result) {
+            LOG_ERROR("[VkcWorkers] Failed to reset command pool %u (VkResult=%d).", i, result);
+            ok = false;
+            continue;
+        }
+        worker->command_used = 0;
+    }
+
+    return ok;
+}
+
+/** @} */